@@ -22,6 +22,7 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 #include <zmk/events/layer_state_changed.h>
 #include <zmk/events/split_wpm_state_changed.h>
 #include <zmk/events/split_peripheral_rssi_changed.h>  // ← THÊM
+#include <zmk/split/central.h>
 #include <zmk/usb.h>
 #include <zmk/ble.h>
 #include <zmk/endpoints.h>
@@ -405,6 +406,9 @@ int zmk_widget_status_init(struct zmk_widget_status *widget, lv_obj_t *parent) {
     widget_layer_status_init();
     widget_wpm_status_init();
     widget_rssi_status_init();  // ← THÊM
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_RSSI)
+    zmk_split_central_rssi_subscribe();
+#endif
 
     return 0;
 }
@@ -0,0 +1,32 @@
+/*
+ * Copyright (c) 2025 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/types.h>
+
+enum zmk_ble_conn_mode {
+    ZMK_BLE_CONN_MODE_ACTIVE,
+    ZMK_BLE_CONN_MODE_IDLE,
+    ZMK_BLE_CONN_MODE_COUNT,
+};
+
+struct zmk_ble_conn_params_stats {
+    // Number of times each mode was entered
+    uint32_t mode_entries[ZMK_BLE_CONN_MODE_COUNT];
+    // Total time spent in each mode, including the current one
+    uint32_t mode_time_ms[ZMK_BLE_CONN_MODE_COUNT];
+    // Parameter update requests sent on host and split links
+    uint32_t update_requests;
+    // Requests the stack refused to send
+    uint32_t update_failures;
+    // Parameter updates completed by the controller
+    uint32_t updates_applied;
+};
+
+enum zmk_ble_conn_mode zmk_ble_conn_params_get_mode(void);
+
+int zmk_ble_conn_params_get_stats(struct zmk_ble_conn_params_stats *stats);
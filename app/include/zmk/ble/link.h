@@ -0,0 +1,33 @@
+/*
+ * Copyright (c) 2025 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/bluetooth/conn.h>
+
+struct zmk_ble_link_info {
+    // Connection interval in 1.25ms units
+    uint16_t interval;
+    uint16_t latency;
+    // Supervision timeout in 10ms units
+    uint16_t timeout;
+    // BT_GAP_LE_PHY_* values, 0 when PHY updates are not tracked
+    uint8_t tx_phy;
+    uint8_t rx_phy;
+    // Maximum link layer payload sizes in bytes, 0 when data length updates are not tracked
+    uint16_t tx_max_len;
+    uint16_t rx_max_len;
+};
+
+/**
+ * Request the LE 2M PHY and/or the maximum data length on a connection. If the peer or the
+ * controller refuses, the link stays on the 1M PHY and default data length.
+ *
+ * @return 0 if all requested updates were started, otherwise the last error.
+ */
+int zmk_ble_link_request_fast(struct bt_conn *conn, bool phy_2m, bool data_len);
+
+int zmk_ble_link_get_info(struct bt_conn *conn, struct zmk_ble_link_info *info);
@@ -14,7 +14,7 @@
  */
 #define ZMK_ENDPOINT_STR_LEN 10
 
-#ifdef CONFIG_ZMK_USB
+#ifdef CONFIG_ZMK_ENDPOINTS_USB
 #define ZMK_ENDPOINT_USB_COUNT 1
 #else
 #define ZMK_ENDPOINT_USB_COUNT 0
@@ -22,6 +22,9 @@
 
 #ifdef CONFIG_ZMK_BLE
 #define ZMK_ENDPOINT_BLE_COUNT ZMK_BLE_PROFILE_COUNT
+#elif defined(CONFIG_ZMK_ENDPOINTS_MOCK)
+// The mock only has BLE profile 0.
+#define ZMK_ENDPOINT_BLE_COUNT 1
 #else
 #define ZMK_ENDPOINT_BLE_COUNT 0
 #endif
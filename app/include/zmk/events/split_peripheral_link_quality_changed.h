@@ -0,0 +1,21 @@
+/*
+ * Copyright (c) 2025 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+#include <zmk/event_manager.h>
+
+struct zmk_split_peripheral_link_quality_changed {
+    uint8_t source;
+    // RSSI of the central as measured by the peripheral, in dBm. INT8_MAX if unavailable.
+    int8_t rssi;
+    // Wrapping counts since the peripheral booted
+    uint16_t notify_errors;
+    uint16_t queue_drops;
+};
+
+ZMK_EVENT_DECLARE(zmk_split_peripheral_link_quality_changed);
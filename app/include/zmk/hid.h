@@ -348,8 +348,21 @@ bool zmk_hid_mod_is_pressed(zmk_mod_t modifier);
 
 int zmk_hid_register_mods(zmk_mod_flags_t explicit_modifiers);
 int zmk_hid_unregister_mods(zmk_mod_flags_t explicit_modifiers);
-int zmk_hid_implicit_modifiers_press(zmk_mod_flags_t implicit_modifiers);
-int zmk_hid_implicit_modifiers_release(void);
+/**
+ * Apply the implicit modifiers of a pressed usage. Every held usage owns its implicit modifiers,
+ * counted per press, and those of the most recently pressed one are the ones reported.
+ */
+int zmk_hid_implicit_modifiers_press(uint32_t usage, zmk_mod_flags_t implicit_modifiers);
+/**
+ * Release one press of a usage. Once all of its presses are released it stops owning implicit
+ * modifiers, and the implicit modifiers of the newest remaining owner are reported again.
+ */
+int zmk_hid_implicit_modifiers_release(uint32_t usage);
+/**
+ * Check whether releasing a usage with zmk_hid_implicit_modifiers_release() would change the
+ * reported modifiers.
+ */
+bool zmk_hid_implicit_modifiers_release_changes(uint32_t usage);
 int zmk_hid_masked_modifiers_set(zmk_mod_flags_t masked_modifiers);
 int zmk_hid_masked_modifiers_clear(void);
 
@@ -59,4 +59,9 @@ int zmk_physical_layouts_get_position_map(uint8_t source, uint8_t dest, size_t m
  * @retval a negative errno value in the case of errors
  * @retval a positive length of the position map array that map is updated to point to.
  */
-int zmk_physical_layouts_get_selected_to_stock_position_map(uint32_t const **map);
\ No newline at end of file
+int zmk_physical_layouts_get_selected_to_stock_position_map(uint32_t const **map);
+
+/**
+ * @brief Get the number of kscan events dropped since boot because the kscan event queue was full
+ */
+uint32_t zmk_physical_layouts_get_kscan_dropped_events(void);
\ No newline at end of file
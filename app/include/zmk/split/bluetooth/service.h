@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include <zephyr/sys/util.h>
+
 #include <zmk/events/sensor_event.h>
 #include <zmk/sensors.h>
 
@@ -37,3 +39,64 @@ struct zmk_split_input_event_payload {
     uint32_t value;
     uint8_t sync;
 } __packed;
+
+// Sized so a full batch fits in the default 23 byte ATT MTU.
+#define ZMK_SPLIT_POSITION_DELTAS_MAX 5
+
+#define ZMK_SPLIT_POSITION_DELTA_PRESSED BIT(15)
+#define ZMK_SPLIT_POSITION_DELTA_AGE_MAX (BIT(15) - 1)
+
+struct zmk_split_position_delta {
+    uint8_t position;
+    // Little endian. The top bit is set for presses, the rest is how many milliseconds before the
+    // notification was sent that the change was detected, saturating at
+    // ZMK_SPLIT_POSITION_DELTA_AGE_MAX.
+    uint16_t state_and_age;
+} __packed;
+
+struct zmk_split_position_deltas_payload {
+    // Sequence number of the first delta. Each following delta is numbered one higher, so the
+    // central can detect lost notifications and fall back to reading the position bitmap.
+    uint8_t seq;
+    // Little endian peripheral uptime in ms when the notification was sent. Subtracting a delta's
+    // age gives the peripheral time it was scanned at.
+    uint32_t timestamp;
+    struct zmk_split_position_delta deltas[ZMK_SPLIT_POSITION_DELTAS_MAX];
+} __packed;
+
+// Behavior IDs used by the compact invocation frames are indexes into the peripheral's behavior
+// table, which the central reads once per connection. The table is the list of behavior device
+// names, each null terminated. Entries from ZMK_SPLIT_COMPACT_BEHAVIOR_ID_NONE onwards can only be
+// invoked by name.
+#define ZMK_SPLIT_COMPACT_BEHAVIOR_ID_NONE UINT8_MAX
+
+#define ZMK_SPLIT_COMPACT_BEHAVIOR_PRESSED BIT(0)
+#define ZMK_SPLIT_COMPACT_BEHAVIOR_PARAM1_WIDTH_SHIFT 1
+#define ZMK_SPLIT_COMPACT_BEHAVIOR_PARAM2_WIDTH_SHIFT 3
+#define ZMK_SPLIT_COMPACT_BEHAVIOR_WIDTH_MASK 0x3
+
+// Bytes used by each param for a width code in the frame flags.
+#define ZMK_SPLIT_COMPACT_BEHAVIOR_WIDTHS {0, 1, 2, 4}
+
+struct zmk_split_compact_behavior_header {
+    uint8_t id;
+    uint8_t position;
+    // ZMK_SPLIT_COMPACT_BEHAVIOR_PRESSED plus the width codes of the params that follow. Each
+    // param is little endian with its leading zero bytes dropped.
+    uint8_t flags;
+} __packed;
+
+#define ZMK_SPLIT_COMPACT_BEHAVIOR_FRAME_MAX                                                       \
+    (sizeof(struct zmk_split_compact_behavior_header) + 2 * sizeof(uint32_t))
+
+// HCI uses this value when the RSSI can't be read.
+#define ZMK_SPLIT_LINK_QUALITY_RSSI_UNKNOWN INT8_MAX
+
+struct zmk_split_link_quality_payload {
+    // RSSI of the central's packets as measured by the peripheral's controller, in dBm.
+    int8_t rssi;
+    // Little endian, wrapping counts since boot of notifications the stack failed to send and of
+    // events dropped because a notification queue was full.
+    uint16_t notify_errors;
+    uint16_t queue_drops;
+} __packed;
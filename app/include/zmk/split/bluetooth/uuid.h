@@ -21,3 +21,7 @@
 #define ZMK_SPLIT_BT_SELECT_PHYS_LAYOUT_UUID ZMK_BT_SPLIT_UUID(0x00000005)
 #define ZMK_SPLIT_BT_INPUT_EVENT_UUID ZMK_BT_SPLIT_UUID(0x00000006)
 #define ZMK_SPLIT_BT_CHAR_WPM_UUID ZMK_BT_SPLIT_UUID(0x00000007)  // ← THÊM DÒNG NÀY
+#define ZMK_SPLIT_BT_CHAR_POSITION_DELTA_UUID ZMK_BT_SPLIT_UUID(0x00000008)
+#define ZMK_SPLIT_BT_CHAR_RUN_COMPACT_BEHAVIORS_UUID ZMK_BT_SPLIT_UUID(0x00000009)
+#define ZMK_SPLIT_BT_CHAR_BEHAVIOR_TABLE_UUID ZMK_BT_SPLIT_UUID(0x0000000A)
+#define ZMK_SPLIT_BT_CHAR_LINK_QUALITY_UUID ZMK_BT_SPLIT_UUID(0x0000000B)
@@ -26,7 +26,14 @@
 #define WIRED_PERIPHERAL_COUNT 0
 #endif
 
-#define ZMK_SPLIT_CENTRAL_PERIPHERAL_COUNT MAX(BLE_PERIPHERAL_COUNT, WIRED_PERIPHERAL_COUNT)
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_MOCK)
+#define MOCK_PERIPHERAL_COUNT 1
+#else
+#define MOCK_PERIPHERAL_COUNT 0
+#endif
+
+#define ZMK_SPLIT_CENTRAL_PERIPHERAL_COUNT                                                         \
+    MAX(MAX(BLE_PERIPHERAL_COUNT, WIRED_PERIPHERAL_COUNT), MOCK_PERIPHERAL_COUNT)
 
 #if IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_HID_INDICATORS)
 #include <zmk/hid_indicators_types.h>
@@ -41,15 +48,79 @@ int zmk_split_central_update_hid_indicator(zmk_hid_indicators_t indicators);
 
 #endif // IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_HID_INDICATORS)
 
+#include <zmk/split/transport/types.h>
+
+/**
+ * Get the negotiated link parameters for a peripheral from the active transport.
+ * @return 0 on success, -ENOTSUP if the transport does not report link info, or another
+ * negative error code.
+ */
+int zmk_split_central_get_link_info(uint8_t source, struct zmk_split_transport_link_info *info);
+
+#include <zmk/split/transport/command_queue.h>
+
+/**
+ * Get the status of the active transport. Transports without status reporting are reported as
+ * available and fully connected.
+ * @return 0 on success, or -ENODEV if no transport is active.
+ */
+int zmk_split_central_get_transport_status(struct zmk_split_transport_status *status);
+
+/**
+ * Get the per-lane counters of the active transport's command queue.
+ * @return 0 on success, -ENOTSUP if the transport does not queue commands, or another negative
+ * error code.
+ */
+int zmk_split_central_get_command_queue_stats(struct zmk_split_command_queue_stats *stats);
+
+struct zmk_split_central_event_queue_stats {
+    // Events queued by transports since boot
+    uint32_t queued;
+    // Events dropped because the queue was full
+    uint32_t dropped;
+    // Events currently waiting to be processed
+    uint16_t depth;
+    // Highest depth seen since boot
+    uint16_t max_depth;
+};
+
+int zmk_split_central_get_event_queue_stats(struct zmk_split_central_event_queue_stats *stats);
+
 #if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_BATTERY_LEVEL_FETCHING)
 
 int zmk_split_central_get_peripheral_battery_level(uint8_t source, uint8_t *level);
 
 #endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_BATTERY_LEVEL_FETCHING)
 
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_RSSI)
+
+/**
+ * Start reading the RSSI of connected BLE peripherals. Readings run periodically while there is
+ * at least one subscriber and the keyboard is active, raising zmk_split_peripheral_rssi_changed
+ * when a value moves past the configured hysteresis.
+ */
+void zmk_split_central_rssi_subscribe(void);
+
+/**
+ * Drop a subscription added with zmk_split_central_rssi_subscribe.
+ */
+void zmk_split_central_rssi_unsubscribe(void);
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_RSSI)
+
 /**
  * Send WPM value to all connected peripherals
  * @param wpm Words per minute value (0-255)
  * @return 0 on success, negative error code on failure
  */
 int zmk_split_central_send_wpm(uint8_t wpm);  // ← THÊM DÒNG NÀY
+
+#if IS_ENABLED(CONFIG_ZMK_WPM)
+
+/**
+ * Send the current WPM to peripherals right away, even if it hasn't changed since the last update.
+ * Transports call this once a newly connected peripheral can receive WPM.
+ */
+void zmk_split_central_resend_wpm(void);
+
+#endif // IS_ENABLED(CONFIG_ZMK_WPM)
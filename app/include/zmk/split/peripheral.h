@@ -9,3 +9,10 @@
 #include <zmk/split/transport/types.h>
 
 int zmk_split_peripheral_report_event(const struct zmk_split_transport_peripheral_event *event);
+
+/**
+ * Get the status of the active transport. Transports without status reporting are reported as
+ * available and fully connected.
+ * @return 0 on success, or -ENODEV if no transport is active.
+ */
+int zmk_split_peripheral_get_transport_status(struct zmk_split_transport_status *status);
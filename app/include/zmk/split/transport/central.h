@@ -9,6 +9,7 @@
 #include <zephyr/types.h>
 
 #include <zmk/split/transport/types.h>
+#include <zmk/split/transport/command_queue.h>
 
 struct zmk_split_transport_central;
 
@@ -20,6 +21,10 @@ typedef int (*zmk_split_transport_central_send_command_t)(
 typedef int (*zmk_split_transport_central_get_available_source_ids_t)(uint8_t *sources);
 typedef int (*zmk_split_transport_central_set_status_callback_t)(
     zmk_split_transport_central_status_changed_cb_t cb);
+typedef int (*zmk_split_transport_central_get_link_info_t)(
+    uint8_t source, struct zmk_split_transport_link_info *info);
+typedef int (*zmk_split_transport_central_get_command_queue_stats_t)(
+    struct zmk_split_command_queue_stats *stats);
 
 struct zmk_split_transport_central_api {
     zmk_split_transport_central_send_command_t send_command;
@@ -27,6 +32,8 @@ struct zmk_split_transport_central_api {
     zmk_split_transport_set_enabled_t set_enabled;
     zmk_split_transport_get_status_t get_status;
     zmk_split_transport_central_set_status_callback_t set_status_callback;
+    zmk_split_transport_central_get_link_info_t get_link_info;
+    zmk_split_transport_central_get_command_queue_stats_t get_command_queue_stats;
 };
 
 struct zmk_split_transport_central {
@@ -37,6 +44,18 @@ int zmk_split_transport_central_peripheral_event_handler(
     const struct zmk_split_transport_central *transport, uint8_t source,
     struct zmk_split_transport_peripheral_event ev);
 
+/**
+ * Queue a peripheral event to be timestamped and then raised on the system work queue, in order
+ * with any events already queued. With CONFIG_ZMK_SPLIT_CENTRAL_EVENT_WORK_QUEUE, events are
+ * timestamped on a dedicated work queue as soon as they are taken from the queue. Called from the
+ * system work queue, the event is handled before returning.
+ * @return 0 on success, -ENOMSG if the queue is full and the event was dropped, or the
+ * handler's error when handled inline.
+ */
+int zmk_split_transport_central_peripheral_event_queue(
+    const struct zmk_split_transport_central *transport, uint8_t source,
+    struct zmk_split_transport_peripheral_event ev);
+
 #define ZMK_SPLIT_TRANSPORT_CENTRAL_REGISTER(name, _api, priority)                                 \
     STRUCT_SECTION_ITERABLE_NAMED(zmk_split_transport_central, _CONCAT(priority, _##name),         \
                                   name) = {                                                        \
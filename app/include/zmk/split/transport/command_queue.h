@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2025 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+#include <zephyr/spinlock.h>
+
+#include <zmk/split/transport/types.h>
+
+enum zmk_split_command_lane {
+    // Behavior invocations, sent in order and never dropped to make room. Room is kept for the
+    // release of every press until it is queued.
+    ZMK_SPLIT_COMMAND_LANE_CRITICAL,
+    // Peripheral state such as the physical layout, only the latest value is sent
+    ZMK_SPLIT_COMMAND_LANE_STATE,
+    // Best effort data such as WPM, latest value only and dropped when it can't be sent
+    ZMK_SPLIT_COMMAND_LANE_TELEMETRY,
+    ZMK_SPLIT_COMMAND_LANE_COUNT,
+};
+
+struct zmk_split_command_lane_stats {
+    // Commands accepted into the lane
+    uint32_t queued;
+    // Commands handed to the transport
+    uint32_t sent;
+    // Commands replaced by a newer value before being sent
+    uint32_t coalesced;
+    // Commands discarded: for a disconnected peripheral, as failed telemetry, or releases whose
+    // press was never queued
+    uint32_t dropped;
+    // Commands refused because the lane was full, or presses past the held limit
+    uint32_t rejected;
+};
+
+struct zmk_split_command_queue_stats {
+    struct zmk_split_command_lane_stats lanes[ZMK_SPLIT_COMMAND_LANE_COUNT];
+    // Highest number of critical commands waiting at once
+    uint16_t critical_max_depth;
+};
+
+// Command types kept as a single latest value per peripheral in the state and telemetry lanes.
+#define ZMK_SPLIT_COMMAND_QUEUE_LATEST_TYPES 3
+
+struct zmk_split_command_queue_item {
+    uint8_t source;
+    struct zmk_split_transport_central_command cmd;
+};
+
+// Presses each peripheral can have outstanding, i.e. queued or sent but not yet released.
+#define ZMK_SPLIT_COMMAND_QUEUE_HELD CONFIG_ZMK_SPLIT_CENTRAL_HELD_BEHAVIORS
+
+// A press whose release still needs a slot in the critical lane.
+struct zmk_split_command_queue_press {
+    uint8_t source;
+    uint32_t position;
+    const struct device *behavior;
+};
+
+struct zmk_split_command_queue_latest {
+    uint8_t pending;
+    struct zmk_split_transport_central_command cmds[ZMK_SPLIT_COMMAND_QUEUE_LATEST_TYPES];
+};
+
+struct zmk_split_command_queue {
+    struct k_msgq *critical;
+    struct zmk_split_command_queue_latest *latest;
+    struct zmk_split_command_queue_press *presses;
+    uint8_t presses_len;
+    uint8_t sources;
+    struct k_spinlock lock;
+    struct zmk_split_command_queue_stats stats;
+};
+
+// The critical lane holds `critical_size` commands, plus a release slot for each press a
+// peripheral can have outstanding.
+#define ZMK_SPLIT_COMMAND_QUEUE_DEFINE(name, _sources, critical_size)                              \
+    BUILD_ASSERT((critical_size) >= 1, "The critical lane needs room for a command");              \
+    BUILD_ASSERT((_sources) * ZMK_SPLIT_COMMAND_QUEUE_HELD <= UINT8_MAX,                           \
+                 "Too many outstanding presses to track");                                         \
+    K_MSGQ_DEFINE(_CONCAT(name, _critical), sizeof(struct zmk_split_command_queue_item),           \
+                  (critical_size) + (_sources) * ZMK_SPLIT_COMMAND_QUEUE_HELD, 4);                 \
+    static struct zmk_split_command_queue_latest _CONCAT(name, _latest)[_sources];                 \
+    static struct zmk_split_command_queue_press                                                    \
+        _CONCAT(name, _presses)[(_sources) * ZMK_SPLIT_COMMAND_QUEUE_HELD];                        \
+    static struct zmk_split_command_queue name = {                                                 \
+        .critical = &_CONCAT(name, _critical),                                                     \
+        .latest = _CONCAT(name, _latest),                                                          \
+        .presses = _CONCAT(name, _presses),                                                        \
+        .sources = _sources,                                                                       \
+    }
+
+enum zmk_split_command_lane
+zmk_split_command_queue_lane(enum zmk_split_transport_central_command_type type);
+
+/**
+ * Queue a command for a peripheral without blocking. Critical commands are refused when their
+ * lane is full, queued commands are never evicted. The release of an accepted press is always
+ * accepted, as room is kept for it, while a release whose press was refused is dropped. State and
+ * telemetry commands replace any value of the same type still pending for that peripheral.
+ * @return 0 on success, -EAGAIN if the critical lane is full or the peripheral already has
+ * ZMK_SPLIT_COMMAND_QUEUE_HELD presses outstanding, or -EINVAL.
+ */
+int zmk_split_command_queue_put(struct zmk_split_command_queue *queue, uint8_t source,
+                                const struct zmk_split_transport_central_command *cmd);
+
+/**
+ * Get the next command to send without removing it: critical commands in order first, then
+ * pending state and finally telemetry.
+ * @return 0 if a command was found, or -ENODATA if the queue is empty.
+ */
+int zmk_split_command_queue_peek(struct zmk_split_command_queue *queue,
+                                 struct zmk_split_command_queue_item *item,
+                                 enum zmk_split_command_lane *lane);
+
+/**
+ * Remove a command returned by zmk_split_command_queue_peek, counting it as sent or dropped.
+ * Must be called from the same thread as the peek. A newer value queued since the peek is kept.
+ */
+void zmk_split_command_queue_consume(struct zmk_split_command_queue *queue,
+                                     const struct zmk_split_command_queue_item *item,
+                                     enum zmk_split_command_lane lane, bool sent);
+
+/**
+ * Drop the pending state and telemetry for a peripheral that disconnected, and forget its
+ * outstanding presses.
+ */
+void zmk_split_command_queue_clear_source(struct zmk_split_command_queue *queue, uint8_t source);
+
+void zmk_split_command_queue_get_stats(struct zmk_split_command_queue *queue,
+                                       struct zmk_split_command_queue_stats *stats);
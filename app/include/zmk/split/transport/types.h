@@ -8,6 +8,7 @@
 
 #include <zmk/hid_indicators_types.h>
 #include <zmk/sensors.h>
+#include <zephyr/device.h>
 #include <zephyr/sys/util.h>
 
 enum zmk_split_transport_connections_status {
@@ -16,10 +17,42 @@ enum zmk_split_transport_connections_status {
     ZMK_SPLIT_TRANSPORT_CONNECTIONS_STATUS_ALL_CONNECTED,
 };
 
+struct zmk_split_transport_link_stats {
+    // Valid frames received
+    uint32_t rx_frames;
+    // Frames dropped for a bad CRC or an impossible size
+    uint32_t rx_bad_frames;
+    // Times the receiver skipped ahead to the next frame start, and the bytes it skipped
+    uint32_t rx_resyncs;
+    uint32_t rx_discarded_bytes;
+    // Times incoming data was lost because the RX buffer was full
+    uint32_t rx_overflows;
+    // Current link speed in baud, 0 for transports without one
+    uint32_t speed;
+    // Times the link dropped back to its base speed after a burst of errors
+    uint16_t speed_fallbacks;
+};
+
 struct zmk_split_transport_status {
     bool available;
     bool enabled;
     enum zmk_split_transport_connections_status connections;
+    // Current RX polling period in microseconds, 0 for transports that don't poll
+    uint32_t rx_poll_period_us;
+    // Framing and speed statistics, all zero for transports that don't track them
+    struct zmk_split_transport_link_stats link;
+};
+
+struct zmk_split_transport_link_info {
+    // Connection interval in 1.25ms units, 0 for transports without one
+    uint16_t interval;
+    uint16_t latency;
+    // BT_GAP_LE_PHY_* values, 0 for transports without a PHY
+    uint8_t tx_phy;
+    uint8_t rx_phy;
+    // Maximum link layer payload sizes in bytes
+    uint16_t tx_max_len;
+    uint16_t rx_max_len;
 };
 
 typedef struct zmk_split_transport_status (*zmk_split_transport_get_status_t)(void);
@@ -39,6 +72,8 @@ struct zmk_split_transport_peripheral_event {
         struct {
             uint8_t position;
             uint8_t pressed;
+            // Peripheral uptime in ms when the change was scanned, 0 if the transport lost it
+            uint32_t timestamp;
         } key_position_event;
         struct {
             struct zmk_sensor_channel_data channel_data;
@@ -88,4 +123,8 @@ struct zmk_split_transport_central_command {
             uint8_t wpm;
         } send_wpm;
     } data;
+    // Local behavior device of an INVOKE_BEHAVIOR command, whose behavior_dev may be truncated.
+    // Set by the central for its transports' use, and by peripheral transports that identify the
+    // behavior themselves. Never sent between devices.
+    const struct device *behavior;
 } __packed;
@@ -8,8 +8,17 @@
 
 #include <stdint.h>
 
+/**
+ * Send the current keyboard report. While USB is suspended, this and the other send functions
+ * only request a remote wakeup. With CONFIG_ZMK_ENDPOINTS_REPORT_SNAPSHOTS they then return
+ * -EAGAIN, since the report itself is not sent.
+ */
 int zmk_usb_hid_send_keyboard_report(void);
 int zmk_usb_hid_send_consumer_report(void);
+/**
+ * Send empty keyboard and consumer reports without touching the HID state.
+ */
+int zmk_usb_hid_send_release_all(void);
 #if IS_ENABLED(CONFIG_ZMK_POINTING)
 int zmk_usb_hid_send_mouse_report(void);
 #endif // IS_ENABLED(CONFIG_ZMK_POINTING)
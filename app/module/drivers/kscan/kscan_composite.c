@@ -10,6 +10,10 @@
 #include <zephyr/pm/device.h>
 #include <zephyr/drivers/kscan.h>
 #include <zephyr/logging/log.h>
+
+#include <zmk/kscan_coordinator.h>
+#include <zmk/kscan_state.h>
+
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
 #define MATRIX_NODE_ID DT_DRV_INST(0)
@@ -36,6 +40,11 @@ struct kscan_composite_data {
     kscan_callback_t callback;
 
     const struct device *dev;
+    struct zmk_kscan_state_provider state_provider;
+
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_COMPOSITE_MERGED_SCANS)
+    struct zmk_kscan_coordinator coordinator;
+#endif
 };
 
 static int kscan_composite_enable_callback(const struct device *dev) {
@@ -116,6 +125,43 @@ static void kscan_composite_child_callback(const struct device *child_dev, uint3
     }
 }
 
+struct kscan_composite_state_context {
+    const struct device *dev;
+    const struct kscan_composite_child_config *child_cfg;
+    zmk_kscan_state_cb_t cb;
+    void *user_data;
+};
+
+static void kscan_composite_child_state_cb(const struct device *child_dev, uint32_t row,
+                                           uint32_t column, void *user_data) {
+    const struct kscan_composite_state_context *ctx = user_data;
+
+    ctx->cb(ctx->dev, row + ctx->child_cfg->row_offset, column + ctx->child_cfg->column_offset,
+            ctx->user_data);
+}
+
+static int kscan_composite_get_state(const struct device *dev, zmk_kscan_state_cb_t cb,
+                                     void *user_data) {
+    const struct kscan_composite_config *cfg = dev->config;
+
+    for (int i = 0; i < cfg->children_len; i++) {
+        struct kscan_composite_state_context ctx = {
+            .dev = dev,
+            .child_cfg = &cfg->children[i],
+            .cb = cb,
+            .user_data = user_data,
+        };
+
+        // A partial state would make the missing child's keys look released, so fail instead.
+        int err = zmk_kscan_get_state(ctx.child_cfg->child, kscan_composite_child_state_cb, &ctx);
+        if (err) {
+            return err;
+        }
+    }
+
+    return 0;
+}
+
 static int kscan_composite_configure(const struct device *dev, kscan_callback_t callback) {
     const struct kscan_composite_config *cfg = dev->config;
     struct kscan_composite_data *data = dev->data;
@@ -135,11 +181,39 @@ static int kscan_composite_configure(const struct device *dev, kscan_callback_t
     return 0;
 }
 
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_COMPOSITE_MERGED_SCANS)
+
+static void kscan_composite_attach_children(const struct device *dev) {
+    const struct kscan_composite_config *cfg = dev->config;
+    struct kscan_composite_data *data = dev->data;
+
+    zmk_kscan_coordinator_init(&data->coordinator, CONFIG_ZMK_KSCAN_COMPOSITE_MERGE_WINDOW_MS);
+
+    for (int i = 0; i < cfg->children_len; i++) {
+        const struct device *child = cfg->children[i].child;
+
+        int err = zmk_kscan_coordinator_attach(&data->coordinator, child);
+        if (err) {
+            LOG_DBG("%s schedules its own scans: %d", child->name, err);
+        }
+    }
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_KSCAN_COMPOSITE_MERGED_SCANS)
+
 static int kscan_composite_init(const struct device *dev) {
     struct kscan_composite_data *data = dev->data;
 
     data->dev = dev;
 
+    data->state_provider.dev = dev;
+    data->state_provider.get_state = kscan_composite_get_state;
+    zmk_kscan_state_register(&data->state_provider);
+
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_COMPOSITE_MERGED_SCANS)
+    kscan_composite_attach_children(dev);
+#endif
+
 #if IS_ENABLED(CONFIG_PM_DEVICE)
     pm_device_init_suspended(dev);
 #endif
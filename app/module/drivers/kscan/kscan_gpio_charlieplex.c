@@ -5,6 +5,9 @@
  */
 
 #include <zmk/debounce.h>
+#include <zmk/kscan_cadence.h>
+#include <zmk/kscan_coordinator.h>
+#include <zmk/kscan_state.h>
 
 #include <zephyr/device.h>
 #include <zephyr/devicetree.h>
@@ -21,7 +24,6 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 #define DT_DRV_COMPAT zmk_kscan_gpio_charlieplex
 
 #define INST_LEN(n) DT_INST_PROP_LEN(n, gpios)
-#define INST_CHARLIEPLEX_LEN(n) (INST_LEN(n) * INST_LEN(n))
 
 #if CONFIG_ZMK_KSCAN_DEBOUNCE_PRESS_MS >= 0
 #define INST_DEBOUNCE_PRESS_MS(n) CONFIG_ZMK_KSCAN_DEBOUNCE_PRESS_MS
@@ -37,6 +39,11 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
     DT_INST_PROP_OR(n, debounce_period, DT_INST_PROP(n, debounce_release_ms))
 #endif
 
+#define INST_DEBOUNCE_PRESS_MODE(n)                                                                \
+    ((enum zmk_debounce_mode)DT_INST_ENUM_IDX(n, debounce_press_mode))
+#define INST_DEBOUNCE_RELEASE_MODE(n)                                                              \
+    ((enum zmk_debounce_mode)DT_INST_ENUM_IDX(n, debounce_release_mode))
+
 #define KSCAN_GPIO_CFG_INIT(idx, inst_idx)                                                         \
     GPIO_DT_SPEC_GET_BY_IDX(DT_DRV_INST(inst_idx), gpios, idx)
 
@@ -53,17 +60,51 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
 #define KSCAN_INTR_CFG_INIT(inst_idx) GPIO_DT_SPEC_GET(DT_DRV_INST(inst_idx), interrupt_gpios)
 
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_CHARLIEPLEX_SCAN_STATS)
+struct kscan_charlieplex_scan_stats {
+    uint32_t scans;
+    uint32_t timer_steps;
+    uint32_t cpu_cycles;
+    uint32_t elapsed_cycles;
+};
+#endif
+
 struct kscan_charlieplex_data {
     const struct device *dev;
     kscan_callback_t callback;
     struct k_work_delayable work;
     int64_t scan_time; /* Timestamp of the current or scheduled scan. */
+    /** Lets a composite kscan run this driver's scans along with its other children. */
+    struct zmk_kscan_coordinator_client coordinator;
+    struct zmk_kscan_state_provider state_provider;
     struct gpio_callback irq_callback;
     /**
-     * Current state of the matrix as a flattened 2D array of length
-     * (config->cells.length ^2)
+     * Debounce state for the keys on each output as an array of length config->cells.len. Each
+     * bit is the key on the input with that cell index.
      */
-    struct zmk_debounce_state *charlieplex_state;
+    struct zmk_debounce_row *charlieplex_rows;
+    struct zmk_kscan_cadence_client cadence;
+    /** Whether the scheduled scan is a poll for the first key press. */
+    bool poll_idle;
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_CHARLIEPLEX_STEPPED_SCAN)
+    /** Inputs read for each output by the current scan, as an array of length config->cells.len. */
+    uint32_t *step_inputs;
+    struct k_timer step_timer;
+    /** Debounces the inputs once the timer steps have read every output. */
+    struct k_work step_done_work;
+    /** The output the current scan is on. */
+    int step_row;
+    /** Whether step_row is currently set as an output. */
+    bool step_driving;
+    /** Error from a timer step, which ends the scan. */
+    int step_err;
+#endif
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_CHARLIEPLEX_SCAN_STATS)
+    /** Cycle count at the start of the current scan. */
+    uint32_t scan_start;
+    /** Totals since the matrix last went idle. */
+    struct kscan_charlieplex_scan_stats stats;
+#endif
 };
 
 struct kscan_gpio_list {
@@ -77,27 +118,14 @@ struct kscan_gpio_list {
 
 struct kscan_charlieplex_config {
     struct kscan_gpio_list cells;
-    struct zmk_debounce_config debounce_config;
+    struct zmk_debounce_row_config debounce_config;
     int32_t debounce_scan_period_ms;
-    int32_t poll_period_ms;
+    /** Time between scans with no key pressed for each cadence tier, when polling. */
+    int32_t poll_periods_ms[ZMK_KSCAN_CADENCE_TIER_COUNT];
     bool use_interrupt;
     const struct gpio_dt_spec interrupt;
 };
 
-/**
- * Get the index into a matrix state array from a row and column.
- * There are effectively (n) cols and (n-1) rows, but we use the full col x row space
- * as a safety measure against someone accidentally defining a transform RC at (p,p)
- */
-static int state_index(const struct kscan_charlieplex_config *config, const int row,
-                       const int col) {
-    __ASSERT(row < config->cells.len, "Invalid row %i", row);
-    __ASSERT(col < config->cells.len, "Invalid column %i", col);
-    __ASSERT(col != row, "Invalid column row pair %i, %i", col, row);
-
-    return (col * config->cells.len) + row;
-}
-
 static int kscan_charlieplex_set_as_input(const struct gpio_dt_spec *gpio) {
     if (!device_is_ready(gpio->port)) {
         LOG_ERR("GPIO is not ready: %s", gpio->port->name);
@@ -211,6 +239,19 @@ static int kscan_charlieplex_interrupt_enable(const struct device *dev) {
     return kscan_charlieplex_set_all_outputs(dev, 1);
 }
 
+/**
+ * Schedules a scan at data->scan_time. If a composite kscan coordinates this driver, the scan
+ * instead runs from the composite's work item along with any other scans due then.
+ */
+static void kscan_charlieplex_schedule(const struct device *dev, const k_timeout_t timeout,
+                                       const bool idle) {
+    struct kscan_charlieplex_data *data = dev->data;
+
+    if (zmk_kscan_coordinator_schedule(&data->coordinator, data->scan_time, idle) != 0) {
+        k_work_reschedule(&data->work, timeout);
+    }
+}
+
 static void kscan_charlieplex_irq_callback(const struct device *port, struct gpio_callback *cb,
                                            const gpio_port_pins_t _pin) {
     struct kscan_charlieplex_data *data =
@@ -219,7 +260,7 @@ static void kscan_charlieplex_irq_callback(const struct device *port, struct gpi
     // Disable our interrupt to avoid re-entry while we scan.
     kscan_charlieplex_interrupt_configure(data->dev, GPIO_INT_DISABLE);
     data->scan_time = k_uptime_get();
-    k_work_reschedule(&data->work, K_NO_WAIT);
+    kscan_charlieplex_schedule(data->dev, K_NO_WAIT, false);
 }
 
 static void kscan_charlieplex_read_continue(const struct device *dev) {
@@ -227,8 +268,9 @@ static void kscan_charlieplex_read_continue(const struct device *dev) {
     struct kscan_charlieplex_data *data = dev->data;
 
     data->scan_time += config->debounce_scan_period_ms;
+    data->poll_idle = false;
 
-    k_work_reschedule(&data->work, K_TIMEOUT_ABS_MS(data->scan_time));
+    kscan_charlieplex_schedule(dev, K_TIMEOUT_ABS_MS(data->scan_time), false);
 }
 
 static void kscan_charlieplex_read_end(const struct device *dev) {
@@ -239,18 +281,244 @@ static void kscan_charlieplex_read_end(const struct device *dev) {
         // Return to waiting for an interrupt.
         kscan_charlieplex_interrupt_enable(dev);
     } else {
-        data->scan_time += config->poll_period_ms;
+        data->scan_time += config->poll_periods_ms[zmk_kscan_cadence_get_tier()];
+        data->poll_idle = true;
 
         // Return to polling slowly.
-        k_work_reschedule(&data->work, K_TIMEOUT_ABS_MS(data->scan_time));
+        kscan_charlieplex_schedule(dev, K_TIMEOUT_ABS_MS(data->scan_time), true);
+    }
+}
+
+static void kscan_charlieplex_cadence_changed(struct zmk_kscan_cadence_client *client,
+                                              enum zmk_kscan_cadence_tier old_tier,
+                                              enum zmk_kscan_cadence_tier new_tier) {
+    struct kscan_charlieplex_data *data =
+        CONTAINER_OF(client, struct kscan_charlieplex_data, cadence);
+    const struct kscan_charlieplex_config *config = data->dev->config;
+
+    // Don't wait out a slow poll once things speed up.
+    if (data->poll_idle && config->poll_periods_ms[new_tier] < config->poll_periods_ms[old_tier]) {
+        data->scan_time = k_uptime_get();
+        kscan_charlieplex_schedule(data->dev, K_NO_WAIT, true);
+    }
+}
+
+/** Reads the inputs for an output which has already been set active. */
+static uint32_t kscan_charlieplex_read_row(const struct device *dev, const int row) {
+    const struct kscan_charlieplex_config *config = dev->config;
+    uint32_t active = 0;
+
+    for (int col = 0; col < config->cells.len; col++) {
+        if (col == row) {
+            continue; // pin can't drive itself
+        }
+        const struct gpio_dt_spec *in_gpio = &config->cells.gpios[col];
+
+        WRITE_BIT(active, col, gpio_pin_get_dt(in_gpio) > 0);
+    }
+
+    return active;
+}
+
+/**
+ * Debounces the inputs read for an output and reports any changes. Returns true if a key on the
+ * output is pressed or still being debounced.
+ */
+static bool kscan_charlieplex_process_row(const struct device *dev, const int row,
+                                          const uint32_t active) {
+    struct kscan_charlieplex_data *data = dev->data;
+    const struct kscan_charlieplex_config *config = dev->config;
+
+    struct zmk_debounce_row *debounce_row = &data->charlieplex_rows[row];
+    zmk_debounce_row_update(debounce_row, active, &config->debounce_config);
+
+    // NOTE: RR vs MATRIX: because we don't need an input/output => row/column
+    // setup, we can send events for the whole row straight away.
+    uint32_t changed = debounce_row->changed;
+
+    while (changed) {
+        const int col = __builtin_ctz(changed);
+        changed &= changed - 1;
+
+        const bool pressed = (debounce_row->pressed & BIT(col)) != 0;
+
+        LOG_DBG("Sending event at %i,%i state %s", row, col, pressed ? "on" : "off");
+        data->callback(dev, row, col, pressed);
     }
+
+    return zmk_debounce_row_get_active(debounce_row);
+}
+
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_CHARLIEPLEX_SCAN_STATS)
+static void kscan_charlieplex_log_stats(const struct device *dev) {
+    struct kscan_charlieplex_data *data = dev->data;
+    const struct kscan_charlieplex_scan_stats *stats = &data->stats;
+
+    LOG_DBG("%u scans, %u timer steps per scan, %u us CPU and %u us elapsed per scan",
+            stats->scans, stats->timer_steps / stats->scans,
+            k_cyc_to_us_floor32(stats->cpu_cycles) / stats->scans,
+            k_cyc_to_us_floor32(stats->elapsed_cycles) / stats->scans);
+
+    data->stats = (struct kscan_charlieplex_scan_stats){0};
+}
+#endif
+
+static void kscan_charlieplex_read_done(const struct device *dev, const bool continue_scan) {
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_CHARLIEPLEX_SCAN_STATS)
+    struct kscan_charlieplex_data *data = dev->data;
+    data->stats.elapsed_cycles += k_cycle_get_32() - data->scan_start;
+    data->stats.scans++;
+#endif
+
+    if (continue_scan) {
+        // At least one key is pressed or the debouncer has not yet decided if
+        // it is pressed. Poll quickly until everything is released.
+        kscan_charlieplex_read_continue(dev);
+    } else {
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_CHARLIEPLEX_SCAN_STATS)
+        kscan_charlieplex_log_stats(dev);
+#endif
+
+        // All keys are released. Return to normal.
+        kscan_charlieplex_read_end(dev);
+    }
+}
+
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_CHARLIEPLEX_STEPPED_SCAN)
+
+/**
+ * Runs the scan up to the next wait, then arms the step timer to continue it. Once every output
+ * has been read, hands the inputs off to step_done_work. Runs in interrupt context for every step
+ * but the first.
+ */
+static void kscan_charlieplex_step(const struct device *dev) {
+    struct kscan_charlieplex_data *data = dev->data;
+    const struct kscan_charlieplex_config *config = dev->config;
+
+    while (true) {
+        if (data->step_driving) {
+            const int row = data->step_row;
+            data->step_inputs[row] = kscan_charlieplex_read_row(dev, row);
+
+            int err = kscan_charlieplex_set_as_input(&config->cells.gpios[row]);
+            if (err) {
+                data->step_err = err;
+                return;
+            }
+
+            data->step_driving = false;
+            data->step_row++;
+
+            // Unlike the busy wait, there's nothing to settle for after the last output.
+            if (CONFIG_ZMK_KSCAN_CHARLIEPLEX_WAIT_BETWEEN_OUTPUTS > 0 &&
+                data->step_row < config->cells.len) {
+                k_timer_start(&data->step_timer,
+                              K_USEC(CONFIG_ZMK_KSCAN_CHARLIEPLEX_WAIT_BETWEEN_OUTPUTS), K_NO_WAIT);
+                return;
+            }
+        }
+
+        if (data->step_row == config->cells.len) {
+            k_work_submit(&data->step_done_work);
+            return;
+        }
+
+        int err = kscan_charlieplex_set_as_output(&config->cells.gpios[data->step_row]);
+        if (err) {
+            data->step_err = err;
+            return;
+        }
+
+        data->step_driving = true;
+
+        if (CONFIG_ZMK_KSCAN_CHARLIEPLEX_WAIT_BEFORE_INPUTS > 0) {
+            k_timer_start(&data->step_timer,
+                          K_USEC(CONFIG_ZMK_KSCAN_CHARLIEPLEX_WAIT_BEFORE_INPUTS), K_NO_WAIT);
+            return;
+        }
+    }
+}
+
+static void kscan_charlieplex_step_timer_expiry(struct k_timer *timer) {
+    struct kscan_charlieplex_data *data =
+        CONTAINER_OF(timer, struct kscan_charlieplex_data, step_timer);
+
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_CHARLIEPLEX_SCAN_STATS)
+    const uint32_t start = k_cycle_get_32();
+#endif
+
+    kscan_charlieplex_step(data->dev);
+
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_CHARLIEPLEX_SCAN_STATS)
+    data->stats.cpu_cycles += k_cycle_get_32() - start;
+    data->stats.timer_steps++;
+#endif
+}
+
+static void kscan_charlieplex_step_done_handler(struct k_work *work) {
+    struct kscan_charlieplex_data *data =
+        CONTAINER_OF(work, struct kscan_charlieplex_data, step_done_work);
+    const struct device *dev = data->dev;
+    const struct kscan_charlieplex_config *config = dev->config;
+    bool continue_scan = false;
+
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_CHARLIEPLEX_SCAN_STATS)
+    const uint32_t start = k_cycle_get_32();
+#endif
+
+    for (int row = 0; row < config->cells.len; row++) {
+        if (kscan_charlieplex_process_row(dev, row, data->step_inputs[row])) {
+            continue_scan = true;
+        }
+    }
+
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_CHARLIEPLEX_SCAN_STATS)
+    data->stats.cpu_cycles += k_cycle_get_32() - start;
+#endif
+
+    kscan_charlieplex_read_done(dev, continue_scan);
 }
 
 static int kscan_charlieplex_read(const struct device *dev) {
     struct kscan_charlieplex_data *data = dev->data;
+
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_CHARLIEPLEX_SCAN_STATS)
+    data->scan_start = k_cycle_get_32();
+#endif
+
+    // The scan finishes from the step timer, so don't let a cadence change restart it.
+    data->poll_idle = false;
+
+    // NOTE: RR vs MATRIX: set all pins as input, in case there was a failure on a
+    // previous scan, and one of the pins is still set as output
+    int err = kscan_charlieplex_set_all_as_input(dev);
+    if (err) {
+        return err;
+    }
+
+    data->step_row = 0;
+    data->step_driving = false;
+    data->step_err = 0;
+    kscan_charlieplex_step(dev);
+
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_CHARLIEPLEX_SCAN_STATS)
+    data->stats.cpu_cycles += k_cycle_get_32() - data->scan_start;
+#endif
+
+    return data->step_err;
+}
+
+#else
+
+static int kscan_charlieplex_read(const struct device *dev) {
     const struct kscan_charlieplex_config *config = dev->config;
     bool continue_scan = false;
 
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_CHARLIEPLEX_SCAN_STATS)
+    struct kscan_charlieplex_data *data = dev->data;
+    data->scan_start = k_cycle_get_32();
+#endif
+
     // NOTE: RR vs MATRIX: set all pins as input, in case there was a failure on a
     // previous scan, and one of the pins is still set as output
     int err = kscan_charlieplex_set_all_as_input(dev);
@@ -270,26 +538,9 @@ static int kscan_charlieplex_read(const struct device *dev) {
         k_busy_wait(CONFIG_ZMK_KSCAN_CHARLIEPLEX_WAIT_BEFORE_INPUTS);
 #endif
 
-        for (int col = 0; col < config->cells.len; col++) {
-            if (col == row) {
-                continue; // pin can't drive itself
-            }
-            const struct gpio_dt_spec *in_gpio = &config->cells.gpios[col];
-            const int index = state_index(config, row, col);
-
-            struct zmk_debounce_state *state = &data->charlieplex_state[index];
-            zmk_debounce_update(state, gpio_pin_get_dt(in_gpio), config->debounce_scan_period_ms,
-                                &config->debounce_config);
-
-            // NOTE: RR vs MATRIX: because we don't need an input/output => row/column
-            // setup, we can update in the same loop.
-            if (zmk_debounce_get_changed(state)) {
-                const bool pressed = zmk_debounce_is_pressed(state);
-
-                LOG_DBG("Sending event at %i,%i state %s", row, col, pressed ? "on" : "off");
-                data->callback(dev, row, col, pressed);
-            }
-            continue_scan = continue_scan || zmk_debounce_is_active(state);
+        const uint32_t active = kscan_charlieplex_read_row(dev, row);
+        if (kscan_charlieplex_process_row(dev, row, active)) {
+            continue_scan = true;
         }
 
         err = kscan_charlieplex_set_as_input(out_gpio);
@@ -301,24 +552,52 @@ static int kscan_charlieplex_read(const struct device *dev) {
 #endif
     }
 
-    if (continue_scan) {
-        // At least one key is pressed or the debouncer has not yet decided if
-        // it is pressed. Poll quickly until everything is released.
-        kscan_charlieplex_read_continue(dev);
-    } else {
-        // All keys are released. Return to normal.
-        kscan_charlieplex_read_end(dev);
-    }
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_CHARLIEPLEX_SCAN_STATS)
+    // Busy waits keep the CPU running, so the whole scan counts as CPU time.
+    data->stats.cpu_cycles += k_cycle_get_32() - data->scan_start;
+#endif
+
+    kscan_charlieplex_read_done(dev, continue_scan);
 
     return 0;
 }
 
+#endif // IS_ENABLED(CONFIG_ZMK_KSCAN_CHARLIEPLEX_STEPPED_SCAN)
+
 static void kscan_charlieplex_work_handler(struct k_work *work) {
     struct k_work_delayable *dwork = CONTAINER_OF(work, struct k_work_delayable, work);
     struct kscan_charlieplex_data *data = CONTAINER_OF(dwork, struct kscan_charlieplex_data, work);
     kscan_charlieplex_read(data->dev);
 }
 
+static void kscan_charlieplex_coordinated_scan(struct zmk_kscan_coordinator_client *client,
+                                               const int64_t scan_time) {
+    struct kscan_charlieplex_data *data =
+        CONTAINER_OF(client, struct kscan_charlieplex_data, coordinator);
+
+    data->scan_time = scan_time;
+    kscan_charlieplex_read(data->dev);
+}
+
+static int kscan_charlieplex_get_state(const struct device *dev, const zmk_kscan_state_cb_t cb,
+                                       void *user_data) {
+    struct kscan_charlieplex_data *data = dev->data;
+    const struct kscan_charlieplex_config *config = dev->config;
+
+    for (int row = 0; row < config->cells.len; row++) {
+        uint32_t pressed = data->charlieplex_rows[row].pressed;
+
+        while (pressed) {
+            const int col = __builtin_ctz(pressed);
+            pressed &= pressed - 1;
+
+            cb(dev, row, col, user_data);
+        }
+    }
+
+    return 0;
+}
+
 static int kscan_charlieplex_configure(const struct device *dev, const kscan_callback_t callback) {
     if (!callback) {
         return -EINVAL;
@@ -340,6 +619,12 @@ static int kscan_charlieplex_enable(const struct device *dev) {
 static int kscan_charlieplex_disable(const struct device *dev) {
     struct kscan_charlieplex_data *data = dev->data;
     k_work_cancel_delayable(&data->work);
+    zmk_kscan_coordinator_cancel(&data->coordinator);
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_CHARLIEPLEX_STEPPED_SCAN)
+    k_timer_stop(&data->step_timer);
+    k_work_cancel(&data->step_done_work);
+#endif
+    data->poll_idle = false;
 
     const struct kscan_charlieplex_config *config = dev->config;
     if (config->use_interrupt) {
@@ -416,6 +701,24 @@ static int kscan_charlieplex_init(const struct device *dev) {
 
     k_work_init_delayable(&data->work, kscan_charlieplex_work_handler);
 
+    data->coordinator.dev = dev;
+    data->coordinator.scan = kscan_charlieplex_coordinated_scan;
+    zmk_kscan_coordinator_register(&data->coordinator);
+
+    data->state_provider.dev = dev;
+    data->state_provider.get_state = kscan_charlieplex_get_state;
+    zmk_kscan_state_register(&data->state_provider);
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_CHARLIEPLEX_STEPPED_SCAN)
+    k_timer_init(&data->step_timer, kscan_charlieplex_step_timer_expiry, NULL);
+    k_work_init(&data->step_done_work, kscan_charlieplex_step_done_handler);
+#endif
+
+    const struct kscan_charlieplex_config *config = dev->config;
+    if (!config->use_interrupt) {
+        data->cadence.changed = kscan_charlieplex_cadence_changed;
+        zmk_kscan_cadence_register(&data->cadence);
+    }
+
 #if IS_ENABLED(CONFIG_PM_DEVICE)
     pm_device_init_suspended(dev);
 
@@ -442,22 +745,29 @@ static const struct kscan_driver_api kscan_charlieplex_api = {
     BUILD_ASSERT(INST_DEBOUNCE_RELEASE_MS(n) <= DEBOUNCE_COUNTER_MAX,                              \
                  "ZMK_KSCAN_DEBOUNCE_RELEASE_MS or debounce-release-ms is too large");             \
                                                                                                    \
-    static struct zmk_debounce_state kscan_charlieplex_state_##n[INST_CHARLIEPLEX_LEN(n)];         \
+    BUILD_ASSERT(INST_LEN(n) <= 32, "A charlieplex matrix supports at most 32 GPIOs");             \
+                                                                                                   \
+    static struct zmk_debounce_row kscan_charlieplex_rows_##n[INST_LEN(n)];                        \
+    IF_ENABLED(CONFIG_ZMK_KSCAN_CHARLIEPLEX_STEPPED_SCAN,                                          \
+               (static uint32_t kscan_charlieplex_step_inputs_##n[INST_LEN(n)];))                  \
     static const struct gpio_dt_spec kscan_charlieplex_cells_##n[] = {                             \
         LISTIFY(INST_LEN(n), KSCAN_GPIO_CFG_INIT, (, ), n)};                                       \
     static struct kscan_charlieplex_data kscan_charlieplex_data_##n = {                            \
-        .charlieplex_state = kscan_charlieplex_state_##n,                                          \
+        .charlieplex_rows = kscan_charlieplex_rows_##n,                                            \
+        IF_ENABLED(CONFIG_ZMK_KSCAN_CHARLIEPLEX_STEPPED_SCAN,                                      \
+                   (.step_inputs = kscan_charlieplex_step_inputs_##n, ))                           \
     };                                                                                             \
                                                                                                    \
     static const struct kscan_charlieplex_config kscan_charlieplex_config_##n = {                  \
         .cells = KSCAN_GPIO_LIST(kscan_charlieplex_cells_##n),                                     \
-        .debounce_config =                                                                         \
-            {                                                                                      \
-                .debounce_press_ms = INST_DEBOUNCE_PRESS_MS(n),                                    \
-                .debounce_release_ms = INST_DEBOUNCE_RELEASE_MS(n),                                \
-            },                                                                                     \
+        .debounce_config = ZMK_DEBOUNCE_ROW_CONFIG(INST_DEBOUNCE_PRESS_MS(n),                      \
+                                                   INST_DEBOUNCE_RELEASE_MS(n),                    \
+                                                   DT_INST_PROP(n, debounce_scan_period_ms),       \
+                                                   INST_DEBOUNCE_PRESS_MODE(n),                    \
+                                                   INST_DEBOUNCE_RELEASE_MODE(n)),                 \
         .debounce_scan_period_ms = DT_INST_PROP(n, debounce_scan_period_ms),                       \
-        COND_ANY_POLLING((.poll_period_ms = DT_INST_PROP(n, poll_period_ms), ))                    \
+        COND_ANY_POLLING(                                                                          \
+            (.poll_periods_ms = ZMK_KSCAN_CADENCE_DT_INST_POLL_PERIODS(n, poll_period_ms), ))      \
             COND_THIS_INTERRUPT(n, (.use_interrupt = INST_INTR_DEFINED(n), ))                      \
                 COND_THIS_INTERRUPT(n, (.interrupt = KSCAN_INTR_CFG_INIT(n), ))};                  \
                                                                                                    \
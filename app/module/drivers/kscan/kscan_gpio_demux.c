@@ -11,6 +11,9 @@
 #include <zephyr/drivers/gpio.h>
 #include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
+#include <zmk/debounce.h>
+#include <zmk/kscan_cadence.h>
+#include <zmk/kscan_state.h>
 
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
@@ -27,9 +30,17 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 #define INST_MATRIX_INPUTS(n) DT_INST_PROP_LEN(n, input_gpios)
 #define INST_DEMUX_GPIOS(n) DT_INST_PROP_LEN(n, output_gpios)
 #define INST_MATRIX_OUTPUTS(n) PWR_TWO(INST_DEMUX_GPIOS(n))
-#define POLL_INTERVAL(n) DT_INST_PROP(n, polling_interval_msec)
+
+// Defer mode keeps this driver's behaviour of reporting a change on the first read that sees it,
+// eager mode ignores the key for debounce-period after each change.
+#define INST_DEBOUNCE_MODE(n, prop) ((enum zmk_debounce_mode)DT_INST_ENUM_IDX(n, prop))
+#define INST_DEBOUNCE_MS(n, prop)                                                                  \
+    (INST_DEBOUNCE_MODE(n, prop) == ZMK_DEBOUNCE_MODE_EAGER ? DT_INST_PROP(n, debounce_period) : 0)
 
 #define GPIO_INST_INIT(n)                                                                          \
+    BUILD_ASSERT(DT_INST_PROP(n, debounce_period) <= DEBOUNCE_COUNTER_MAX,                         \
+                 "debounce-period is too large");                                                  \
+                                                                                                   \
     struct kscan_gpio_irq_callback_##n {                                                           \
         struct CHECK_DEBOUNCE_CFG(n, (k_work), (k_work_delayable)) * work;                         \
         struct gpio_callback callback;                                                             \
@@ -39,13 +50,19 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
     struct kscan_gpio_config_##n {                                                                 \
         const struct gpio_dt_spec rows[INST_MATRIX_INPUTS(n)];                                     \
         const struct gpio_dt_spec cols[INST_DEMUX_GPIOS(n)];                                       \
+        struct zmk_debounce_config debounce_config;                                                \
+        int32_t poll_periods_ms[ZMK_KSCAN_CADENCE_TIER_COUNT];                                     \
     };                                                                                             \
                                                                                                    \
     struct kscan_gpio_data_##n {                                                                   \
         kscan_callback_t callback;                                                                 \
         struct k_timer poll_timer;                                                                 \
         struct CHECK_DEBOUNCE_CFG(n, (k_work), (k_work_delayable)) work;                           \
-        bool matrix_state[INST_MATRIX_INPUTS(n)][INST_MATRIX_OUTPUTS(n)];                          \
+        struct zmk_debounce_state matrix_state[INST_MATRIX_INPUTS(n)][INST_MATRIX_OUTPUTS(n)];     \
+        int64_t read_time;                                                                         \
+        struct zmk_kscan_cadence_client cadence;                                                   \
+        struct zmk_kscan_state_provider state_provider;                                            \
+        bool enabled;                                                                              \
         const struct device *dev;                                                                  \
     };                                                                                             \
     /* IO/GPIO SETUP */                                                                            \
@@ -70,6 +87,7 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
     static int kscan_gpio_read_##n(const struct device *dev) {                                     \
         bool submit_follow_up_read = false;                                                        \
         struct kscan_gpio_data_##n *data = dev->data;                                              \
+        const struct kscan_gpio_config_##n *cfg = dev->config;                                     \
         static bool read_state[INST_MATRIX_INPUTS(n)][INST_MATRIX_OUTPUTS(n)];                     \
         for (int o = 0; o < INST_MATRIX_OUTPUTS(n); o++) {                                         \
             /* Iterate over bits and set GPIOs accordingly */                                      \
@@ -87,20 +105,27 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
                 read_state[i][o] = gpio_pin_get_dt(in_spec) > 0;                                   \
             }                                                                                      \
         }                                                                                          \
+        const int64_t now = k_uptime_get();                                                        \
+        const int elapsed_ms = MIN(now - data->read_time, DEBOUNCE_COUNTER_MAX);                   \
+        data->read_time = now;                                                                     \
         for (int r = 0; r < INST_MATRIX_INPUTS(n); r++) {                                          \
             for (int c = 0; c < INST_MATRIX_OUTPUTS(n); c++) {                                     \
-                bool pressed = read_state[r][c];                                                   \
-                submit_follow_up_read = (submit_follow_up_read || pressed);                        \
-                if (pressed != data->matrix_state[r][c]) {                                         \
+                struct zmk_debounce_state *state = &data->matrix_state[r][c];                      \
+                zmk_debounce_update(state, read_state[r][c], elapsed_ms, &cfg->debounce_config);   \
+                submit_follow_up_read = (submit_follow_up_read || zmk_debounce_is_active(state));  \
+                if (zmk_debounce_get_changed(state)) {                                             \
+                    const bool pressed = zmk_debounce_is_pressed(state);                           \
                     LOG_DBG("Sending event at %d,%d state %s", r, c, (pressed ? "on" : "off"));    \
-                    data->matrix_state[r][c] = pressed;                                            \
                     data->callback(dev, r, c, pressed);                                            \
                 }                                                                                  \
             }                                                                                      \
         }                                                                                          \
         if (submit_follow_up_read) {                                                               \
             CHECK_DEBOUNCE_CFG(n, ({ k_work_submit(&data->work); }),                               \
-                               ({ k_work_reschedule(&data->work, K_MSEC(5)); }))                   \
+                               ({                                                                  \
+                                   k_work_reschedule(&data->work,                                  \
+                                                     K_MSEC(DT_INST_PROP(n, debounce_period)));    \
+                               }))                                                                 \
         }                                                                                          \
         return 0;                                                                                  \
     }                                                                                              \
@@ -111,6 +136,19 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
         kscan_gpio_read_##n(data->dev);                                                            \
     }                                                                                              \
                                                                                                    \
+    static int kscan_gpio_get_state_##n(const struct device *dev, zmk_kscan_state_cb_t cb,         \
+                                        void *user_data) {                                         \
+        struct kscan_gpio_data_##n *data = dev->data;                                              \
+        for (int r = 0; r < INST_MATRIX_INPUTS(n); r++) {                                          \
+            for (int c = 0; c < INST_MATRIX_OUTPUTS(n); c++) {                                     \
+                if (zmk_debounce_is_pressed(&data->matrix_state[r][c])) {                          \
+                    cb(dev, r, c, user_data);                                                      \
+                }                                                                                  \
+            }                                                                                      \
+        }                                                                                          \
+        return 0;                                                                                  \
+    }                                                                                              \
+                                                                                                   \
     static struct kscan_gpio_data_##n kscan_gpio_data_##n = {};                                    \
                                                                                                    \
     /* KSCAN API configure function */                                                             \
@@ -129,16 +167,36 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
     static int kscan_gpio_enable_##n(const struct device *dev) {                                   \
         LOG_DBG("KSCAN API enable");                                                               \
         struct kscan_gpio_data_##n *data = dev->data;                                              \
+        const struct kscan_gpio_config_##n *cfg = dev->config;                                     \
         /* TODO: we might want a follow up to hook into the sleep state hooks in Zephyr, */        \
         /* and disable this timer when we enter a sleep state */                                   \
-        k_timer_start(&data->poll_timer, K_MSEC(POLL_INTERVAL(n)), K_MSEC(POLL_INTERVAL(n)));      \
+        const int32_t period = cfg->poll_periods_ms[zmk_kscan_cadence_get_tier()];                 \
+        k_timer_start(&data->poll_timer, K_MSEC(period), K_MSEC(period));                          \
+        data->enabled = true;                                                                      \
         return 0;                                                                                  \
     };                                                                                             \
                                                                                                    \
+    static void kscan_gpio_cadence_changed_##n(struct zmk_kscan_cadence_client *client,            \
+                                               enum zmk_kscan_cadence_tier old_tier,               \
+                                               enum zmk_kscan_cadence_tier new_tier) {             \
+        struct kscan_gpio_data_##n *data =                                                         \
+            CONTAINER_OF(client, struct kscan_gpio_data_##n, cadence);                             \
+        const struct kscan_gpio_config_##n *cfg = data->dev->config;                               \
+        const int32_t old_period = cfg->poll_periods_ms[old_tier];                                 \
+        const int32_t period = cfg->poll_periods_ms[new_tier];                                     \
+        if (!data->enabled || period == old_period) {                                              \
+            return;                                                                                \
+        }                                                                                          \
+        /* Poll right away when speeding up instead of waiting out the slow period */              \
+        k_timer_start(&data->poll_timer, period < old_period ? K_NO_WAIT : K_MSEC(period),         \
+                      K_MSEC(period));                                                             \
+    }                                                                                              \
+                                                                                                   \
     /* KSCAN API disable function */                                                               \
     static int kscan_gpio_disable_##n(const struct device *dev) {                                  \
         LOG_DBG("KSCAN API disable");                                                              \
         struct kscan_gpio_data_##n *data = dev->data;                                              \
+        data->enabled = false;                                                                     \
         k_timer_stop(&data->poll_timer);                                                           \
         return 0;                                                                                  \
     };                                                                                             \
@@ -186,6 +244,13 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
                                                                                                    \
         k_timer_init(&data->poll_timer, kscan_gpio_timer_handler, NULL);                           \
                                                                                                    \
+        data->cadence.changed = kscan_gpio_cadence_changed_##n;                                    \
+        zmk_kscan_cadence_register(&data->cadence);                                                \
+                                                                                                   \
+        data->state_provider.dev = dev;                                                            \
+        data->state_provider.get_state = kscan_gpio_get_state_##n;                                 \
+        zmk_kscan_state_register(&data->state_provider);                                           \
+                                                                                                   \
         (CHECK_DEBOUNCE_CFG(n, (k_work_init), (k_work_init_delayable)))(                           \
             &data->work, kscan_gpio_work_handler_##n);                                             \
         return 0;                                                                                  \
@@ -200,6 +265,14 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
     static const struct kscan_gpio_config_##n kscan_gpio_config_##n = {                            \
         .rows = {DT_FOREACH_PROP_ELEM(DT_DRV_INST(n), input_gpios, _KSCAN_GPIO_CFG_INIT)},         \
         .cols = {DT_FOREACH_PROP_ELEM(DT_DRV_INST(n), output_gpios, _KSCAN_GPIO_CFG_INIT)},        \
+        .debounce_config =                                                                         \
+            {                                                                                      \
+                .debounce_press_ms = INST_DEBOUNCE_MS(n, debounce_press_mode),                     \
+                .debounce_release_ms = INST_DEBOUNCE_MS(n, debounce_release_mode),                 \
+                .press_mode = INST_DEBOUNCE_MODE(n, debounce_press_mode),                          \
+                .release_mode = INST_DEBOUNCE_MODE(n, debounce_release_mode),                      \
+            },                                                                                     \
+        .poll_periods_ms = ZMK_KSCAN_CADENCE_DT_INST_POLL_PERIODS(n, polling_interval_msec),       \
     };                                                                                             \
                                                                                                    \
     DEVICE_DT_INST_DEFINE(n, kscan_gpio_init_##n, NULL, &kscan_gpio_data_##n,                      \
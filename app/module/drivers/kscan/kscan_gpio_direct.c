@@ -16,6 +16,9 @@
 #include <zephyr/sys/util.h>
 
 #include <zmk/debounce.h>
+#include <zmk/kscan_cadence.h>
+#include <zmk/kscan_coordinator.h>
+#include <zmk/kscan_state.h>
 
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
@@ -35,6 +38,11 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
     DT_INST_PROP_OR(n, debounce_period, DT_INST_PROP(n, debounce_release_ms))
 #endif
 
+#define INST_DEBOUNCE_PRESS_MODE(n)                                                                \
+    ((enum zmk_debounce_mode)DT_INST_ENUM_IDX(n, debounce_press_mode))
+#define INST_DEBOUNCE_RELEASE_MODE(n)                                                              \
+    ((enum zmk_debounce_mode)DT_INST_ENUM_IDX(n, debounce_release_mode))
+
 #define USE_POLLING IS_ENABLED(CONFIG_ZMK_KSCAN_DIRECT_POLLING)
 #define USE_INTERRUPTS (!USE_POLLING)
 
@@ -67,6 +75,14 @@ struct kscan_direct_data {
 #endif
     /** Timestamp of the current or scheduled scan. */
     int64_t scan_time;
+    /** Lets a composite kscan run this driver's scans along with its other children. */
+    struct zmk_kscan_coordinator_client coordinator;
+    struct zmk_kscan_state_provider state_provider;
+#if USE_POLLING
+    struct zmk_kscan_cadence_client cadence;
+    /** Whether the scheduled scan is a poll for the first key press. */
+    bool poll_idle;
+#endif
     /** Current state of the inputs as an array of length config->inputs.len */
     struct zmk_debounce_state *pin_state;
 };
@@ -74,7 +90,8 @@ struct kscan_direct_data {
 struct kscan_direct_config {
     struct zmk_debounce_config debounce_config;
     int32_t debounce_scan_period_ms;
-    int32_t poll_period_ms;
+    /** Time between scans with no key pressed for each cadence tier, when polling. */
+    int32_t poll_periods_ms[ZMK_KSCAN_CADENCE_TIER_COUNT];
     bool toggle_mode;
 };
 
@@ -108,6 +125,19 @@ static int kscan_direct_interrupt_disable(const struct device *dev) {
 }
 #endif
 
+/**
+ * Schedules a scan at data->scan_time. If a composite kscan coordinates this driver, the scan
+ * instead runs from the composite's work item along with any other scans due then.
+ */
+static void kscan_direct_schedule(const struct device *dev, const k_timeout_t timeout,
+                                  const bool idle) {
+    struct kscan_direct_data *data = dev->data;
+
+    if (zmk_kscan_coordinator_schedule(&data->coordinator, data->scan_time, idle) != 0) {
+        k_work_reschedule(&data->work, timeout);
+    }
+}
+
 #if USE_INTERRUPTS
 static void kscan_direct_irq_callback_handler(const struct device *port, struct gpio_callback *cb,
                                               const gpio_port_pins_t pin) {
@@ -120,7 +150,7 @@ static void kscan_direct_irq_callback_handler(const struct device *port, struct
 
     data->scan_time = k_uptime_get();
 
-    k_work_reschedule(&data->work, K_NO_WAIT);
+    kscan_direct_schedule(data->dev, K_NO_WAIT, false);
 }
 #endif
 
@@ -154,8 +184,11 @@ static void kscan_direct_read_continue(const struct device *dev) {
     struct kscan_direct_data *data = dev->data;
 
     data->scan_time += config->debounce_scan_period_ms;
+#if USE_POLLING
+    data->poll_idle = false;
+#endif
 
-    k_work_reschedule(&data->work, K_TIMEOUT_ABS_MS(data->scan_time));
+    kscan_direct_schedule(dev, K_TIMEOUT_ABS_MS(data->scan_time), false);
 }
 
 static void kscan_direct_read_end(const struct device *dev) {
@@ -166,13 +199,29 @@ static void kscan_direct_read_end(const struct device *dev) {
     struct kscan_direct_data *data = dev->data;
     const struct kscan_direct_config *config = dev->config;
 
-    data->scan_time += config->poll_period_ms;
+    data->scan_time += config->poll_periods_ms[zmk_kscan_cadence_get_tier()];
+    data->poll_idle = true;
 
     // Return to polling slowly.
-    k_work_reschedule(&data->work, K_TIMEOUT_ABS_MS(data->scan_time));
+    kscan_direct_schedule(dev, K_TIMEOUT_ABS_MS(data->scan_time), true);
 #endif
 }
 
+#if USE_POLLING
+static void kscan_direct_cadence_changed(struct zmk_kscan_cadence_client *client,
+                                         enum zmk_kscan_cadence_tier old_tier,
+                                         enum zmk_kscan_cadence_tier new_tier) {
+    struct kscan_direct_data *data = CONTAINER_OF(client, struct kscan_direct_data, cadence);
+    const struct kscan_direct_config *config = data->dev->config;
+
+    // Don't wait out a slow poll once things speed up.
+    if (data->poll_idle && config->poll_periods_ms[new_tier] < config->poll_periods_ms[old_tier]) {
+        data->scan_time = k_uptime_get();
+        kscan_direct_schedule(data->dev, K_NO_WAIT, true);
+    }
+}
+#endif
+
 static int kscan_direct_read(const struct device *dev) {
     struct kscan_direct_data *data = dev->data;
     const struct kscan_direct_config *config = dev->config;
@@ -231,6 +280,29 @@ static void kscan_direct_work_handler(struct k_work *work) {
     kscan_direct_read(data->dev);
 }
 
+static void kscan_direct_coordinated_scan(struct zmk_kscan_coordinator_client *client,
+                                          const int64_t scan_time) {
+    struct kscan_direct_data *data = CONTAINER_OF(client, struct kscan_direct_data, coordinator);
+
+    data->scan_time = scan_time;
+    kscan_direct_read(data->dev);
+}
+
+static int kscan_direct_get_state(const struct device *dev, const zmk_kscan_state_cb_t cb,
+                                  void *user_data) {
+    struct kscan_direct_data *data = dev->data;
+
+    for (int i = 0; i < data->inputs.len; i++) {
+        const int index = data->inputs.gpios[i].index;
+
+        if (zmk_debounce_is_pressed(&data->pin_state[index])) {
+            cb(dev, 0, index, user_data);
+        }
+    }
+
+    return 0;
+}
+
 static int kscan_direct_configure(const struct device *dev, kscan_callback_t callback) {
     struct kscan_direct_data *data = dev->data;
 
@@ -255,10 +327,12 @@ static int kscan_direct_disable(const struct device *dev) {
     struct kscan_direct_data *data = dev->data;
 
     k_work_cancel_delayable(&data->work);
+    zmk_kscan_coordinator_cancel(&data->coordinator);
 
 #if USE_INTERRUPTS
     return kscan_direct_interrupt_disable(dev);
 #else
+    data->poll_idle = false;
     return 0;
 #endif
 }
@@ -337,6 +411,19 @@ static int kscan_direct_init(const struct device *dev) {
 
     k_work_init_delayable(&data->work, kscan_direct_work_handler);
 
+    data->coordinator.dev = dev;
+    data->coordinator.scan = kscan_direct_coordinated_scan;
+    zmk_kscan_coordinator_register(&data->coordinator);
+
+    data->state_provider.dev = dev;
+    data->state_provider.get_state = kscan_direct_get_state;
+    zmk_kscan_state_register(&data->state_provider);
+
+#if USE_POLLING
+    data->cadence.changed = kscan_direct_cadence_changed;
+    zmk_kscan_cadence_register(&data->cadence);
+#endif
+
 #if IS_ENABLED(CONFIG_PM_DEVICE)
     pm_device_init_suspended(dev);
 
@@ -402,9 +489,11 @@ static const struct kscan_driver_api kscan_direct_api = {
             {                                                                                      \
                 .debounce_press_ms = INST_DEBOUNCE_PRESS_MS(n),                                    \
                 .debounce_release_ms = INST_DEBOUNCE_RELEASE_MS(n),                                \
+                .press_mode = INST_DEBOUNCE_PRESS_MODE(n),                                         \
+                .release_mode = INST_DEBOUNCE_RELEASE_MODE(n),                                     \
             },                                                                                     \
         .debounce_scan_period_ms = DT_INST_PROP(n, debounce_scan_period_ms),                       \
-        .poll_period_ms = DT_INST_PROP(n, poll_period_ms),                                         \
+        .poll_periods_ms = ZMK_KSCAN_CADENCE_DT_INST_POLL_PERIODS(n, poll_period_ms),              \
         .toggle_mode = DT_INST_PROP(n, toggle_mode),                                               \
     };                                                                                             \
                                                                                                    \
@@ -17,6 +17,9 @@
 #include <zephyr/sys/util.h>
 
 #include <zmk/debounce.h>
+#include <zmk/kscan_cadence.h>
+#include <zmk/kscan_coordinator.h>
+#include <zmk/kscan_state.h>
 
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
@@ -30,6 +33,7 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 #define INST_COLS_LEN(n) DT_INST_PROP_LEN(n, col_gpios)
 #define INST_MATRIX_LEN(n) (INST_ROWS_LEN(n) * INST_COLS_LEN(n))
 #define INST_INPUTS_LEN(n) COND_DIODE_DIR(n, (INST_COLS_LEN(n)), (INST_ROWS_LEN(n)))
+#define INST_OUTPUTS_LEN(n) COND_DIODE_DIR(n, (INST_ROWS_LEN(n)), (INST_COLS_LEN(n)))
 
 #if CONFIG_ZMK_KSCAN_DEBOUNCE_PRESS_MS >= 0
 #define INST_DEBOUNCE_PRESS_MS(n) CONFIG_ZMK_KSCAN_DEBOUNCE_PRESS_MS
@@ -45,6 +49,11 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
     DT_INST_PROP_OR(n, debounce_period, DT_INST_PROP(n, debounce_release_ms))
 #endif
 
+#define INST_DEBOUNCE_PRESS_MODE(n)                                                                \
+    ((enum zmk_debounce_mode)DT_INST_ENUM_IDX(n, debounce_press_mode))
+#define INST_DEBOUNCE_RELEASE_MODE(n)                                                              \
+    ((enum zmk_debounce_mode)DT_INST_ENUM_IDX(n, debounce_release_mode))
+
 #define USE_POLLING IS_ENABLED(CONFIG_ZMK_KSCAN_MATRIX_POLLING)
 #define USE_INTERRUPTS (!USE_POLLING)
 
@@ -67,9 +76,29 @@ struct kscan_matrix_irq_callback {
     struct gpio_callback callback;
 };
 
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_MATRIX_SCAN_STATS)
+struct kscan_matrix_scan_stats {
+    uint32_t scans;
+    uint32_t port_reads;
+    uint32_t debounce_updates;
+    uint32_t cycles;
+};
+#endif
+
 struct kscan_matrix_data {
     const struct device *dev;
     struct kscan_gpio_list inputs;
+    /** The port all inputs are on, or NULL if they are spread over several ports. */
+    const struct device *inputs_port;
+    /** Pins of inputs_port used as inputs. */
+    gpio_port_pins_t inputs_mask;
+    /** Devicetree index of the input on each pin of inputs_port. */
+    uint8_t input_index_by_pin[GPIO_MAX_PINS_PER_PORT];
+    /**
+     * Debounce state for the keys on each output when inputs_port is set, as an array of length
+     * config->outputs.len. Each bit is the key on the input with that pin number.
+     */
+    struct zmk_debounce_row *debounce_rows;
     kscan_callback_t callback;
     struct k_work_delayable work;
 #if USE_INTERRUPTS
@@ -78,20 +107,34 @@ struct kscan_matrix_data {
 #endif
     /** Timestamp of the current or scheduled scan. */
     int64_t scan_time;
+    /** Lets a composite kscan run this driver's scans along with its other children. */
+    struct zmk_kscan_coordinator_client coordinator;
+    struct zmk_kscan_state_provider state_provider;
+#if USE_POLLING
+    struct zmk_kscan_cadence_client cadence;
+    /** Whether the scheduled scan is a poll for the first key press. */
+    bool poll_idle;
+#endif
     /**
      * Current state of the matrix as a flattened 2D array of length
      * (config->rows * config->cols)
      */
     struct zmk_debounce_state *matrix_state;
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_MATRIX_SCAN_STATS)
+    /** Totals since the matrix last went idle. */
+    struct kscan_matrix_scan_stats stats;
+#endif
 };
 
 struct kscan_matrix_config {
     struct kscan_gpio_list outputs;
     struct zmk_debounce_config debounce_config;
+    struct zmk_debounce_row_config debounce_row_config;
     size_t rows;
     size_t cols;
     int32_t debounce_scan_period_ms;
-    int32_t poll_period_ms;
+    /** Time between scans with no key pressed for each cadence tier, when polling. */
+    int32_t poll_periods_ms[ZMK_KSCAN_CADENCE_TIER_COUNT];
     enum kscan_diode_direction diode_direction;
 };
 
@@ -175,6 +218,19 @@ static int kscan_matrix_interrupt_disable(const struct device *dev) {
 }
 #endif
 
+/**
+ * Schedules a scan at data->scan_time. If a composite kscan coordinates this driver, the scan
+ * instead runs from the composite's work item along with any other scans due then.
+ */
+static void kscan_matrix_schedule(const struct device *dev, const k_timeout_t timeout,
+                                  const bool idle) {
+    struct kscan_matrix_data *data = dev->data;
+
+    if (zmk_kscan_coordinator_schedule(&data->coordinator, data->scan_time, idle) != 0) {
+        k_work_reschedule(&data->work, timeout);
+    }
+}
+
 #if USE_INTERRUPTS
 static void kscan_matrix_irq_callback_handler(const struct device *port, struct gpio_callback *cb,
                                               const gpio_port_pins_t pin) {
@@ -187,7 +243,7 @@ static void kscan_matrix_irq_callback_handler(const struct device *port, struct
 
     data->scan_time = k_uptime_get();
 
-    k_work_reschedule(&data->work, K_NO_WAIT);
+    kscan_matrix_schedule(data->dev, K_NO_WAIT, false);
 }
 #endif
 
@@ -196,8 +252,11 @@ static void kscan_matrix_read_continue(const struct device *dev) {
     struct kscan_matrix_data *data = dev->data;
 
     data->scan_time += config->debounce_scan_period_ms;
+#if USE_POLLING
+    data->poll_idle = false;
+#endif
 
-    k_work_reschedule(&data->work, K_TIMEOUT_ABS_MS(data->scan_time));
+    kscan_matrix_schedule(dev, K_TIMEOUT_ABS_MS(data->scan_time), false);
 }
 
 static void kscan_matrix_read_end(const struct device *dev) {
@@ -208,17 +267,174 @@ static void kscan_matrix_read_end(const struct device *dev) {
     struct kscan_matrix_data *data = dev->data;
     const struct kscan_matrix_config *config = dev->config;
 
-    data->scan_time += config->poll_period_ms;
+    data->scan_time += config->poll_periods_ms[zmk_kscan_cadence_get_tier()];
+    data->poll_idle = true;
 
     // Return to polling slowly.
-    k_work_reschedule(&data->work, K_TIMEOUT_ABS_MS(data->scan_time));
+    kscan_matrix_schedule(dev, K_TIMEOUT_ABS_MS(data->scan_time), true);
+#endif
+}
+
+#if USE_POLLING
+static void kscan_matrix_cadence_changed(struct zmk_kscan_cadence_client *client,
+                                         enum zmk_kscan_cadence_tier old_tier,
+                                         enum zmk_kscan_cadence_tier new_tier) {
+    struct kscan_matrix_data *data = CONTAINER_OF(client, struct kscan_matrix_data, cadence);
+    const struct kscan_matrix_config *config = data->dev->config;
+
+    // Don't wait out a slow poll once things speed up. Scans while a key is active are already
+    // quick, and a slow down takes effect from the next poll.
+    if (data->poll_idle && config->poll_periods_ms[new_tier] < config->poll_periods_ms[old_tier]) {
+        data->scan_time = k_uptime_get();
+        kscan_matrix_schedule(data->dev, K_NO_WAIT, true);
+    }
+}
+#endif
+
+/**
+ * Read the inputs for the active output one pin at a time, debouncing every key on the output.
+ */
+static int kscan_matrix_read_inputs_by_pin(const struct device *dev,
+                                           const struct kscan_gpio *out_gpio) {
+    struct kscan_matrix_data *data = dev->data;
+    const struct kscan_matrix_config *config = dev->config;
+    struct kscan_gpio_port_state state = {0};
+
+    for (int j = 0; j < data->inputs.len; j++) {
+        const struct kscan_gpio *in_gpio = &data->inputs.gpios[j];
+
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_MATRIX_SCAN_STATS)
+        if (in_gpio->spec.port != state.port) {
+            data->stats.port_reads++;
+        }
+        data->stats.debounce_updates++;
 #endif
+
+        const int index = state_index_io(config, in_gpio->index, out_gpio->index);
+        const int active = kscan_gpio_pin_get(in_gpio, &state);
+        if (active < 0) {
+            LOG_ERR("Failed to read port %s: %i", in_gpio->spec.port->name, active);
+            return active;
+        }
+
+        zmk_debounce_update(&data->matrix_state[index], active, config->debounce_scan_period_ms,
+                            &config->debounce_config);
+    }
+
+    return 0;
+}
+
+/**
+ * Read all inputs for the active output with one port read and debounce them together.
+ */
+static int kscan_matrix_read_inputs_by_port(const struct device *dev,
+                                            const struct kscan_gpio *out_gpio) {
+    struct kscan_matrix_data *data = dev->data;
+    const struct kscan_matrix_config *config = dev->config;
+    gpio_port_value_t value;
+
+    const int err = gpio_port_get(data->inputs_port, &value);
+    if (err) {
+        LOG_ERR("Failed to read port %s: %i", data->inputs_port->name, err);
+        return err;
+    }
+
+    zmk_debounce_row_update(&data->debounce_rows[out_gpio->index], value & data->inputs_mask,
+                            &config->debounce_row_config);
+
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_MATRIX_SCAN_STATS)
+    data->stats.port_reads++;
+    data->stats.debounce_updates++;
+#endif
+
+    return 0;
+}
+
+/**
+ * Send events for keys changed in the last port-wide scan.
+ * @return whether any key is still active.
+ */
+static bool kscan_matrix_process_by_port(const struct device *dev) {
+    struct kscan_matrix_data *data = dev->data;
+    const struct kscan_matrix_config *config = dev->config;
+    bool continue_scan = false;
+
+    for (int i = 0; i < config->outputs.len; i++) {
+        const int output_idx = config->outputs.gpios[i].index;
+        const struct zmk_debounce_row *row = &data->debounce_rows[output_idx];
+        uint32_t changed = row->changed;
+
+        while (changed) {
+            const int pin = __builtin_ctz(changed);
+            changed &= changed - 1;
+
+            const int input_idx = data->input_index_by_pin[pin];
+            const int r = config->diode_direction == KSCAN_ROW2COL ? output_idx : input_idx;
+            const int c = config->diode_direction == KSCAN_ROW2COL ? input_idx : output_idx;
+            const bool pressed = (row->pressed & BIT(pin)) != 0;
+
+            LOG_DBG("Sending event at %i,%i state %s", r, c, pressed ? "on" : "off");
+            data->callback(dev, r, c, pressed);
+        }
+
+        continue_scan = continue_scan || zmk_debounce_row_get_active(row);
+    }
+
+    return continue_scan;
+}
+
+/**
+ * Send events for keys changed in the last pin by pin scan.
+ * @return whether any key is still active.
+ */
+static bool kscan_matrix_process_by_pin(const struct device *dev) {
+    struct kscan_matrix_data *data = dev->data;
+    const struct kscan_matrix_config *config = dev->config;
+    bool continue_scan = false;
+
+    for (int r = 0; r < config->rows; r++) {
+        for (int c = 0; c < config->cols; c++) {
+            const int index = state_index_rc(config, r, c);
+            struct zmk_debounce_state *state = &data->matrix_state[index];
+
+            if (zmk_debounce_get_changed(state)) {
+                const bool pressed = zmk_debounce_is_pressed(state);
+
+                LOG_DBG("Sending event at %i,%i state %s", r, c, pressed ? "on" : "off");
+                data->callback(dev, r, c, pressed);
+            }
+
+            continue_scan = continue_scan || zmk_debounce_is_active(state);
+        }
+    }
+
+    return continue_scan;
+}
+
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_MATRIX_SCAN_STATS)
+static void kscan_matrix_log_stats(const struct device *dev) {
+    struct kscan_matrix_data *data = dev->data;
+    const struct kscan_matrix_scan_stats *stats = &data->stats;
+
+    LOG_DBG("%s: %u scans, %u port reads and %u debounce updates per scan, %u us per scan",
+            data->inputs_port ? "port" : "pin", stats->scans, stats->port_reads / stats->scans,
+            stats->debounce_updates / stats->scans,
+            k_cyc_to_us_floor32(stats->cycles) / stats->scans);
+
+    data->stats = (struct kscan_matrix_scan_stats){0};
 }
+#endif
 
 static int kscan_matrix_read(const struct device *dev) {
     struct kscan_matrix_data *data = dev->data;
     const struct kscan_matrix_config *config = dev->config;
 
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_MATRIX_SCAN_STATS)
+    LOG_DBG("%s: scan at %lld ms", dev->name, data->scan_time);
+
+    const uint32_t start = k_cycle_get_32();
+#endif
+
     // Scan the matrix.
     for (int i = 0; i < config->outputs.len; i++) {
         const struct kscan_gpio *out_gpio = &config->outputs.gpios[i];
@@ -232,20 +448,11 @@ static int kscan_matrix_read(const struct device *dev) {
 #if CONFIG_ZMK_KSCAN_MATRIX_WAIT_BEFORE_INPUTS > 0
         k_busy_wait(CONFIG_ZMK_KSCAN_MATRIX_WAIT_BEFORE_INPUTS);
 #endif
-        struct kscan_gpio_port_state state = {0};
-
-        for (int j = 0; j < data->inputs.len; j++) {
-            const struct kscan_gpio *in_gpio = &data->inputs.gpios[j];
 
-            const int index = state_index_io(config, in_gpio->index, out_gpio->index);
-            const int active = kscan_gpio_pin_get(in_gpio, &state);
-            if (active < 0) {
-                LOG_ERR("Failed to read port %s: %i", in_gpio->spec.port->name, active);
-                return active;
-            }
-
-            zmk_debounce_update(&data->matrix_state[index], active, config->debounce_scan_period_ms,
-                                &config->debounce_config);
+        err = data->inputs_port ? kscan_matrix_read_inputs_by_port(dev, out_gpio)
+                                : kscan_matrix_read_inputs_by_pin(dev, out_gpio);
+        if (err) {
+            return err;
         }
 
         err = gpio_pin_set_dt(&out_gpio->spec, 0);
@@ -260,29 +467,23 @@ static int kscan_matrix_read(const struct device *dev) {
     }
 
     // Process the new state.
-    bool continue_scan = false;
-
-    for (int r = 0; r < config->rows; r++) {
-        for (int c = 0; c < config->cols; c++) {
-            const int index = state_index_rc(config, r, c);
-            struct zmk_debounce_state *state = &data->matrix_state[index];
-
-            if (zmk_debounce_get_changed(state)) {
-                const bool pressed = zmk_debounce_is_pressed(state);
+    const bool continue_scan =
+        data->inputs_port ? kscan_matrix_process_by_port(dev) : kscan_matrix_process_by_pin(dev);
 
-                LOG_DBG("Sending event at %i,%i state %s", r, c, pressed ? "on" : "off");
-                data->callback(dev, r, c, pressed);
-            }
-
-            continue_scan = continue_scan || zmk_debounce_is_active(state);
-        }
-    }
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_MATRIX_SCAN_STATS)
+    data->stats.cycles += k_cycle_get_32() - start;
+    data->stats.scans++;
+#endif
 
     if (continue_scan) {
         // At least one key is pressed or the debouncer has not yet decided if
         // it is pressed. Poll quickly until everything is released.
         kscan_matrix_read_continue(dev);
     } else {
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_MATRIX_SCAN_STATS)
+        kscan_matrix_log_stats(dev);
+#endif
+
         // All keys are released. Return to normal.
         kscan_matrix_read_end(dev);
     }
@@ -296,6 +497,50 @@ static void kscan_matrix_work_handler(struct k_work *work) {
     kscan_matrix_read(data->dev);
 }
 
+static void kscan_matrix_coordinated_scan(struct zmk_kscan_coordinator_client *client,
+                                          const int64_t scan_time) {
+    struct kscan_matrix_data *data = CONTAINER_OF(client, struct kscan_matrix_data, coordinator);
+
+    data->scan_time = scan_time;
+    kscan_matrix_read(data->dev);
+}
+
+static int kscan_matrix_get_state(const struct device *dev, const zmk_kscan_state_cb_t cb,
+                                  void *user_data) {
+    struct kscan_matrix_data *data = dev->data;
+    const struct kscan_matrix_config *config = dev->config;
+
+    if (data->inputs_port) {
+        for (int i = 0; i < config->outputs.len; i++) {
+            const int output_idx = config->outputs.gpios[i].index;
+            uint32_t pressed = data->debounce_rows[output_idx].pressed;
+
+            while (pressed) {
+                const int pin = __builtin_ctz(pressed);
+                pressed &= pressed - 1;
+
+                const int input_idx = data->input_index_by_pin[pin];
+                const int r = config->diode_direction == KSCAN_ROW2COL ? output_idx : input_idx;
+                const int c = config->diode_direction == KSCAN_ROW2COL ? input_idx : output_idx;
+
+                cb(dev, r, c, user_data);
+            }
+        }
+
+        return 0;
+    }
+
+    for (int r = 0; r < config->rows; r++) {
+        for (int c = 0; c < config->cols; c++) {
+            if (zmk_debounce_is_pressed(&data->matrix_state[state_index_rc(config, r, c)])) {
+                cb(dev, r, c, user_data);
+            }
+        }
+    }
+
+    return 0;
+}
+
 static int kscan_matrix_configure(const struct device *dev, const kscan_callback_t callback) {
     struct kscan_matrix_data *data = dev->data;
 
@@ -320,10 +565,12 @@ static int kscan_matrix_disable(const struct device *dev) {
     struct kscan_matrix_data *data = dev->data;
 
     k_work_cancel_delayable(&data->work);
+    zmk_kscan_coordinator_cancel(&data->coordinator);
 
 #if USE_INTERRUPTS
     return kscan_matrix_interrupt_disable(dev);
 #else
+    data->poll_idle = false;
     return 0;
 #endif
 }
@@ -451,8 +698,34 @@ static int kscan_matrix_init(const struct device *dev) {
     // Sort inputs by port so we can read each port just once per scan.
     kscan_gpio_list_sort_by_port(&data->inputs);
 
+    // With every input on one port, a single read gets the whole output's keys at once.
+    const struct device *first_port = data->inputs.gpios[0].spec.port;
+    if (first_port == data->inputs.gpios[data->inputs.len - 1].spec.port) {
+        data->inputs_port = first_port;
+
+        for (int i = 0; i < data->inputs.len; i++) {
+            const struct kscan_gpio *gpio = &data->inputs.gpios[i];
+
+            data->inputs_mask |= BIT(gpio->spec.pin);
+            data->input_index_by_pin[gpio->spec.pin] = gpio->index;
+        }
+    }
+
     k_work_init_delayable(&data->work, kscan_matrix_work_handler);
 
+    data->coordinator.dev = dev;
+    data->coordinator.scan = kscan_matrix_coordinated_scan;
+    zmk_kscan_coordinator_register(&data->coordinator);
+
+    data->state_provider.dev = dev;
+    data->state_provider.get_state = kscan_matrix_get_state;
+    zmk_kscan_state_register(&data->state_provider);
+
+#if USE_POLLING
+    data->cadence.changed = kscan_matrix_cadence_changed;
+    zmk_kscan_cadence_register(&data->cadence);
+#endif
+
 #if IS_ENABLED(CONFIG_PM_DEVICE)
     pm_device_init_suspended(dev);
 
@@ -506,6 +779,8 @@ static const struct kscan_driver_api kscan_matrix_api = {
                                                                                                    \
     static struct zmk_debounce_state kscan_matrix_state_##n[INST_MATRIX_LEN(n)];                   \
                                                                                                    \
+    static struct zmk_debounce_row kscan_matrix_debounce_rows_##n[INST_OUTPUTS_LEN(n)];            \
+                                                                                                   \
     COND_INTERRUPTS(                                                                               \
         (static struct kscan_matrix_irq_callback kscan_matrix_irqs_##n[INST_INPUTS_LEN(n)];))      \
                                                                                                    \
@@ -513,6 +788,7 @@ static const struct kscan_driver_api kscan_matrix_api = {
         .inputs =                                                                                  \
             KSCAN_GPIO_LIST(COND_DIODE_DIR(n, (kscan_matrix_cols_##n), (kscan_matrix_rows_##n))),  \
         .matrix_state = kscan_matrix_state_##n,                                                    \
+        .debounce_rows = kscan_matrix_debounce_rows_##n,                                           \
         COND_INTERRUPTS((.irqs = kscan_matrix_irqs_##n, ))};                                       \
                                                                                                    \
     static const struct kscan_matrix_config kscan_matrix_config_##n = {                            \
@@ -524,9 +800,16 @@ static const struct kscan_driver_api kscan_matrix_api = {
             {                                                                                      \
                 .debounce_press_ms = INST_DEBOUNCE_PRESS_MS(n),                                    \
                 .debounce_release_ms = INST_DEBOUNCE_RELEASE_MS(n),                                \
+                .press_mode = INST_DEBOUNCE_PRESS_MODE(n),                                         \
+                .release_mode = INST_DEBOUNCE_RELEASE_MODE(n),                                     \
             },                                                                                     \
+        .debounce_row_config = ZMK_DEBOUNCE_ROW_CONFIG(INST_DEBOUNCE_PRESS_MS(n),                  \
+                                                       INST_DEBOUNCE_RELEASE_MS(n),                \
+                                                       DT_INST_PROP(n, debounce_scan_period_ms),   \
+                                                       INST_DEBOUNCE_PRESS_MODE(n),                \
+                                                       INST_DEBOUNCE_RELEASE_MODE(n)),             \
         .debounce_scan_period_ms = DT_INST_PROP(n, debounce_scan_period_ms),                       \
-        .poll_period_ms = DT_INST_PROP(n, poll_period_ms),                                         \
+        .poll_periods_ms = ZMK_KSCAN_CADENCE_DT_INST_POLL_PERIODS(n, poll_period_ms),              \
         .diode_direction = INST_DIODE_DIR(n),                                                      \
     };                                                                                             \
                                                                                                    \
@@ -15,6 +15,24 @@
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
 #include <dt-bindings/zmk/kscan_mock.h>
+#include <zmk/debounce.h>
+#include <zmk/kscan_state.h>
+
+/**
+ * With debounce-scan-period-ms set, events are raw switch edges instead of reported key changes.
+ * They are scanned and debounced like a GPIO kscan driver would, so tests can replay bouncy
+ * switches and check what gets reported.
+ */
+struct kscan_mock_debounce_config {
+    const uint32_t *events;
+    size_t events_len;
+    uint8_t columns;
+    size_t keys;
+    struct zmk_debounce_config debounce_config;
+    /** Time between scans while any key is active, or 0 to report events directly. */
+    int32_t scan_period_ms;
+    bool exit_after;
+};
 
 struct kscan_mock_data {
     kscan_callback_t callback;
@@ -22,6 +40,15 @@ struct kscan_mock_data {
     uint32_t event_index;
     struct k_work_delayable work;
     const struct device *dev;
+
+    bool *raw;
+    struct zmk_debounce_state *debounce_states;
+    int64_t start_time;
+    int64_t scan_time;
+    int64_t next_edge_time;
+    bool exiting;
+
+    struct zmk_kscan_state_provider state_provider;
 };
 
 static int kscan_mock_disable_callback(const struct device *dev) {
@@ -44,10 +71,100 @@ static int kscan_mock_configure(const struct device *dev, kscan_callback_t callb
     return 0;
 }
 
+static void kscan_mock_debounce_start(struct kscan_mock_data *data,
+                                      const struct kscan_mock_debounce_config *cfg) {
+    data->start_time = k_uptime_get();
+    data->scan_time = data->start_time;
+    data->exiting = false;
+
+    if (cfg->events_len > 0) {
+        // Sleep until the first edge, like an interrupt driven kscan
+        data->next_edge_time = data->start_time + ZMK_MOCK_MSEC(cfg->events[0]);
+        data->scan_time = data->next_edge_time;
+    }
+
+    k_work_schedule(&data->work, K_TIMEOUT_ABS_MS(data->scan_time));
+}
+
+static void kscan_mock_debounce_scan(struct kscan_mock_data *data,
+                                     const struct kscan_mock_debounce_config *cfg) {
+    if (data->exiting) {
+        LOG_DBG("Exiting");
+        exit(0);
+    }
+
+    // A scan only sees the latest level of each switch, so edges between scans are lost just
+    // like with real hardware.
+    while (data->event_index < cfg->events_len && data->next_edge_time <= data->scan_time) {
+        const uint32_t ev = cfg->events[data->event_index++];
+        data->raw[ZMK_MOCK_ROW(ev) * cfg->columns + ZMK_MOCK_COL(ev)] = ZMK_MOCK_IS_PRESS(ev);
+
+        if (data->event_index < cfg->events_len) {
+            data->next_edge_time += ZMK_MOCK_MSEC(cfg->events[data->event_index]);
+        }
+    }
+
+    bool continue_scan = false;
+
+    for (size_t i = 0; i < cfg->keys; i++) {
+        struct zmk_debounce_state *state = &data->debounce_states[i];
+        zmk_debounce_update(state, data->raw[i], cfg->scan_period_ms, &cfg->debounce_config);
+
+        if (zmk_debounce_get_changed(state)) {
+            const int row = i / cfg->columns;
+            const int col = i % cfg->columns;
+            const bool pressed = zmk_debounce_is_pressed(state);
+
+            LOG_DBG("Debounced %d,%d %s at %lld ms", row, col, pressed ? "on" : "off",
+                    data->scan_time - data->start_time);
+            data->callback(data->dev, row, col, pressed);
+        }
+
+        continue_scan = continue_scan || zmk_debounce_is_active(state);
+    }
+
+    if (continue_scan) {
+        data->scan_time += cfg->scan_period_ms;
+    } else if (data->event_index < cfg->events_len) {
+        data->scan_time = data->next_edge_time;
+    } else if (cfg->exit_after) {
+        // Leave time for the last reported change to be processed
+        data->scan_time += cfg->scan_period_ms;
+        data->exiting = true;
+    } else {
+        return;
+    }
+
+    k_work_schedule(&data->work, K_TIMEOUT_ABS_MS(data->scan_time));
+}
+
+static int kscan_mock_debounce_get_state(const struct device *dev,
+                                         const struct kscan_mock_debounce_config *cfg,
+                                         zmk_kscan_state_cb_t cb, void *user_data) {
+    struct kscan_mock_data *data = dev->data;
+
+    // Without debouncing, the events are reported as they come and there is no state to list.
+    if (cfg->scan_period_ms == 0) {
+        return -ENOTSUP;
+    }
+
+    for (size_t i = 0; i < cfg->keys; i++) {
+        if (zmk_debounce_is_pressed(&data->debounce_states[i])) {
+            cb(dev, i / cfg->columns, i % cfg->columns, user_data);
+        }
+    }
+
+    return 0;
+}
+
+#define MOCK_INST_DEBOUNCE(n) DT_INST_NODE_HAS_PROP(n, debounce_scan_period_ms)
+#define MOCK_INST_KEYS(n) (DT_INST_PROP_OR(n, rows, 1) * DT_INST_PROP_OR(n, columns, 1))
+
 #define MOCK_INST_INIT(n)                                                                          \
     struct kscan_mock_config_##n {                                                                 \
         uint32_t events[DT_INST_PROP_LEN(n, events)];                                              \
         bool exit_after;                                                                           \
+        struct kscan_mock_debounce_config debounce;                                                \
     };                                                                                             \
     static void kscan_mock_schedule_next_event_##n(const struct device *dev) {                     \
         struct kscan_mock_data *data = dev->data;                                                  \
@@ -65,6 +182,10 @@ static int kscan_mock_configure(const struct device *dev, kscan_callback_t callb
         struct k_work_delayable *d_work = k_work_delayable_from_work(work);                        \
         struct kscan_mock_data *data = CONTAINER_OF(d_work, struct kscan_mock_data, work);         \
         const struct kscan_mock_config_##n *cfg = data->dev->config;                               \
+        if (cfg->debounce.scan_period_ms > 0) {                                                    \
+            kscan_mock_debounce_scan(data, &cfg->debounce);                                        \
+            return;                                                                                \
+        }                                                                                          \
         if (data->event_index >= DT_INST_PROP_LEN(n, events)) {                                    \
             if (cfg->exit_after)                                                                   \
                 exit(0);                                                                           \
@@ -78,13 +199,26 @@ static int kscan_mock_configure(const struct device *dev, kscan_callback_t callb
         kscan_mock_schedule_next_event_##n(data->dev);                                             \
         data->event_index++;                                                                       \
     }                                                                                              \
+    static int kscan_mock_get_state_##n(const struct device *dev, zmk_kscan_state_cb_t cb,         \
+                                        void *user_data) {                                         \
+        const struct kscan_mock_config_##n *cfg = dev->config;                                     \
+        return kscan_mock_debounce_get_state(dev, &cfg->debounce, cb, user_data);                  \
+    }                                                                                              \
     static int kscan_mock_init_##n(const struct device *dev) {                                     \
         struct kscan_mock_data *data = dev->data;                                                  \
         data->dev = dev;                                                                           \
         k_work_init_delayable(&data->work, kscan_mock_work_handler_##n);                           \
+        data->state_provider.dev = dev;                                                            \
+        data->state_provider.get_state = kscan_mock_get_state_##n;                                 \
+        zmk_kscan_state_register(&data->state_provider);                                           \
         return 0;                                                                                  \
     }                                                                                              \
     static int kscan_mock_enable_callback_##n(const struct device *dev) {                          \
+        const struct kscan_mock_config_##n *cfg = dev->config;                                     \
+        if (cfg->debounce.scan_period_ms > 0) {                                                    \
+            kscan_mock_debounce_start(dev->data, &cfg->debounce);                                  \
+            return 0;                                                                              \
+        }                                                                                          \
         kscan_mock_schedule_next_event_##n(dev);                                                   \
         return 0;                                                                                  \
     }                                                                                              \
@@ -93,9 +227,34 @@ static int kscan_mock_configure(const struct device *dev, kscan_callback_t callb
         .enable_callback = kscan_mock_enable_callback_##n,                                         \
         .disable_callback = kscan_mock_disable_callback,                                           \
     };                                                                                             \
-    static struct kscan_mock_data kscan_mock_data_##n;                                             \
+    COND_CODE_1(MOCK_INST_DEBOUNCE(n), (static bool kscan_mock_raw_##n[MOCK_INST_KEYS(n)];), ())   \
+    COND_CODE_1(MOCK_INST_DEBOUNCE(n),                                                             \
+                (static struct zmk_debounce_state                                                  \
+                     kscan_mock_debounce_states_##n[MOCK_INST_KEYS(n)];),                          \
+                ())                                                                                \
+    static struct kscan_mock_data kscan_mock_data_##n = {COND_CODE_1(                              \
+        MOCK_INST_DEBOUNCE(n),                                                                     \
+        (.raw = kscan_mock_raw_##n, .debounce_states = kscan_mock_debounce_states_##n, ), ())};    \
     static const struct kscan_mock_config_##n kscan_mock_config_##n = {                            \
-        .events = DT_INST_PROP(n, events), .exit_after = DT_INST_PROP(n, exit_after)};             \
+        .events = DT_INST_PROP(n, events),                                                         \
+        .exit_after = DT_INST_PROP(n, exit_after),                                                 \
+        .debounce =                                                                                \
+            {                                                                                      \
+                .events = kscan_mock_config_##n.events,                                            \
+                .events_len = DT_INST_PROP_LEN(n, events),                                         \
+                .columns = DT_INST_PROP_OR(n, columns, 1),                                         \
+                .keys = MOCK_INST_KEYS(n),                                                         \
+                .debounce_config =                                                                 \
+                    {                                                                              \
+                        .debounce_press_ms = DT_INST_PROP(n, debounce_press_ms),                   \
+                        .debounce_release_ms = DT_INST_PROP(n, debounce_release_ms),               \
+                        .press_mode = DT_INST_ENUM_IDX(n, debounce_press_mode),                    \
+                        .release_mode = DT_INST_ENUM_IDX(n, debounce_release_mode),                \
+                    },                                                                             \
+                .scan_period_ms = DT_INST_PROP_OR(n, debounce_scan_period_ms, 0),                  \
+                .exit_after = DT_INST_PROP(n, exit_after),                                         \
+            },                                                                                     \
+    };                                                                                             \
     DEVICE_DT_INST_DEFINE(n, kscan_mock_init_##n, NULL, &kscan_mock_data_##n,                      \
                           &kscan_mock_config_##n, POST_KERNEL, CONFIG_KSCAN_INIT_PRIORITY,         \
                           &mock_driver_api_##n);
@@ -10,12 +10,21 @@
 #include <stdint.h>
 #include <zephyr/sys/util.h>
 
-#define DEBOUNCE_COUNTER_BITS 14
+#define DEBOUNCE_COUNTER_BITS 13
 #define DEBOUNCE_COUNTER_MAX BIT_MASK(DEBOUNCE_COUNTER_BITS)
 
+enum zmk_debounce_mode {
+    /** Latch a change once the switch has been stable for the debounce time. */
+    ZMK_DEBOUNCE_MODE_DEFER,
+    /** Latch a change on the first edge, then ignore the switch for the debounce time. */
+    ZMK_DEBOUNCE_MODE_EAGER,
+};
+
 struct zmk_debounce_state {
     bool pressed : 1;
     bool changed : 1;
+    /** Set while an eager change is ignoring the switch until the counter runs out. */
+    bool locked : 1;
     uint16_t counter : DEBOUNCE_COUNTER_BITS;
 };
 
@@ -24,6 +33,10 @@ struct zmk_debounce_config {
     uint32_t debounce_press_ms;
     /** Duration a switch must be released to latch as released. */
     uint32_t debounce_release_ms;
+    /** How presses are debounced. */
+    enum zmk_debounce_mode press_mode;
+    /** How releases are debounced. */
+    enum zmk_debounce_mode release_mode;
 };
 
 /**
@@ -54,3 +67,63 @@ bool zmk_debounce_is_pressed(const struct zmk_debounce_state *state);
  * debounce_update.
  */
 bool zmk_debounce_get_changed(const struct zmk_debounce_state *state);
+
+/**
+ * Debounce state for a row of up to 32 switches, with one bit per switch. Each switch has the
+ * same integrator as struct zmk_debounce_state, but the counters are stored as bit-planes so a
+ * whole row is updated with a handful of word operations.
+ */
+struct zmk_debounce_row {
+    /** Switches latched as pressed. */
+    uint32_t pressed;
+    /** Switches whose pressed state changed in the last update. */
+    uint32_t changed;
+    /** Switches with a non-zero counter, i.e. the debouncer has not yet made a decision. */
+    uint32_t counting;
+    /** Switches ignoring their input after an eager change, until their counter runs out. */
+    uint32_t locked;
+    /** Bit i of switch n's counter, in scans, is bit n of counter[i]. */
+    uint32_t counter[DEBOUNCE_COUNTER_BITS];
+};
+
+struct zmk_debounce_row_config {
+    /** Scans a switch must be pressed for before it latches as pressed. */
+    uint16_t press_scans;
+    /** Scans a switch must be released for before it latches as released. */
+    uint16_t release_scans;
+    /** How presses are debounced. */
+    enum zmk_debounce_mode press_mode;
+    /** How releases are debounced. */
+    enum zmk_debounce_mode release_mode;
+};
+
+/**
+ * Initializer for a struct zmk_debounce_row_config, rounding the debounce times up to whole
+ * scans so a switch is never latched sooner than with zmk_debounce_update().
+ */
+#define ZMK_DEBOUNCE_ROW_CONFIG(press_ms, release_ms, scan_period_ms, press_mode_, release_mode_) \
+    {                                                                                              \
+        .press_scans = DIV_ROUND_UP(press_ms, MAX(scan_period_ms, 1)),                             \
+        .release_scans = DIV_ROUND_UP(release_ms, MAX(scan_period_ms, 1)),                         \
+        .press_mode = press_mode_, .release_mode = release_mode_,                                  \
+    }
+
+/**
+ * Debounces a row of switches for one scan.
+ *
+ * This gives the same results as calling zmk_debounce_update() for each switch with elapsed_ms
+ * set to the scan period.
+ *
+ * @param row The state for the row to debounce.
+ * @param active Bitmask of the switches that are currently pressed. Bits for switches that don't
+ * exist must always be 0.
+ * @param config Debounce settings.
+ */
+void zmk_debounce_row_update(struct zmk_debounce_row *row, const uint32_t active,
+                             const struct zmk_debounce_row_config *config);
+
+/**
+ * @returns a bitmask of the switches that are either latched as pressed or potentially pressed
+ * but not yet decided. If it is non-zero, the kscan driver should continue to poll quickly.
+ */
+uint32_t zmk_debounce_row_get_active(const struct zmk_debounce_row *row);
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2025 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <zephyr/sys/slist.h>
+#include <zephyr/sys/util.h>
+
+/**
+ * How often polling kscan drivers scan while no key is pressed, from fastest to slowest.
+ */
+enum zmk_kscan_cadence_tier {
+    /** Keys were pressed recently. */
+    ZMK_KSCAN_CADENCE_TYPING,
+    /** No keys were pressed for a while, but the keyboard isn't idle yet. */
+    ZMK_KSCAN_CADENCE_SLOW,
+    /** The keyboard is idle. */
+    ZMK_KSCAN_CADENCE_IDLE,
+
+    ZMK_KSCAN_CADENCE_TIER_COUNT,
+};
+
+struct zmk_kscan_cadence_client;
+
+typedef void (*zmk_kscan_cadence_changed_t)(struct zmk_kscan_cadence_client *client,
+                                            enum zmk_kscan_cadence_tier old_tier,
+                                            enum zmk_kscan_cadence_tier new_tier);
+
+/**
+ * A kscan driver that wants to hear about tier changes, usually embedded in its data struct.
+ */
+struct zmk_kscan_cadence_client {
+    sys_snode_t node;
+    /** Called from the thread that changed the tier, which is normally the system work queue. */
+    zmk_kscan_cadence_changed_t changed;
+};
+
+struct zmk_kscan_cadence_stats {
+    enum zmk_kscan_cadence_tier tier;
+    /** Milliseconds spent in each tier, including the current one up to now. */
+    int64_t time_ms[ZMK_KSCAN_CADENCE_TIER_COUNT];
+};
+
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_CADENCE)
+#define ZMK_KSCAN_CADENCE_MAX_POLL_PERIOD_MS CONFIG_ZMK_KSCAN_CADENCE_MAX_POLL_PERIOD_MS
+#else
+#define ZMK_KSCAN_CADENCE_MAX_POLL_PERIOD_MS INT32_MAX
+#endif
+
+#define ZMK_KSCAN_CADENCE_DT_INST_SLOW_PERIOD(n, prop, slow_prop)                                  \
+    MIN(DT_INST_PROP_OR(n, slow_prop, DT_INST_PROP(n, prop)),                                      \
+        MAX(ZMK_KSCAN_CADENCE_MAX_POLL_PERIOD_MS, DT_INST_PROP(n, prop)))
+
+/**
+ * Initializer for a driver's poll periods per tier, indexed by enum zmk_kscan_cadence_tier.
+ * The slower tiers fall back to the typing period if their properties aren't set, and are
+ * capped to CONFIG_ZMK_KSCAN_CADENCE_MAX_POLL_PERIOD_MS so a short first press isn't missed.
+ */
+#define ZMK_KSCAN_CADENCE_DT_INST_POLL_PERIODS(n, prop)                                            \
+    {                                                                                              \
+        [ZMK_KSCAN_CADENCE_TYPING] = DT_INST_PROP(n, prop),                                        \
+        [ZMK_KSCAN_CADENCE_SLOW] =                                                                 \
+            ZMK_KSCAN_CADENCE_DT_INST_SLOW_PERIOD(n, prop, slow_poll_period_ms),                   \
+        [ZMK_KSCAN_CADENCE_IDLE] =                                                                 \
+            ZMK_KSCAN_CADENCE_DT_INST_SLOW_PERIOD(n, prop, idle_poll_period_ms),                   \
+    }
+
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_CADENCE)
+
+enum zmk_kscan_cadence_tier zmk_kscan_cadence_get_tier(void);
+
+/**
+ * Switch to a new tier, calling every registered client if it changed.
+ */
+void zmk_kscan_cadence_set_tier(enum zmk_kscan_cadence_tier tier);
+
+void zmk_kscan_cadence_register(struct zmk_kscan_cadence_client *client);
+
+void zmk_kscan_cadence_get_stats(struct zmk_kscan_cadence_stats *stats);
+
+const char *zmk_kscan_cadence_tier_name(enum zmk_kscan_cadence_tier tier);
+
+#else
+
+static inline enum zmk_kscan_cadence_tier zmk_kscan_cadence_get_tier(void) {
+    return ZMK_KSCAN_CADENCE_TYPING;
+}
+
+static inline void zmk_kscan_cadence_register(struct zmk_kscan_cadence_client *client) {}
+
+#endif // IS_ENABLED(CONFIG_ZMK_KSCAN_CADENCE)
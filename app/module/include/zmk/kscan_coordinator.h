@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2025 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <zephyr/device.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/slist.h>
+
+struct zmk_kscan_coordinator_client;
+
+/**
+ * Runs a scan the client asked for. scan_time is the same for every client scanned in a pass,
+ * and replaces whatever time the client asked to be scanned at.
+ */
+typedef void (*zmk_kscan_coordinator_scan_t)(struct zmk_kscan_coordinator_client *client,
+                                             int64_t scan_time);
+
+/**
+ * Runs the scans of several kscan drivers together from a single work item, so they share
+ * wakeups and timestamps. Usually embedded in a composite kscan's data struct.
+ */
+struct zmk_kscan_coordinator {
+    struct k_work_delayable work;
+    /** How early an idle poll may run so that it shares a pass with another scan. */
+    int32_t merge_window_ms;
+    /** Time of the current or scheduled pass. */
+    int64_t scan_time;
+    /** Incremented for each pass, so no client is scanned twice in one pass. */
+    uint32_t pass;
+    /** Whether a pass is running, in which case it reschedules the work once it's done. */
+    bool running;
+};
+
+/**
+ * A kscan driver that can have its scans run by a coordinator, usually embedded in its data
+ * struct. Until a coordinator attaches it, the driver schedules its own scans.
+ */
+struct zmk_kscan_coordinator_client {
+    sys_snode_t node;
+    const struct device *dev;
+    /** Called from the coordinator's work item, which runs on the system work queue. */
+    zmk_kscan_coordinator_scan_t scan;
+
+    /** The coordinator this client is attached to, or NULL. */
+    struct zmk_kscan_coordinator *coordinator;
+    /** Time of the requested scan, or -1 if there is none. */
+    int64_t scan_time;
+    /** Whether the requested scan is an idle poll, which may run early. */
+    bool idle;
+    /** The last pass that scanned this client. */
+    uint32_t pass;
+};
+
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_COORDINATOR)
+
+/**
+ * Make a driver available to coordinators. dev and scan must be set first.
+ */
+void zmk_kscan_coordinator_register(struct zmk_kscan_coordinator_client *client);
+
+void zmk_kscan_coordinator_init(struct zmk_kscan_coordinator *coordinator,
+                                int32_t merge_window_ms);
+
+/**
+ * Have the coordinator run the scans of a driver from now on.
+ *
+ * @retval -ENOTSUP if the driver hasn't registered as a client.
+ * @retval -EBUSY if the driver is already attached to a coordinator.
+ */
+int zmk_kscan_coordinator_attach(struct zmk_kscan_coordinator *coordinator,
+                                 const struct device *dev);
+
+/**
+ * Request a scan at the given time, replacing any earlier request. This may be called from an
+ * interrupt handler.
+ *
+ * @retval -ENOTSUP if the client isn't attached, and must schedule the scan itself.
+ */
+int zmk_kscan_coordinator_schedule(struct zmk_kscan_coordinator_client *client,
+                                   int64_t scan_time, bool idle);
+
+/**
+ * Drop any requested scan.
+ */
+void zmk_kscan_coordinator_cancel(struct zmk_kscan_coordinator_client *client);
+
+#else
+
+static inline void zmk_kscan_coordinator_register(struct zmk_kscan_coordinator_client *client) {}
+
+static inline int zmk_kscan_coordinator_schedule(struct zmk_kscan_coordinator_client *client,
+                                                 int64_t scan_time, bool idle) {
+    return -ENOTSUP;
+}
+
+static inline void zmk_kscan_coordinator_cancel(struct zmk_kscan_coordinator_client *client) {}
+
+#endif // IS_ENABLED(CONFIG_ZMK_KSCAN_COORDINATOR)
@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2025 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <errno.h>
+#include <stdint.h>
+#include <zephyr/device.h>
+#include <zephyr/sys/slist.h>
+
+/**
+ * Called once for each key a kscan driver currently reports as pressed.
+ */
+typedef void (*zmk_kscan_state_cb_t)(const struct device *dev, uint32_t row, uint32_t column,
+                                     void *user_data);
+
+typedef int (*zmk_kscan_get_state_t)(const struct device *dev, zmk_kscan_state_cb_t cb,
+                                     void *user_data);
+
+/**
+ * A kscan driver that can list the keys it currently reports as pressed, usually embedded in
+ * its data struct.
+ */
+struct zmk_kscan_state_provider {
+    sys_snode_t node;
+    const struct device *dev;
+    zmk_kscan_get_state_t get_state;
+};
+
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_STATE)
+
+/**
+ * Make a driver's state available through zmk_kscan_get_state(). dev and get_state must be set
+ * first.
+ */
+void zmk_kscan_state_register(struct zmk_kscan_state_provider *provider);
+
+/**
+ * Call cb for every key the driver has reported as pressed through its kscan callback and not
+ * yet reported as released. Must be called from the thread the driver reports changes from,
+ * which is normally the system work queue, so no change is reported while it runs.
+ *
+ * @retval -ENOTSUP if the driver can't list its state.
+ */
+int zmk_kscan_get_state(const struct device *dev, zmk_kscan_state_cb_t cb, void *user_data);
+
+#else
+
+static inline void zmk_kscan_state_register(struct zmk_kscan_state_provider *provider) {}
+
+static inline int zmk_kscan_get_state(const struct device *dev, zmk_kscan_state_cb_t cb,
+                                      void *user_data) {
+    return -ENOTSUP;
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_KSCAN_STATE)
@@ -11,6 +11,11 @@ static uint32_t get_threshold(const struct zmk_debounce_state *state,
     return state->pressed ? config->debounce_release_ms : config->debounce_press_ms;
 }
 
+static enum zmk_debounce_mode get_mode(const struct zmk_debounce_state *state,
+                                       const struct zmk_debounce_config *config) {
+    return state->pressed ? config->release_mode : config->press_mode;
+}
+
 static void increment_counter(struct zmk_debounce_state *state, const int elapsed_ms) {
     if (state->counter + elapsed_ms > DEBOUNCE_COUNTER_MAX) {
         state->counter = DEBOUNCE_COUNTER_MAX;
@@ -36,6 +41,16 @@ void zmk_debounce_update(struct zmk_debounce_state *state, const bool active, co
     // threshold, the state flips and we reset the counter.
     state->changed = false;
 
+    // After an eager change, the switch is ignored until the counter runs out. The update that
+    // runs it out treats the input as the first one after the lock.
+    if (state->locked) {
+        decrement_counter(state, elapsed_ms);
+        if (state->counter > 0) {
+            return;
+        }
+        state->locked = false;
+    }
+
     if (active == state->pressed) {
         decrement_counter(state, elapsed_ms);
         return;
@@ -43,6 +58,16 @@ void zmk_debounce_update(struct zmk_debounce_state *state, const bool active, co
 
     const uint32_t flip_threshold = get_threshold(state, config);
 
+    // Eager mode reports the first edge right away, then locks out the bounces that follow it
+    // for the debounce time of the change it just made.
+    if (get_mode(state, config) == ZMK_DEBOUNCE_MODE_EAGER) {
+        state->pressed = !state->pressed;
+        state->counter = MIN(flip_threshold, DEBOUNCE_COUNTER_MAX);
+        state->locked = state->counter > 0;
+        state->changed = true;
+        return;
+    }
+
     if (state->counter < flip_threshold) {
         increment_counter(state, elapsed_ms);
         return;
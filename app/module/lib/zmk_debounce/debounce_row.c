@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2025 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zmk/debounce.h>
+
+/**
+ * Number of counter planes needed to hold values up to and including max.
+ */
+static int get_planes(const uint32_t max) { return 32 - __builtin_clz(max | 1); }
+
+/**
+ * @returns a bitmask of the switches whose counter is greater than or equal to threshold.
+ */
+static uint32_t counter_at_least(const struct zmk_debounce_row *row, const uint32_t threshold,
+                                 const int planes) {
+    uint32_t greater = 0;
+    uint32_t equal = UINT32_MAX;
+
+    // Compare from the most significant bit down, like a schoolbook comparison of two numbers.
+    for (int i = planes - 1; i >= 0; i--) {
+        if (threshold & BIT(i)) {
+            equal &= row->counter[i];
+        } else {
+            greater |= equal & row->counter[i];
+            equal &= ~row->counter[i];
+        }
+    }
+
+    return greater | equal;
+}
+
+/**
+ * @returns UINT32_MAX if mode is eager, or 0 otherwise.
+ */
+static uint32_t eager_mask(const enum zmk_debounce_mode mode) {
+    return mode == ZMK_DEBOUNCE_MODE_EAGER ? UINT32_MAX : 0;
+}
+
+/**
+ * Counts down the switches that are locked after an eager change.
+ * @returns a bitmask of the switches that are still locked.
+ */
+static uint32_t count_down_locked(struct zmk_debounce_row *row, const int planes) {
+    uint32_t borrow = row->locked;
+    uint32_t nonzero = 0;
+
+    for (int i = 0; i < planes; i++) {
+        const uint32_t plane = row->counter[i];
+
+        row->counter[i] = plane ^ borrow;
+        nonzero |= row->counter[i];
+        borrow &= ~plane;
+    }
+
+    return row->locked & nonzero;
+}
+
+void zmk_debounce_row_update(struct zmk_debounce_row *row, const uint32_t active,
+                             const struct zmk_debounce_row_config *config) {
+    // Same integrator as zmk_debounce_update(), counting in scans. Switches that match their
+    // latched state count down, the others count up until they reach their threshold and flip.
+    const int planes = get_planes(MAX(config->press_scans, config->release_scans));
+
+    // Locked switches only count down. Those that run out this scan are processed like the rest.
+    const uint32_t locked = row->locked ? count_down_locked(row, planes) : 0;
+    if (row->locked & ~locked) {
+        row->counting = locked;
+        for (int i = 0; i < planes; i++) {
+            row->counting |= row->counter[i];
+        }
+    }
+
+    const uint32_t eager = (row->pressed & eager_mask(config->release_mode)) |
+                           (~row->pressed & eager_mask(config->press_mode));
+    const uint32_t mismatched = active ^ row->pressed;
+    const uint32_t reached = (row->pressed & counter_at_least(row, config->release_scans, planes)) |
+                             (~row->pressed & counter_at_least(row, config->press_scans, planes));
+
+    const uint32_t flip = mismatched & (reached | eager) & ~locked;
+    uint32_t carry = mismatched & ~reached & ~eager & ~locked;
+    uint32_t borrow = ~mismatched & row->counting & ~locked;
+
+    row->counting = 0;
+
+    for (int i = 0; i < planes; i++) {
+        const uint32_t plane = row->counter[i] & ~flip;
+        const uint32_t next_carry = plane & carry;
+        const uint32_t next_borrow = ~plane & borrow;
+
+        row->counter[i] = plane ^ carry ^ borrow;
+        row->counting |= row->counter[i];
+
+        carry = next_carry;
+        borrow = next_borrow;
+    }
+
+    row->pressed ^= flip;
+    row->changed = flip;
+    row->locked = locked;
+
+    // Eager changes lock the switch for the debounce time of the change they made.
+    const uint32_t eager_flip = flip & eager;
+    if (eager_flip) {
+        const uint32_t pressed = eager_flip & row->pressed;
+        const uint32_t released = eager_flip & ~row->pressed;
+
+        for (int i = 0; i < planes; i++) {
+            row->counter[i] |= (config->press_scans & BIT(i) ? pressed : 0) |
+                               (config->release_scans & BIT(i) ? released : 0);
+            row->locked |= row->counter[i] & eager_flip;
+        }
+        row->counting |= row->locked;
+    }
+}
+
+uint32_t zmk_debounce_row_get_active(const struct zmk_debounce_row *row) {
+    return row->pressed | row->counting;
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2025 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/spinlock.h>
+
+#include <zmk/kscan_cadence.h>
+
+static sys_slist_t clients = SYS_SLIST_STATIC_INIT(&clients);
+
+static struct k_spinlock lock;
+static enum zmk_kscan_cadence_tier current_tier = ZMK_KSCAN_CADENCE_TYPING;
+static int64_t tier_start_ms;
+static int64_t tier_time_ms[ZMK_KSCAN_CADENCE_TIER_COUNT];
+
+enum zmk_kscan_cadence_tier zmk_kscan_cadence_get_tier(void) { return current_tier; }
+
+void zmk_kscan_cadence_set_tier(enum zmk_kscan_cadence_tier tier) {
+    if (tier >= ZMK_KSCAN_CADENCE_TIER_COUNT) {
+        return;
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    const enum zmk_kscan_cadence_tier old_tier = current_tier;
+
+    if (old_tier != tier) {
+        const int64_t now = k_uptime_get();
+
+        tier_time_ms[old_tier] += now - tier_start_ms;
+        tier_start_ms = now;
+        current_tier = tier;
+    }
+
+    k_spin_unlock(&lock, key);
+
+    if (old_tier == tier) {
+        return;
+    }
+
+    struct zmk_kscan_cadence_client *client;
+    SYS_SLIST_FOR_EACH_CONTAINER(&clients, client, node) {
+        client->changed(client, old_tier, tier);
+    }
+}
+
+void zmk_kscan_cadence_register(struct zmk_kscan_cadence_client *client) {
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    sys_slist_append(&clients, &client->node);
+    k_spin_unlock(&lock, key);
+}
+
+void zmk_kscan_cadence_get_stats(struct zmk_kscan_cadence_stats *stats) {
+    k_spinlock_key_t key = k_spin_lock(&lock);
+
+    stats->tier = current_tier;
+    memcpy(stats->time_ms, tier_time_ms, sizeof(tier_time_ms));
+    stats->time_ms[current_tier] += k_uptime_get() - tier_start_ms;
+
+    k_spin_unlock(&lock, key);
+}
+
+const char *zmk_kscan_cadence_tier_name(enum zmk_kscan_cadence_tier tier) {
+    switch (tier) {
+    case ZMK_KSCAN_CADENCE_TYPING:
+        return "typing";
+    case ZMK_KSCAN_CADENCE_SLOW:
+        return "slow";
+    case ZMK_KSCAN_CADENCE_IDLE:
+        return "idle";
+    default:
+        return "unknown";
+    }
+}
@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) 2025 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/spinlock.h>
+
+#include <zmk/kscan_coordinator.h>
+
+static sys_slist_t clients = SYS_SLIST_STATIC_INIT(&clients);
+
+static struct k_spinlock lock;
+
+// Must be called with the lock held.
+static void reschedule(struct zmk_kscan_coordinator *coordinator) {
+    if (coordinator->running) {
+        return;
+    }
+
+    int64_t next = -1;
+    struct zmk_kscan_coordinator_client *client;
+    SYS_SLIST_FOR_EACH_CONTAINER(&clients, client, node) {
+        if (client->coordinator == coordinator && client->scan_time >= 0 &&
+            (next < 0 || client->scan_time < next)) {
+            next = client->scan_time;
+        }
+    }
+
+    if (next < 0) {
+        k_work_cancel_delayable(&coordinator->work);
+        return;
+    }
+
+    coordinator->scan_time = next;
+    k_work_reschedule(&coordinator->work,
+                      next <= k_uptime_get() ? K_NO_WAIT : K_TIMEOUT_ABS_MS(next));
+}
+
+// Must be called with the lock held.
+static bool is_pending(const struct zmk_kscan_coordinator *coordinator,
+                       const struct zmk_kscan_coordinator_client *client) {
+    return client->coordinator == coordinator && client->scan_time >= 0 &&
+           client->pass != coordinator->pass;
+}
+
+// Must be called with the lock held. Returns whether some other scan will need a pass no later
+// than the given client's.
+static bool has_earlier_request(const struct zmk_kscan_coordinator *coordinator,
+                                const struct zmk_kscan_coordinator_client *candidate) {
+    struct zmk_kscan_coordinator_client *client;
+    SYS_SLIST_FOR_EACH_CONTAINER(&clients, client, node) {
+        if (client != candidate && client->coordinator == coordinator && client->scan_time >= 0 &&
+            client->scan_time <= candidate->scan_time) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static struct zmk_kscan_coordinator_client *
+take_client(const struct zmk_kscan_coordinator *coordinator,
+            struct zmk_kscan_coordinator_client *client) {
+    client->scan_time = -1;
+    client->pass = coordinator->pass;
+    return client;
+}
+
+// Must be called with the lock held. Returns the next client to scan in the current pass.
+static struct zmk_kscan_coordinator_client *
+take_due_client(const struct zmk_kscan_coordinator *coordinator) {
+    struct zmk_kscan_coordinator_client *client;
+
+    // Scans that are due go first, since they may ask for another pass soon after this one.
+    SYS_SLIST_FOR_EACH_CONTAINER(&clients, client, node) {
+        if (is_pending(coordinator, client) && client->scan_time <= coordinator->scan_time) {
+            return take_client(coordinator, client);
+        }
+    }
+
+    // Then idle polls which would otherwise need a pass of their own shortly after this one.
+    // Running a poll a little early costs nothing, but a debounce scan must not run before its
+    // time.
+    const int64_t latest = coordinator->scan_time + coordinator->merge_window_ms;
+
+    SYS_SLIST_FOR_EACH_CONTAINER(&clients, client, node) {
+        if (is_pending(coordinator, client) && client->idle && client->scan_time <= latest &&
+            !has_earlier_request(coordinator, client)) {
+            return take_client(coordinator, client);
+        }
+    }
+
+    return NULL;
+}
+
+static void coordinator_work_handler(struct k_work *work) {
+    struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+    struct zmk_kscan_coordinator *coordinator =
+        CONTAINER_OF(dwork, struct zmk_kscan_coordinator, work);
+
+    k_spinlock_key_t key = k_spin_lock(&lock);
+
+    coordinator->running = true;
+    coordinator->pass++;
+    const int64_t scan_time = coordinator->scan_time;
+
+    struct zmk_kscan_coordinator_client *client;
+    while ((client = take_due_client(coordinator)) != NULL) {
+        k_spin_unlock(&lock, key);
+        client->scan(client, scan_time);
+        key = k_spin_lock(&lock);
+    }
+
+    coordinator->running = false;
+    reschedule(coordinator);
+
+    k_spin_unlock(&lock, key);
+}
+
+void zmk_kscan_coordinator_register(struct zmk_kscan_coordinator_client *client) {
+    client->coordinator = NULL;
+    client->scan_time = -1;
+
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    sys_slist_append(&clients, &client->node);
+    k_spin_unlock(&lock, key);
+}
+
+void zmk_kscan_coordinator_init(struct zmk_kscan_coordinator *coordinator,
+                                int32_t merge_window_ms) {
+    coordinator->merge_window_ms = merge_window_ms;
+    k_work_init_delayable(&coordinator->work, coordinator_work_handler);
+}
+
+int zmk_kscan_coordinator_attach(struct zmk_kscan_coordinator *coordinator,
+                                 const struct device *dev) {
+    int ret = -ENOTSUP;
+    k_spinlock_key_t key = k_spin_lock(&lock);
+
+    struct zmk_kscan_coordinator_client *client;
+    SYS_SLIST_FOR_EACH_CONTAINER(&clients, client, node) {
+        if (client->dev != dev) {
+            continue;
+        }
+
+        if (client->coordinator) {
+            ret = -EBUSY;
+        } else {
+            client->coordinator = coordinator;
+            ret = 0;
+        }
+        break;
+    }
+
+    k_spin_unlock(&lock, key);
+    return ret;
+}
+
+int zmk_kscan_coordinator_schedule(struct zmk_kscan_coordinator_client *client,
+                                   int64_t scan_time, bool idle) {
+    if (!client->coordinator) {
+        return -ENOTSUP;
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&lock);
+
+    client->scan_time = scan_time;
+    client->idle = idle;
+    reschedule(client->coordinator);
+
+    k_spin_unlock(&lock, key);
+    return 0;
+}
+
+void zmk_kscan_coordinator_cancel(struct zmk_kscan_coordinator_client *client) {
+    if (!client->coordinator) {
+        return;
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&lock);
+
+    client->scan_time = -1;
+    reschedule(client->coordinator);
+
+    k_spin_unlock(&lock, key);
+}
@@ -0,0 +1,33 @@
+/*
+ * Copyright (c) 2025 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/spinlock.h>
+
+#include <zmk/kscan_state.h>
+
+static sys_slist_t providers = SYS_SLIST_STATIC_INIT(&providers);
+
+static struct k_spinlock lock;
+
+void zmk_kscan_state_register(struct zmk_kscan_state_provider *provider) {
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    sys_slist_append(&providers, &provider->node);
+    k_spin_unlock(&lock, key);
+}
+
+int zmk_kscan_get_state(const struct device *dev, zmk_kscan_state_cb_t cb, void *user_data) {
+    struct zmk_kscan_state_provider *provider;
+
+    // Providers are only ever appended, so the list can be walked without the lock.
+    SYS_SLIST_FOR_EACH_CONTAINER(&providers, provider, node) {
+        if (provider->dev == dev) {
+            return provider->get_state(dev, cb, user_data);
+        }
+    }
+
+    return -ENOTSUP;
+}
@@ -32,6 +32,7 @@
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
 #include <zmk/ble.h>
+#include <zmk/ble/link.h>
 #include <zmk/keys.h>
 #include <zmk/split/bluetooth/uuid.h>
 #include <zmk/event_manager.h>
@@ -521,6 +522,9 @@ static void connected(struct bt_conn *conn, uint8_t err) {
 
     LOG_DBG("Connected %s", addr);
 
+    zmk_ble_link_request_fast(conn, IS_ENABLED(CONFIG_ZMK_BLE_PREF_PHY_2M),
+                              IS_ENABLED(CONFIG_ZMK_BLE_DATA_LEN_EXTENSION));
+
     update_advertising();
 
     if (is_conn_active_profile(conn)) {
@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) 2025 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/init.h>
+#include <zephyr/kernel.h>
+#include <zephyr/bluetooth/bluetooth.h>
+#include <zephyr/bluetooth/conn.h>
+
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <zmk/ble.h>
+#include <zmk/ble/conn_params.h>
+#include <zmk/event_manager.h>
+#include <zmk/events/activity_state_changed.h>
+#include <zmk/events/position_state_changed.h>
+#include <zmk/events/sensor_event.h>
+
+#if IS_ENABLED(CONFIG_ZMK_POINTING)
+#include <zephyr/input/input.h>
+#endif
+
+BUILD_ASSERT(CONFIG_ZMK_BLE_ACTIVE_CONN_MIN_INT <= CONFIG_ZMK_BLE_ACTIVE_CONN_MAX_INT,
+             "Active connection interval minimum must not exceed the maximum");
+BUILD_ASSERT(CONFIG_ZMK_BLE_IDLE_CONN_MIN_INT <= CONFIG_ZMK_BLE_IDLE_CONN_MAX_INT,
+             "Idle connection interval minimum must not exceed the maximum");
+
+static const struct bt_le_conn_param host_params[ZMK_BLE_CONN_MODE_COUNT] = {
+    [ZMK_BLE_CONN_MODE_ACTIVE] = BT_LE_CONN_PARAM_INIT(
+        CONFIG_ZMK_BLE_ACTIVE_CONN_MIN_INT, CONFIG_ZMK_BLE_ACTIVE_CONN_MAX_INT,
+        CONFIG_ZMK_BLE_ACTIVE_CONN_LATENCY, CONFIG_BT_PERIPHERAL_PREF_TIMEOUT),
+    [ZMK_BLE_CONN_MODE_IDLE] = BT_LE_CONN_PARAM_INIT(
+        CONFIG_ZMK_BLE_IDLE_CONN_MIN_INT, CONFIG_ZMK_BLE_IDLE_CONN_MAX_INT,
+        CONFIG_ZMK_BLE_IDLE_CONN_LATENCY, CONFIG_BT_PERIPHERAL_PREF_TIMEOUT),
+};
+
+#if ZMK_BLE_IS_CENTRAL
+
+static const struct bt_le_conn_param split_params[ZMK_BLE_CONN_MODE_COUNT] = {
+    [ZMK_BLE_CONN_MODE_ACTIVE] =
+        BT_LE_CONN_PARAM_INIT(CONFIG_ZMK_SPLIT_BLE_PREF_INT, CONFIG_ZMK_SPLIT_BLE_PREF_INT, 0,
+                              CONFIG_ZMK_SPLIT_BLE_PREF_TIMEOUT),
+    [ZMK_BLE_CONN_MODE_IDLE] = BT_LE_CONN_PARAM_INIT(
+        CONFIG_ZMK_SPLIT_BLE_IDLE_INT, CONFIG_ZMK_SPLIT_BLE_IDLE_INT,
+        CONFIG_ZMK_SPLIT_BLE_PREF_LATENCY, CONFIG_ZMK_SPLIT_BLE_PREF_TIMEOUT),
+};
+
+#endif // ZMK_BLE_IS_CENTRAL
+
+// Start out idle, the first key press will bring the links up to speed.
+static enum zmk_ble_conn_mode current_mode = ZMK_BLE_CONN_MODE_IDLE;
+static int64_t mode_entered_at;
+
+static struct zmk_ble_conn_params_stats stats;
+
+static const struct bt_le_conn_param *params_for_role(uint8_t role, enum zmk_ble_conn_mode mode) {
+    switch (role) {
+    case BT_CONN_ROLE_PERIPHERAL:
+        return &host_params[mode];
+#if ZMK_BLE_IS_CENTRAL
+    case BT_CONN_ROLE_CENTRAL:
+        return &split_params[mode];
+#endif
+    default:
+        return NULL;
+    }
+}
+
+static void apply_mode_to_conn(struct bt_conn *conn, void *data) {
+    enum zmk_ble_conn_mode mode = *(enum zmk_ble_conn_mode *)data;
+    struct bt_conn_info info;
+
+    if (bt_conn_get_info(conn, &info) < 0 || info.state != BT_CONN_STATE_CONNECTED) {
+        return;
+    }
+
+    const struct bt_le_conn_param *param = params_for_role(info.role, mode);
+    if (!param) {
+        return;
+    }
+
+    if (info.le.interval >= param->interval_min && info.le.interval <= param->interval_max &&
+        info.le.latency == param->latency) {
+        return;
+    }
+
+    stats.update_requests++;
+
+    int err = bt_conn_le_param_update(conn, param);
+    if (err < 0 && err != -EALREADY) {
+        stats.update_failures++;
+        LOG_WRN("Failed to request %s connection parameters (err %d)",
+                mode == ZMK_BLE_CONN_MODE_ACTIVE ? "active" : "idle", err);
+    }
+}
+
+static void set_mode(enum zmk_ble_conn_mode mode) {
+    if (mode == current_mode) {
+        return;
+    }
+
+    int64_t now = k_uptime_get();
+
+    stats.mode_time_ms[current_mode] += (uint32_t)(now - mode_entered_at);
+    stats.mode_entries[mode]++;
+    mode_entered_at = now;
+    current_mode = mode;
+
+    LOG_DBG("Switching to %s connection parameters",
+            mode == ZMK_BLE_CONN_MODE_ACTIVE ? "active" : "idle");
+
+    bt_conn_foreach(BT_CONN_TYPE_LE, apply_mode_to_conn, &mode);
+}
+
+static void active_work_cb(struct k_work *work) { set_mode(ZMK_BLE_CONN_MODE_ACTIVE); }
+
+static K_WORK_DEFINE(active_work, active_work_cb);
+
+static void idle_work_cb(struct k_work *work) { set_mode(ZMK_BLE_CONN_MODE_IDLE); }
+
+static K_WORK_DELAYABLE_DEFINE(idle_work, idle_work_cb);
+
+static void note_activity(void) {
+    k_work_reschedule(&idle_work, K_MSEC(CONFIG_ZMK_BLE_DYNAMIC_CONN_PARAMS_IDLE_TIMEOUT));
+
+    if (current_mode != ZMK_BLE_CONN_MODE_ACTIVE) {
+        k_work_submit(&active_work);
+    }
+}
+
+enum zmk_ble_conn_mode zmk_ble_conn_params_get_mode(void) { return current_mode; }
+
+int zmk_ble_conn_params_get_stats(struct zmk_ble_conn_params_stats *out) {
+    if (!out) {
+        return -EINVAL;
+    }
+
+    *out = stats;
+    out->mode_time_ms[current_mode] += (uint32_t)(k_uptime_get() - mode_entered_at);
+
+    return 0;
+}
+
+static void conn_params_connected(struct bt_conn *conn, uint8_t err) {
+    if (err) {
+        return;
+    }
+
+    enum zmk_ble_conn_mode mode = current_mode;
+    apply_mode_to_conn(conn, &mode);
+}
+
+static void conn_params_updated(struct bt_conn *conn, uint16_t interval, uint16_t latency,
+                                uint16_t timeout) {
+    stats.updates_applied++;
+}
+
+static struct bt_conn_cb conn_params_conn_callbacks = {
+    .connected = conn_params_connected,
+    .le_param_updated = conn_params_updated,
+};
+
+static int conn_params_listener(const zmk_event_t *eh) {
+    const struct zmk_activity_state_changed *activity_ev = as_zmk_activity_state_changed(eh);
+
+    if (activity_ev) {
+        if (activity_ev->state != ZMK_ACTIVITY_ACTIVE) {
+            k_work_reschedule(&idle_work, K_NO_WAIT);
+        }
+
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    note_activity();
+
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(ble_conn_params, conn_params_listener);
+ZMK_SUBSCRIPTION(ble_conn_params, zmk_activity_state_changed);
+ZMK_SUBSCRIPTION(ble_conn_params, zmk_position_state_changed);
+ZMK_SUBSCRIPTION(ble_conn_params, zmk_sensor_event);
+
+#if IS_ENABLED(CONFIG_ZMK_POINTING)
+
+static void conn_params_input_listener(struct input_event *ev) { note_activity(); }
+
+INPUT_CALLBACK_DEFINE(NULL, conn_params_input_listener);
+
+#endif // IS_ENABLED(CONFIG_ZMK_POINTING)
+
+static int conn_params_init(void) {
+    mode_entered_at = k_uptime_get();
+    stats.mode_entries[current_mode]++;
+
+    bt_conn_cb_register(&conn_params_conn_callbacks);
+
+    return 0;
+}
+
+SYS_INIT(conn_params_init, APPLICATION, CONFIG_ZMK_BLE_INIT_PRIORITY);
@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2025 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/init.h>
+#include <zephyr/kernel.h>
+#include <zephyr/bluetooth/bluetooth.h>
+#include <zephyr/bluetooth/conn.h>
+
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <zmk/ble/link.h>
+
+int zmk_ble_link_request_fast(struct bt_conn *conn, bool phy_2m, bool data_len) {
+    int ret = 0;
+
+#if IS_ENABLED(CONFIG_BT_USER_PHY_UPDATE)
+    if (phy_2m) {
+        int err = bt_conn_le_phy_update(conn, BT_CONN_LE_PHY_PARAM_2M);
+        if (err < 0 && err != -EALREADY) {
+            LOG_WRN("Failed to request 2M PHY, staying on the current PHY (err %d)", err);
+            ret = err;
+        }
+    }
+#endif // IS_ENABLED(CONFIG_BT_USER_PHY_UPDATE)
+
+#if IS_ENABLED(CONFIG_BT_USER_DATA_LEN_UPDATE)
+    if (data_len) {
+        int err = bt_conn_le_data_len_update(conn, BT_LE_DATA_LEN_PARAM_MAX);
+        if (err < 0 && err != -EALREADY) {
+            LOG_WRN("Failed to request data length extension, keeping the default (err %d)",
+                    err);
+            ret = err;
+        }
+    }
+#endif // IS_ENABLED(CONFIG_BT_USER_DATA_LEN_UPDATE)
+
+    return ret;
+}
+
+int zmk_ble_link_get_info(struct bt_conn *conn, struct zmk_ble_link_info *info) {
+    struct bt_conn_info conn_info;
+
+    if (!conn || !info) {
+        return -EINVAL;
+    }
+
+    int err = bt_conn_get_info(conn, &conn_info);
+    if (err < 0) {
+        return err;
+    }
+
+    *info = (struct zmk_ble_link_info){
+        .interval = conn_info.le.interval,
+        .latency = conn_info.le.latency,
+        .timeout = conn_info.le.timeout,
+    };
+
+#if IS_ENABLED(CONFIG_BT_USER_PHY_UPDATE)
+    info->tx_phy = conn_info.le.phy->tx_phy;
+    info->rx_phy = conn_info.le.phy->rx_phy;
+#endif // IS_ENABLED(CONFIG_BT_USER_PHY_UPDATE)
+
+#if IS_ENABLED(CONFIG_BT_USER_DATA_LEN_UPDATE)
+    info->tx_max_len = conn_info.le.data_len->tx_max_len;
+    info->rx_max_len = conn_info.le.data_len->rx_max_len;
+#endif // IS_ENABLED(CONFIG_BT_USER_DATA_LEN_UPDATE)
+
+    return 0;
+}
+
+#if IS_ENABLED(CONFIG_BT_USER_PHY_UPDATE)
+
+static void link_phy_updated(struct bt_conn *conn, struct bt_conn_le_phy_info *param) {
+    char addr[BT_ADDR_LE_STR_LEN];
+
+    bt_addr_le_to_str(bt_conn_get_dst(conn), addr, sizeof(addr));
+
+    LOG_DBG("%s: PHY tx %d rx %d", addr, param->tx_phy, param->rx_phy);
+}
+
+#endif // IS_ENABLED(CONFIG_BT_USER_PHY_UPDATE)
+
+#if IS_ENABLED(CONFIG_BT_USER_DATA_LEN_UPDATE)
+
+static void link_data_len_updated(struct bt_conn *conn, struct bt_conn_le_data_len_info *info) {
+    char addr[BT_ADDR_LE_STR_LEN];
+
+    bt_addr_le_to_str(bt_conn_get_dst(conn), addr, sizeof(addr));
+
+    LOG_DBG("%s: data length tx %d/%dus rx %d/%dus", addr, info->tx_max_len, info->tx_max_time,
+            info->rx_max_len, info->rx_max_time);
+}
+
+#endif // IS_ENABLED(CONFIG_BT_USER_DATA_LEN_UPDATE)
+
+static struct bt_conn_cb link_conn_callbacks = {
+#if IS_ENABLED(CONFIG_BT_USER_PHY_UPDATE)
+    .le_phy_updated = link_phy_updated,
+#endif
+#if IS_ENABLED(CONFIG_BT_USER_DATA_LEN_UPDATE)
+    .le_data_len_updated = link_data_len_updated,
+#endif
+};
+
+static int ble_link_init(void) {
+    bt_conn_cb_register(&link_conn_callbacks);
+
+    return 0;
+}
+
+SYS_INIT(ble_link_init, APPLICATION, CONFIG_ZMK_BLE_INIT_PRIORITY);
@@ -8,6 +8,7 @@
 #include <zephyr/settings/settings.h>
 
 #include <stdio.h>
+#include <string.h>
 
 #include <zmk/ble.h>
 #include <zmk/endpoints.h>
@@ -118,72 +119,174 @@ int zmk_endpoints_toggle_transport(void) {
 
 struct zmk_endpoint_instance zmk_endpoints_selected(void) { return current_instance; }
 
-static int send_keyboard_report(void) {
-    switch (current_instance.transport) {
+#if IS_ENABLED(CONFIG_ZMK_ENDPOINTS_REPORT_SNAPSHOTS)
+
+// The last keyboard and consumer report bodies each endpoint received, so a switch or a newly
+// ready endpoint only needs one catch-up report instead of clearing all HID state.
+struct endpoint_report_snapshot {
+    struct zmk_hid_keyboard_report_body keyboard;
+    struct zmk_hid_consumer_report_body consumer;
+};
+
+static struct endpoint_report_snapshot report_snapshots[ZMK_ENDPOINT_COUNT];
+
+static struct endpoint_report_snapshot *get_snapshot(struct zmk_endpoint_instance endpoint) {
+    return &report_snapshots[zmk_endpoint_instance_to_index(endpoint)];
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_ENDPOINTS_REPORT_SNAPSHOTS)
+
+static int send_keyboard_report_to(struct zmk_endpoint_instance endpoint) {
+    switch (endpoint.transport) {
     case ZMK_TRANSPORT_USB: {
-#if IS_ENABLED(CONFIG_ZMK_USB)
+#if IS_ENABLED(CONFIG_ZMK_ENDPOINTS_USB)
         int err = zmk_usb_hid_send_keyboard_report();
+        if (err == -EAGAIN) {
+            LOG_DBG("USB is suspended, waking the host");
+            return err;
+        }
         if (err) {
             LOG_ERR("FAILED TO SEND OVER USB: %d", err);
+            return err;
         }
-        return err;
+        break;
 #else
         LOG_ERR("USB endpoint is not supported");
         return -ENOTSUP;
-#endif /* IS_ENABLED(CONFIG_ZMK_USB) */
+#endif /* IS_ENABLED(CONFIG_ZMK_ENDPOINTS_USB) */
     }
 
     case ZMK_TRANSPORT_BLE: {
-#if IS_ENABLED(CONFIG_ZMK_BLE)
+#if IS_ENABLED(CONFIG_ZMK_ENDPOINTS_BLE)
         struct zmk_hid_keyboard_report *keyboard_report = zmk_hid_get_keyboard_report();
         int err = zmk_hog_send_keyboard_report(&keyboard_report->body);
         if (err) {
             LOG_ERR("FAILED TO SEND OVER HOG: %d", err);
+            return err;
         }
-        return err;
+        break;
 #else
         LOG_ERR("BLE HOG endpoint is not supported");
         return -ENOTSUP;
-#endif /* IS_ENABLED(CONFIG_ZMK_BLE) */
+#endif /* IS_ENABLED(CONFIG_ZMK_ENDPOINTS_BLE) */
     }
+
+    default:
+        LOG_ERR("Unhandled endpoint transport %d", endpoint.transport);
+        return -ENOTSUP;
     }
 
-    LOG_ERR("Unhandled endpoint transport %d", current_instance.transport);
-    return -ENOTSUP;
+#if IS_ENABLED(CONFIG_ZMK_ENDPOINTS_REPORT_SNAPSHOTS)
+    get_snapshot(endpoint)->keyboard = zmk_hid_get_keyboard_report()->body;
+#endif
+
+    return 0;
 }
 
-static int send_consumer_report(void) {
-    switch (current_instance.transport) {
+static int send_consumer_report_to(struct zmk_endpoint_instance endpoint) {
+    switch (endpoint.transport) {
     case ZMK_TRANSPORT_USB: {
-#if IS_ENABLED(CONFIG_ZMK_USB)
+#if IS_ENABLED(CONFIG_ZMK_ENDPOINTS_USB)
         int err = zmk_usb_hid_send_consumer_report();
+        if (err == -EAGAIN) {
+            LOG_DBG("USB is suspended, waking the host");
+            return err;
+        }
         if (err) {
             LOG_ERR("FAILED TO SEND OVER USB: %d", err);
+            return err;
         }
-        return err;
+        break;
 #else
         LOG_ERR("USB endpoint is not supported");
         return -ENOTSUP;
-#endif /* IS_ENABLED(CONFIG_ZMK_USB) */
+#endif /* IS_ENABLED(CONFIG_ZMK_ENDPOINTS_USB) */
     }
 
     case ZMK_TRANSPORT_BLE: {
-#if IS_ENABLED(CONFIG_ZMK_BLE)
+#if IS_ENABLED(CONFIG_ZMK_ENDPOINTS_BLE)
         struct zmk_hid_consumer_report *consumer_report = zmk_hid_get_consumer_report();
         int err = zmk_hog_send_consumer_report(&consumer_report->body);
         if (err) {
             LOG_ERR("FAILED TO SEND OVER HOG: %d", err);
+            return err;
         }
-        return err;
+        break;
 #else
         LOG_ERR("BLE HOG endpoint is not supported");
         return -ENOTSUP;
-#endif /* IS_ENABLED(CONFIG_ZMK_BLE) */
+#endif /* IS_ENABLED(CONFIG_ZMK_ENDPOINTS_BLE) */
     }
+
+    default:
+        LOG_ERR("Unhandled endpoint transport %d", endpoint.transport);
+        return -ENOTSUP;
     }
 
-    LOG_ERR("Unhandled endpoint transport %d", current_instance.transport);
-    return -ENOTSUP;
+#if IS_ENABLED(CONFIG_ZMK_ENDPOINTS_REPORT_SNAPSHOTS)
+    get_snapshot(endpoint)->consumer = zmk_hid_get_consumer_report()->body;
+#endif
+
+    return 0;
+}
+
+#if IS_ENABLED(CONFIG_ZMK_ENDPOINTS_MIRROR)
+
+static bool is_usb_ready(void);
+static bool is_ble_ready(void);
+
+// Gets the endpoint on the other transport, if it's ready to receive mirrored reports.
+static bool get_mirror_instance(struct zmk_endpoint_instance *mirror) {
+    switch (current_instance.transport) {
+    case ZMK_TRANSPORT_USB:
+        if (!is_ble_ready()) {
+            return false;
+        }
+
+        *mirror = (struct zmk_endpoint_instance){.transport = ZMK_TRANSPORT_BLE};
+#if IS_ENABLED(CONFIG_ZMK_ENDPOINTS_BLE)
+        mirror->ble.profile_index = zmk_ble_active_profile_index();
+#endif // IS_ENABLED(CONFIG_ZMK_ENDPOINTS_BLE)
+        return true;
+
+    case ZMK_TRANSPORT_BLE:
+        if (!is_usb_ready()) {
+            return false;
+        }
+
+        *mirror = (struct zmk_endpoint_instance){.transport = ZMK_TRANSPORT_USB};
+        return true;
+    }
+
+    return false;
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_ENDPOINTS_MIRROR)
+
+static int send_keyboard_report(void) {
+    int err = send_keyboard_report_to(current_instance);
+
+#if IS_ENABLED(CONFIG_ZMK_ENDPOINTS_MIRROR)
+    struct zmk_endpoint_instance mirror;
+    if (get_mirror_instance(&mirror)) {
+        send_keyboard_report_to(mirror);
+    }
+#endif // IS_ENABLED(CONFIG_ZMK_ENDPOINTS_MIRROR)
+
+    return err;
+}
+
+static int send_consumer_report(void) {
+    int err = send_consumer_report_to(current_instance);
+
+#if IS_ENABLED(CONFIG_ZMK_ENDPOINTS_MIRROR)
+    struct zmk_endpoint_instance mirror;
+    if (get_mirror_instance(&mirror)) {
+        send_consumer_report_to(mirror);
+    }
+#endif // IS_ENABLED(CONFIG_ZMK_ENDPOINTS_MIRROR)
+
+    return err;
 }
 
 int zmk_endpoints_send_report(uint16_t usage_page) {
@@ -202,11 +305,15 @@ int zmk_endpoints_send_report(uint16_t usage_page) {
 }
 
 #if IS_ENABLED(CONFIG_ZMK_POINTING)
-int zmk_endpoints_send_mouse_report() {
-    switch (current_instance.transport) {
+static int send_mouse_report_to(struct zmk_endpoint_instance endpoint) {
+    switch (endpoint.transport) {
     case ZMK_TRANSPORT_USB: {
-#if IS_ENABLED(CONFIG_ZMK_USB)
+#if IS_ENABLED(CONFIG_ZMK_ENDPOINTS_USB)
         int err = zmk_usb_hid_send_mouse_report();
+        if (err == -EAGAIN) {
+            LOG_DBG("USB is suspended, waking the host");
+            return err;
+        }
         if (err) {
             LOG_ERR("FAILED TO SEND OVER USB: %d", err);
         }
@@ -214,11 +321,11 @@ int zmk_endpoints_send_mouse_report() {
 #else
         LOG_ERR("USB endpoint is not supported");
         return -ENOTSUP;
-#endif /* IS_ENABLED(CONFIG_ZMK_USB) */
+#endif /* IS_ENABLED(CONFIG_ZMK_ENDPOINTS_USB) */
     }
 
     case ZMK_TRANSPORT_BLE: {
-#if IS_ENABLED(CONFIG_ZMK_BLE)
+#if IS_ENABLED(CONFIG_ZMK_ENDPOINTS_BLE)
         struct zmk_hid_mouse_report *mouse_report = zmk_hid_get_mouse_report();
         int err = zmk_hog_send_mouse_report(&mouse_report->body);
         if (err) {
@@ -228,13 +335,26 @@ int zmk_endpoints_send_mouse_report() {
 #else
         LOG_ERR("BLE HOG endpoint is not supported");
         return -ENOTSUP;
-#endif /* IS_ENABLED(CONFIG_ZMK_BLE) */
+#endif /* IS_ENABLED(CONFIG_ZMK_ENDPOINTS_BLE) */
     }
     }
 
-    LOG_ERR("Unhandled endpoint transport %d", current_instance.transport);
+    LOG_ERR("Unhandled endpoint transport %d", endpoint.transport);
     return -ENOTSUP;
 }
+
+int zmk_endpoints_send_mouse_report() {
+    int err = send_mouse_report_to(current_instance);
+
+#if IS_ENABLED(CONFIG_ZMK_ENDPOINTS_MIRROR)
+    struct zmk_endpoint_instance mirror;
+    if (get_mirror_instance(&mirror)) {
+        send_mouse_report_to(mirror);
+    }
+#endif // IS_ENABLED(CONFIG_ZMK_ENDPOINTS_MIRROR)
+
+    return err;
+}
 #endif // IS_ENABLED(CONFIG_ZMK_POINTING)
 
 #if IS_ENABLED(CONFIG_SETTINGS)
@@ -266,7 +386,7 @@ SETTINGS_STATIC_HANDLER_DEFINE(endpoints, "endpoints", NULL, endpoints_handle_se
 #endif /* IS_ENABLED(CONFIG_SETTINGS) */
 
 static bool is_usb_ready(void) {
-#if IS_ENABLED(CONFIG_ZMK_USB)
+#if IS_ENABLED(CONFIG_ZMK_ENDPOINTS_USB)
     return zmk_usb_is_hid_ready();
 #else
     return false;
@@ -274,13 +394,29 @@ static bool is_usb_ready(void) {
 }
 
 static bool is_ble_ready(void) {
-#if IS_ENABLED(CONFIG_ZMK_BLE)
+#if IS_ENABLED(CONFIG_ZMK_ENDPOINTS_BLE)
     return zmk_ble_active_profile_is_connected();
 #else
     return false;
 #endif
 }
 
+#if IS_ENABLED(CONFIG_ZMK_ENDPOINTS_REPORT_SNAPSHOTS)
+
+static bool is_transport_ready(enum zmk_transport transport) {
+    switch (transport) {
+    case ZMK_TRANSPORT_USB:
+        return is_usb_ready();
+
+    case ZMK_TRANSPORT_BLE:
+        return is_ble_ready();
+    }
+
+    return false;
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_ENDPOINTS_REPORT_SNAPSHOTS)
+
 static enum zmk_transport get_selected_transport(void) {
     if (is_ble_ready()) {
         if (is_usb_ready()) {
@@ -305,11 +441,11 @@ static struct zmk_endpoint_instance get_selected_instance(void) {
     struct zmk_endpoint_instance instance = {.transport = get_selected_transport()};
 
     switch (instance.transport) {
-#if IS_ENABLED(CONFIG_ZMK_BLE)
+#if IS_ENABLED(CONFIG_ZMK_ENDPOINTS_BLE)
     case ZMK_TRANSPORT_BLE:
         instance.ble.profile_index = zmk_ble_active_profile_index();
         break;
-#endif // IS_ENABLED(CONFIG_ZMK_BLE)
+#endif // IS_ENABLED(CONFIG_ZMK_ENDPOINTS_BLE)
 
     default:
         // No extra data for this transport.
@@ -340,14 +476,109 @@ void zmk_endpoints_clear_current(void) {
     zmk_endpoints_send_report(HID_USAGE_CONSUMER);
 }
 
+#if IS_ENABLED(CONFIG_ZMK_ENDPOINTS_REPORT_SNAPSHOTS)
+
+// Sends the current HID state to an endpoint, but only the reports that differ from what it has.
+static void catch_up_endpoint(struct zmk_endpoint_instance endpoint) {
+    struct endpoint_report_snapshot *snapshot = get_snapshot(endpoint);
+
+    if (memcmp(&snapshot->keyboard, &zmk_hid_get_keyboard_report()->body,
+               sizeof(snapshot->keyboard)) != 0) {
+        send_keyboard_report_to(endpoint);
+    }
+
+    if (memcmp(&snapshot->consumer, &zmk_hid_get_consumer_report()->body,
+               sizeof(snapshot->consumer)) != 0) {
+        send_consumer_report_to(endpoint);
+    }
+}
+
+// Forget what endpoints that went away had, so they are caught up when they return.
+static void reset_unready_snapshots(void) {
+#if IS_ENABLED(CONFIG_ZMK_ENDPOINTS_USB)
+    if (!is_usb_ready()) {
+        memset(get_snapshot((struct zmk_endpoint_instance){.transport = ZMK_TRANSPORT_USB}), 0,
+               sizeof(struct endpoint_report_snapshot));
+    }
+#endif // IS_ENABLED(CONFIG_ZMK_ENDPOINTS_USB)
+
+#if IS_ENABLED(CONFIG_ZMK_ENDPOINTS_BLE)
+    for (int i = 0; i < ZMK_ENDPOINT_BLE_COUNT; i++) {
+        if (zmk_ble_profile_is_connected(i)) {
+            continue;
+        }
+
+        memset(get_snapshot((struct zmk_endpoint_instance){.transport = ZMK_TRANSPORT_BLE,
+                                                           .ble = {.profile_index = i}}),
+               0, sizeof(struct endpoint_report_snapshot));
+    }
+#endif // IS_ENABLED(CONFIG_ZMK_ENDPOINTS_BLE)
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_ENDPOINTS_REPORT_SNAPSHOTS)
+
+#if IS_ENABLED(CONFIG_ZMK_ENDPOINTS_KEEP_HELD_ON_SWITCH)
+
+// Releases everything on the endpoint being switched away from, without touching the HID state.
+static void release_previous_endpoint(struct zmk_endpoint_instance previous) {
+#if IS_ENABLED(CONFIG_ZMK_ENDPOINTS_MIRROR)
+    struct zmk_endpoint_instance mirror;
+    if (get_mirror_instance(&mirror) && zmk_endpoint_instance_eq(mirror, previous)) {
+        // Still receiving mirrored reports, so keep its keys held.
+        return;
+    }
+#endif // IS_ENABLED(CONFIG_ZMK_ENDPOINTS_MIRROR)
+
+    switch (previous.transport) {
+    case ZMK_TRANSPORT_USB:
+#if IS_ENABLED(CONFIG_ZMK_ENDPOINTS_USB)
+        if (is_usb_ready()) {
+            zmk_usb_hid_send_release_all();
+        }
+#endif // IS_ENABLED(CONFIG_ZMK_ENDPOINTS_USB)
+        break;
+
+    case ZMK_TRANSPORT_BLE:
+#if IS_ENABLED(CONFIG_ZMK_ENDPOINTS_BLE)
+        // Reports over HOG always go to the active profile, so the previous host can only be
+        // reached if the profile didn't change.
+        if (previous.ble.profile_index == zmk_ble_active_profile_index() &&
+            zmk_ble_active_profile_is_connected()) {
+            struct zmk_hid_keyboard_report_body keyboard = {0};
+            struct zmk_hid_consumer_report_body consumer = {0};
+
+            zmk_hog_send_keyboard_report(&keyboard);
+            zmk_hog_send_consumer_report(&consumer);
+        }
+#endif // IS_ENABLED(CONFIG_ZMK_ENDPOINTS_BLE)
+        break;
+    }
+
+    memset(get_snapshot(previous), 0, sizeof(struct endpoint_report_snapshot));
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_ENDPOINTS_KEEP_HELD_ON_SWITCH)
+
 static void update_current_endpoint(void) {
     struct zmk_endpoint_instance new_instance = get_selected_instance();
 
+#if IS_ENABLED(CONFIG_ZMK_ENDPOINTS_REPORT_SNAPSHOTS)
+    reset_unready_snapshots();
+#endif
+
     if (!zmk_endpoint_instance_eq(new_instance, current_instance)) {
+#if IS_ENABLED(CONFIG_ZMK_ENDPOINTS_KEEP_HELD_ON_SWITCH)
+        struct zmk_endpoint_instance previous = current_instance;
+
+        current_instance = new_instance;
+
+        release_previous_endpoint(previous);
+#else
         // Cancel all current keypresses so keys don't stay held on the old endpoint.
         zmk_endpoints_clear_current();
 
         current_instance = new_instance;
+#endif // IS_ENABLED(CONFIG_ZMK_ENDPOINTS_KEEP_HELD_ON_SWITCH)
 
         char endpoint_str[ZMK_ENDPOINT_STR_LEN];
         zmk_endpoint_instance_to_str(current_instance, endpoint_str, sizeof(endpoint_str));
@@ -355,6 +586,21 @@ static void update_current_endpoint(void) {
 
         raise_zmk_endpoint_changed((struct zmk_endpoint_changed){.endpoint = current_instance});
     }
+
+#if IS_ENABLED(CONFIG_ZMK_ENDPOINTS_REPORT_SNAPSHOTS)
+    // Bring the selected endpoint up to date after a switch, or after a report failed to go out,
+    // e.g. while USB was waking up the host.
+    if (is_transport_ready(current_instance.transport)) {
+        catch_up_endpoint(current_instance);
+    }
+#endif // IS_ENABLED(CONFIG_ZMK_ENDPOINTS_REPORT_SNAPSHOTS)
+
+#if IS_ENABLED(CONFIG_ZMK_ENDPOINTS_MIRROR)
+    struct zmk_endpoint_instance mirror;
+    if (get_mirror_instance(&mirror)) {
+        catch_up_endpoint(mirror);
+    }
+#endif // IS_ENABLED(CONFIG_ZMK_ENDPOINTS_MIRROR)
 }
 
 static int endpoint_listener(const zmk_event_t *eh) {
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2025 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+// Stands in for the USB and BLE HID transports on native_posix. USB and BLE profile 0 are always
+// ready, and each report is logged instead of sent so tests can check what each endpoint receives.
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/util.h>
+
+#include <zmk/ble.h>
+#include <zmk/endpoints.h>
+#include <zmk/hid.h>
+#include <zmk/hog.h>
+#include <zmk/usb.h>
+#include <zmk/usb_hid.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#define MOCK_REPORT_MAX_LEN                                                                        \
+    MAX(sizeof(struct zmk_hid_keyboard_report_body), sizeof(struct zmk_hid_consumer_report_body))
+
+static void mock_send_report(enum zmk_transport transport, const char *name, const void *body,
+                             size_t len) {
+    struct zmk_endpoint_instance endpoint = {.transport = transport};
+    char endpoint_str[ZMK_ENDPOINT_STR_LEN];
+    char hex[2 * MOCK_REPORT_MAX_LEN + 1];
+
+    zmk_endpoint_instance_to_str(endpoint, endpoint_str, sizeof(endpoint_str));
+    bin2hex(body, MIN(len, MOCK_REPORT_MAX_LEN), hex, sizeof(hex));
+    LOG_DBG("%s %s report %s", endpoint_str, name, hex);
+}
+
+bool zmk_usb_is_hid_ready(void) { return true; }
+
+int zmk_usb_hid_send_keyboard_report(void) {
+    mock_send_report(ZMK_TRANSPORT_USB, "keyboard", &zmk_hid_get_keyboard_report()->body,
+                     sizeof(struct zmk_hid_keyboard_report_body));
+    return 0;
+}
+
+int zmk_usb_hid_send_consumer_report(void) {
+    mock_send_report(ZMK_TRANSPORT_USB, "consumer", &zmk_hid_get_consumer_report()->body,
+                     sizeof(struct zmk_hid_consumer_report_body));
+    return 0;
+}
+
+int zmk_usb_hid_send_release_all(void) {
+    struct zmk_hid_keyboard_report_body keyboard = {0};
+    struct zmk_hid_consumer_report_body consumer = {0};
+
+    mock_send_report(ZMK_TRANSPORT_USB, "keyboard", &keyboard, sizeof(keyboard));
+    mock_send_report(ZMK_TRANSPORT_USB, "consumer", &consumer, sizeof(consumer));
+    return 0;
+}
+
+int zmk_ble_active_profile_index(void) { return 0; }
+
+bool zmk_ble_profile_is_connected(uint8_t index) { return index == 0; }
+
+bool zmk_ble_active_profile_is_connected(void) { return true; }
+
+int zmk_hog_send_keyboard_report(struct zmk_hid_keyboard_report_body *body) {
+    mock_send_report(ZMK_TRANSPORT_BLE, "keyboard", body, sizeof(*body));
+    return 0;
+}
+
+int zmk_hog_send_consumer_report(struct zmk_hid_consumer_report_body *body) {
+    mock_send_report(ZMK_TRANSPORT_BLE, "consumer", body, sizeof(*body));
+    return 0;
+}
+
+#if IS_ENABLED(CONFIG_ZMK_POINTING)
+
+int zmk_usb_hid_send_mouse_report(void) { return 0; }
+
+int zmk_hog_send_mouse_report(struct zmk_hid_mouse_report_body *body) { return 0; }
+
+#endif // IS_ENABLED(CONFIG_ZMK_POINTING)
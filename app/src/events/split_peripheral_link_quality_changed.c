@@ -0,0 +1,10 @@
+/*
+ * Copyright (c) 2025 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+#include <zmk/events/split_peripheral_link_quality_changed.h>
+
+ZMK_EVENT_IMPL(zmk_split_peripheral_link_quality_changed);
@@ -22,6 +22,8 @@ static struct zmk_hid_consumer_report consumer_report = {.report_id = ZMK_HID_RE
 
 static zmk_hid_boot_report_t boot_report = {.modifiers = 0, ._reserved = 0, .keys = {0}};
 static uint8_t keys_held = 0;
+// Set whenever the keyboard report keys change, so the boot report is only rebuilt when needed.
+static bool boot_report_stale = true;
 
 #endif /* IS_ENABLED(CONFIG_ZMK_USB_BOOT) */
 
@@ -38,6 +40,19 @@ static struct zmk_hid_mouse_report mouse_report = {
 static int explicit_modifier_counts[8] = {0, 0, 0, 0, 0, 0, 0, 0};
 static zmk_mod_flags_t explicit_modifiers = 0;
 static zmk_mod_flags_t implicit_modifiers = 0;
+
+// Held usages in the order they were pressed, each with its implicit modifiers and how many
+// presses of it are still held. The most recently pressed owner's implicit modifiers apply.
+#define IMPLICIT_MODIFIER_OWNERS_MAX 16
+
+struct implicit_modifier_owner {
+    uint32_t usage;
+    zmk_mod_flags_t modifiers;
+    uint8_t count;
+};
+
+static struct implicit_modifier_owner implicit_modifier_owners[IMPLICIT_MODIFIER_OWNERS_MAX];
+static uint8_t implicit_modifier_owners_len = 0;
 static zmk_mod_flags_t masked_modifiers = 0;
 
 #define SET_MODIFIERS(mods)                                                                        \
@@ -108,9 +123,16 @@ static zmk_hid_boot_report_t *boot_report_rollover(uint8_t modifiers) {
     for (int i = 0; i < HID_BOOT_KEY_LEN; i++) {
         boot_report.keys[i] = HID_ERROR_ROLLOVER;
     }
+    boot_report_stale = true;
     return &boot_report;
 }
 
+#define MARK_BOOT_REPORT_STALE() (boot_report_stale = true)
+
+#else
+
+#define MARK_BOOT_REPORT_STALE()
+
 #endif /* IS_ENABLED(CONFIG_ZMK_USB_BOOT) */
 
 #if IS_ENABLED(CONFIG_ZMK_HID_REPORT_TYPE_NKRO)
@@ -124,6 +146,10 @@ zmk_hid_boot_report_t *zmk_hid_get_boot_report(void) {
     }
 
     boot_report.modifiers = keyboard_report.body.modifiers;
+    if (!boot_report_stale) {
+        return &boot_report;
+    }
+
     memset(&boot_report.keys, 0, HID_BOOT_KEY_LEN);
     int ix = 0;
     uint8_t base_code = 0;
@@ -141,6 +167,7 @@ zmk_hid_boot_report_t *zmk_hid_get_boot_report(void) {
             }
         }
     }
+    boot_report_stale = false;
     return &boot_report;
 }
 #endif
@@ -153,6 +180,7 @@ static inline int select_keyboard_usage(zmk_key_t usage) {
 #if IS_ENABLED(CONFIG_ZMK_USB_BOOT)
     ++keys_held;
 #endif
+    MARK_BOOT_REPORT_STALE();
     return 0;
 }
 
@@ -164,6 +192,7 @@ static inline int deselect_keyboard_usage(zmk_key_t usage) {
 #if IS_ENABLED(CONFIG_ZMK_USB_BOOT)
     --keys_held;
 #endif
+    MARK_BOOT_REPORT_STALE();
     return 0;
 }
 
@@ -176,16 +205,15 @@ static inline bool check_keyboard_usage(zmk_key_t usage) {
 
 #elif IS_ENABLED(CONFIG_ZMK_HID_REPORT_TYPE_HKRO)
 
-#define TOGGLE_KEYBOARD(match, val)                                                                \
-    for (int idx = 0; idx < CONFIG_ZMK_HID_KEYBOARD_REPORT_SIZE; idx++) {                          \
-        if (keyboard_report.body.keys[idx] != match) {                                             \
-            continue;                                                                              \
-        }                                                                                          \
-        keyboard_report.body.keys[idx] = val;                                                      \
-        if (val) {                                                                                 \
-            break;                                                                                 \
-        }                                                                                          \
-    }
+BUILD_ASSERT(CONFIG_ZMK_HID_KEYBOARD_REPORT_SIZE <= 64,
+             "HKRO keyboard reports support at most 64 keys");
+
+#define KEYBOARD_ALL_SLOTS_FREE GENMASK64(CONFIG_ZMK_HID_KEYBOARD_REPORT_SIZE - 1, 0)
+
+// Slot index + 1 of every usage currently in the report, 0 if the usage isn't in the report.
+static uint8_t keyboard_usage_slots[UINT8_MAX + 1];
+// Bit N is set while keyboard_report.body.keys[N] is empty.
+static uint64_t keyboard_free_slots = KEYBOARD_ALL_SLOTS_FREE;
 
 #if IS_ENABLED(CONFIG_ZMK_USB_BOOT)
 zmk_hid_boot_report_t *zmk_hid_get_boot_report(void) {
@@ -197,6 +225,9 @@ zmk_hid_boot_report_t *zmk_hid_get_boot_report(void) {
     // Form a boot report from a report of different size.
 
     boot_report.modifiers = keyboard_report.body.modifiers;
+    if (!boot_report_stale) {
+        return &boot_report;
+    }
 
     int out = 0;
     for (int i = 0; i < CONFIG_ZMK_HID_KEYBOARD_REPORT_SIZE; i++) {
@@ -213,6 +244,7 @@ zmk_hid_boot_report_t *zmk_hid_get_boot_report(void) {
         boot_report.keys[out++] = 0;
     }
 
+    boot_report_stale = false;
     return &boot_report;
 #else
     return &keyboard_report.body;
@@ -221,28 +253,54 @@ zmk_hid_boot_report_t *zmk_hid_get_boot_report(void) {
 #endif /* IS_ENABLED(CONFIG_ZMK_USB_BOOT) */
 
 static inline int select_keyboard_usage(zmk_key_t usage) {
-    TOGGLE_KEYBOARD(0U, usage);
+    if (usage == 0 || usage > UINT8_MAX) {
+        return -EINVAL;
+    }
+
+    if (keyboard_usage_slots[usage]) {
+        return 0;
+    }
+
+    if (!keyboard_free_slots) {
+        LOG_DBG("No free slot for usage 0x%02X", usage);
+        return 0;
+    }
+
+    uint8_t slot = __builtin_ctzll(keyboard_free_slots);
+
+    keyboard_free_slots &= ~BIT64(slot);
+    keyboard_usage_slots[usage] = slot + 1;
+    keyboard_report.body.keys[slot] = usage;
 #if IS_ENABLED(CONFIG_ZMK_USB_BOOT)
     ++keys_held;
 #endif
+    MARK_BOOT_REPORT_STALE();
+
+    LOG_DBG("Usage 0x%02X added to slot %d", usage, slot);
     return 0;
 }
 
 static inline int deselect_keyboard_usage(zmk_key_t usage) {
-    TOGGLE_KEYBOARD(usage, 0U);
+    if (usage == 0 || usage > UINT8_MAX || !keyboard_usage_slots[usage]) {
+        return 0;
+    }
+
+    uint8_t slot = keyboard_usage_slots[usage] - 1;
+
+    keyboard_usage_slots[usage] = 0;
+    keyboard_free_slots |= BIT64(slot);
+    keyboard_report.body.keys[slot] = 0;
 #if IS_ENABLED(CONFIG_ZMK_USB_BOOT)
     --keys_held;
 #endif
+    MARK_BOOT_REPORT_STALE();
+
+    LOG_DBG("Usage 0x%02X removed from slot %d", usage, slot);
     return 0;
 }
 
 static inline int check_keyboard_usage(zmk_key_t usage) {
-    for (int idx = 0; idx < CONFIG_ZMK_HID_KEYBOARD_REPORT_SIZE; idx++) {
-        if (keyboard_report.body.keys[idx] == usage) {
-            return true;
-        }
-    }
-    return false;
+    return usage <= UINT8_MAX && keyboard_usage_slots[usage] != 0;
 }
 
 #else
@@ -263,15 +321,78 @@ static inline int check_keyboard_usage(zmk_key_t usage) {
         }                                                                                          \
     }
 
-int zmk_hid_implicit_modifiers_press(zmk_mod_flags_t new_implicit_modifiers) {
-    implicit_modifiers = new_implicit_modifiers;
+static int find_implicit_modifier_owner(uint32_t usage) {
+    for (int i = 0; i < implicit_modifier_owners_len; i++) {
+        if (implicit_modifier_owners[i].usage == usage) {
+            return i;
+        }
+    }
+
+    return -ENOENT;
+}
+
+static void remove_implicit_modifier_owner(int idx) {
+    memmove(&implicit_modifier_owners[idx], &implicit_modifier_owners[idx + 1],
+            (implicit_modifier_owners_len - idx - 1) * sizeof(implicit_modifier_owners[0]));
+    implicit_modifier_owners_len--;
+}
+
+static zmk_mod_flags_t top_implicit_modifiers(void) {
+    if (implicit_modifier_owners_len == 0) {
+        return 0;
+    }
+
+    return implicit_modifier_owners[implicit_modifier_owners_len - 1].modifiers;
+}
+
+int zmk_hid_implicit_modifiers_press(uint32_t usage, zmk_mod_flags_t new_implicit_modifiers) {
+    struct implicit_modifier_owner owner = {.usage = usage, .count = 0};
+    int idx = find_implicit_modifier_owner(usage);
+
+    if (idx >= 0) {
+        owner = implicit_modifier_owners[idx];
+        remove_implicit_modifier_owner(idx);
+    } else if (implicit_modifier_owners_len == IMPLICIT_MODIFIER_OWNERS_MAX) {
+        LOG_WRN("Too many held keys to track implicit modifiers, forgetting the oldest");
+        remove_implicit_modifier_owner(0);
+    }
+
+    // The latest press of a usage decides its implicit modifiers and makes it the newest owner.
+    owner.modifiers = new_implicit_modifiers;
+    owner.count++;
+    implicit_modifier_owners[implicit_modifier_owners_len++] = owner;
+
+    implicit_modifiers = top_implicit_modifiers();
     zmk_mod_flags_t current = GET_MODIFIERS;
     SET_MODIFIERS(explicit_modifiers);
     return current == GET_MODIFIERS ? 0 : 1;
 }
 
-int zmk_hid_implicit_modifiers_release(void) {
-    implicit_modifiers = 0;
+static zmk_mod_flags_t implicit_modifiers_after_release(uint32_t usage) {
+    int idx = find_implicit_modifier_owner(usage);
+
+    if (idx < 0 || implicit_modifier_owners[idx].count > 1 ||
+        idx != implicit_modifier_owners_len - 1) {
+        return implicit_modifiers;
+    }
+
+    return idx > 0 ? implicit_modifier_owners[idx - 1].modifiers : 0;
+}
+
+bool zmk_hid_implicit_modifiers_release_changes(uint32_t usage) {
+    return ((explicit_modifiers & ~masked_modifiers) | implicit_modifiers_after_release(usage)) !=
+           GET_MODIFIERS;
+}
+
+int zmk_hid_implicit_modifiers_release(uint32_t usage) {
+    int idx = find_implicit_modifier_owner(usage);
+
+    if (idx >= 0 && --implicit_modifier_owners[idx].count == 0) {
+        remove_implicit_modifier_owner(idx);
+    }
+
+    // Releasing the newest owner puts back the implicit modifiers of the key pressed before it.
+    implicit_modifiers = top_implicit_modifiers();
     zmk_mod_flags_t current = GET_MODIFIERS;
     SET_MODIFIERS(explicit_modifiers);
     return current == GET_MODIFIERS ? 0 : 1;
@@ -316,6 +437,14 @@ bool zmk_hid_keyboard_is_pressed(zmk_key_t code) {
 
 void zmk_hid_keyboard_clear(void) {
     memset(&keyboard_report.body, 0, sizeof(keyboard_report.body));
+#if IS_ENABLED(CONFIG_ZMK_HID_REPORT_TYPE_HKRO)
+    memset(keyboard_usage_slots, 0, sizeof(keyboard_usage_slots));
+    keyboard_free_slots = KEYBOARD_ALL_SLOTS_FREE;
+#if IS_ENABLED(CONFIG_ZMK_USB_BOOT)
+    keys_held = 0;
+#endif
+#endif
+    MARK_BOOT_REPORT_STALE();
 }
 
 int zmk_hid_consumer_press(zmk_key_t code) {
@@ -42,7 +42,8 @@ static int hid_listener_keycode_pressed(const struct zmk_keycode_state_changed *
         return err;
     }
     explicit_mods_changed = zmk_hid_register_mods(ev->explicit_modifiers);
-    implicit_mods_changed = zmk_hid_implicit_modifiers_press(ev->implicit_modifiers);
+    implicit_mods_changed = zmk_hid_implicit_modifiers_press(
+        ZMK_HID_USAGE(ev->usage_page, ev->keycode), ev->implicit_modifiers);
     if (ev->usage_page != HID_USAGE_KEY &&
         (explicit_mods_changed > 0 || implicit_mods_changed > 0)) {
         err = zmk_endpoints_send_report(HID_USAGE_KEY);
@@ -57,10 +58,11 @@ static int hid_listener_keycode_pressed(const struct zmk_keycode_state_changed *
 
 static int hid_listener_keycode_released(const struct zmk_keycode_state_changed *ev) {
     int err, explicit_mods_changed, implicit_mods_changed;
+    uint32_t usage = ZMK_HID_USAGE(ev->usage_page, ev->keycode);
 
     LOG_DBG("usage_page 0x%02X keycode 0x%02X implicit_mods 0x%02X explicit_mods 0x%02X",
             ev->usage_page, ev->keycode, ev->implicit_modifiers, ev->explicit_modifiers);
-    err = zmk_hid_release(ZMK_HID_USAGE(ev->usage_page, ev->keycode));
+    err = zmk_hid_release(usage);
     if (err < 0) {
         LOG_DBG("Unable to release keycode");
         return err;
@@ -69,21 +71,19 @@ static int hid_listener_keycode_released(const struct zmk_keycode_state_changed
 #if IS_ENABLED(CONFIG_ZMK_HID_SEPARATE_MOD_RELEASE_REPORT)
 
     // send report of normal key release early to fix the issue
-    // of some programs recognizing the implicit_mod release before the actual key release
-    err = zmk_endpoints_send_report(ev->usage_page);
-    if (err < 0) {
-        LOG_ERR("Failed to send key report for the released keycode (%d)", err);
+    // of some programs recognizing the implicit_mod release before the actual key release.
+    // Only needed when this release is going to change the modifiers.
+    if (ev->explicit_modifiers || zmk_hid_implicit_modifiers_release_changes(usage)) {
+        err = zmk_endpoints_send_report(ev->usage_page);
+        if (err < 0) {
+            LOG_ERR("Failed to send key report for the released keycode (%d)", err);
+        }
     }
 
 #endif // IS_ENABLED(CONFIG_ZMK_HID_SEPARATE_MOD_RELEASE_REPORT)
 
     explicit_mods_changed = zmk_hid_unregister_mods(ev->explicit_modifiers);
-    // There is a minor issue with this code.
-    // If LC(A) is pressed, then LS(B), then LC(A) is released, the shift for B will be released
-    // prematurely. This causes if LS(B) to repeat like Bbbbbbbb when pressed for a long time.
-    // Solving this would require keeping track of which key's implicit modifiers are currently
-    // active and only releasing modifiers at that time.
-    implicit_mods_changed = zmk_hid_implicit_modifiers_release();
+    implicit_mods_changed = zmk_hid_implicit_modifiers_release(usage);
 
     if (ev->usage_page != HID_USAGE_KEY &&
         (explicit_mods_changed > 0 || implicit_mods_changed > 0)) {
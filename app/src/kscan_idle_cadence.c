@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2025 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/init.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <zmk/activity.h>
+#include <zmk/event_manager.h>
+#include <zmk/events/activity_state_changed.h>
+#include <zmk/events/position_state_changed.h>
+#include <zmk/kscan_cadence.h>
+
+static void set_tier(enum zmk_kscan_cadence_tier tier) {
+    if (tier == zmk_kscan_cadence_get_tier()) {
+        return;
+    }
+
+    zmk_kscan_cadence_set_tier(tier);
+
+    struct zmk_kscan_cadence_stats stats;
+    zmk_kscan_cadence_get_stats(&stats);
+
+    LOG_DBG("kscan cadence %s, %lld ms typing, %lld ms slow, %lld ms idle",
+            zmk_kscan_cadence_tier_name(stats.tier), stats.time_ms[ZMK_KSCAN_CADENCE_TYPING],
+            stats.time_ms[ZMK_KSCAN_CADENCE_SLOW], stats.time_ms[ZMK_KSCAN_CADENCE_IDLE]);
+}
+
+static void slow_work_handler(struct k_work *work) {
+    if (zmk_kscan_cadence_get_tier() == ZMK_KSCAN_CADENCE_TYPING) {
+        set_tier(ZMK_KSCAN_CADENCE_SLOW);
+    }
+}
+
+static K_WORK_DELAYABLE_DEFINE(slow_work, slow_work_handler);
+
+static void note_typing(void) {
+    set_tier(ZMK_KSCAN_CADENCE_TYPING);
+    k_work_reschedule(&slow_work, K_MSEC(CONFIG_ZMK_KSCAN_IDLE_CADENCE_SLOW_AFTER_MS));
+}
+
+static int kscan_idle_cadence_listener(const zmk_event_t *eh) {
+    const struct zmk_activity_state_changed *activity = as_zmk_activity_state_changed(eh);
+
+    if (activity && activity->state != ZMK_ACTIVITY_ACTIVE) {
+        k_work_cancel_delayable(&slow_work);
+        set_tier(ZMK_KSCAN_CADENCE_IDLE);
+    } else {
+        // Any key press, or other activity waking the keyboard from idle.
+        note_typing();
+    }
+
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(kscan_idle_cadence, kscan_idle_cadence_listener);
+ZMK_SUBSCRIPTION(kscan_idle_cadence, zmk_activity_state_changed);
+ZMK_SUBSCRIPTION(kscan_idle_cadence, zmk_position_state_changed);
+
+static int kscan_idle_cadence_init(void) {
+    note_typing();
+    return 0;
+}
+
+SYS_INIT(kscan_idle_cadence_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
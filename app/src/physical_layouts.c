@@ -22,6 +22,7 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 #include <zmk/physical_layouts.h>
 #include <zmk/event_manager.h>
 #include <zmk/events/position_state_changed.h>
+#include <zmk/kscan_state.h>
 
 ZMK_EVENT_IMPL(zmk_physical_layout_selection_changed);
 
@@ -180,6 +181,24 @@ static struct zmk_kscan_msg_processor {
 K_MSGQ_DEFINE(physical_layouts_kscan_msgq, sizeof(struct zmk_kscan_event),
               CONFIG_ZMK_KSCAN_EVENT_QUEUE_SIZE, 4);
 
+static atomic_t kscan_dropped_events;
+/** Set when an event is dropped, and cleared once the queue has been drained. */
+static atomic_t kscan_overflowed;
+
+/** Positions reported as pressed by the kscan events processed so far. */
+static ATOMIC_DEFINE(kscan_pressed_positions, ZMK_KEYMAP_LEN);
+
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_EVENT_QUEUE_RESYNC)
+/** Positions the kscan driver lists as pressed during a resync. */
+static ATOMIC_DEFINE(kscan_resync_positions, ZMK_KEYMAP_LEN);
+/** Events that were queued before the last resync, and may already be part of it. */
+static uint32_t kscan_stale_events;
+#endif
+
+uint32_t zmk_physical_layouts_get_kscan_dropped_events(void) {
+    return (uint32_t)atomic_get(&kscan_dropped_events);
+}
+
 static void zmk_physical_layout_kscan_callback(const struct device *dev, uint32_t row,
                                                uint32_t column, bool pressed) {
     if (dev != active->kscan) {
@@ -191,10 +210,65 @@ static void zmk_physical_layout_kscan_callback(const struct device *dev, uint32_
         .column = column,
         .state = (pressed ? ZMK_KSCAN_EVENT_STATE_PRESSED : ZMK_KSCAN_EVENT_STATE_RELEASED)};
 
-    k_msgq_put(&physical_layouts_kscan_msgq, &ev, K_NO_WAIT);
+    if (k_msgq_put(&physical_layouts_kscan_msgq, &ev, K_NO_WAIT) != 0) {
+        atomic_inc(&kscan_dropped_events);
+        atomic_set(&kscan_overflowed, true);
+    }
+
     k_work_submit(&msg_processor.work);
 }
 
+static void zmk_physical_layouts_raise_position(int32_t position, bool pressed) {
+    atomic_set_bit_to(kscan_pressed_positions, position, pressed);
+
+    raise_zmk_position_state_changed(
+        (struct zmk_position_state_changed){.source = ZMK_POSITION_STATE_CHANGE_SOURCE_LOCAL,
+                                            .state = pressed,
+                                            .position = position,
+                                            .timestamp = k_uptime_get()});
+}
+
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_EVENT_QUEUE_RESYNC)
+
+static void zmk_physical_layouts_kscan_state_cb(const struct device *dev, uint32_t row,
+                                                uint32_t column, void *user_data) {
+    int32_t position =
+        zmk_matrix_transform_row_column_to_position(active->matrix_transform, row, column);
+
+    if (position >= 0) {
+        atomic_set_bit(kscan_resync_positions, position);
+    }
+}
+
+/**
+ * Raise position events for every key whose state differs from what the kscan driver currently
+ * reports, to make up for dropped events.
+ */
+static void zmk_physical_layouts_kscan_resync(void) {
+    int err = zmk_kscan_get_state(active->kscan, zmk_physical_layouts_kscan_state_cb, NULL);
+    if (err) {
+        LOG_ERR("Unable to get the current state of %s to resync keys: %d", active->kscan->name,
+                err);
+        for (int i = 0; i < ARRAY_SIZE(kscan_resync_positions); i++) {
+            atomic_clear(&kscan_resync_positions[i]);
+        }
+        return;
+    }
+
+    kscan_stale_events = k_msgq_num_used_get(&physical_layouts_kscan_msgq);
+
+    for (int i = 0; i < ZMK_KEYMAP_LEN; i++) {
+        const bool pressed = atomic_test_and_clear_bit(kscan_resync_positions, i);
+
+        if (pressed != atomic_test_bit(kscan_pressed_positions, i)) {
+            LOG_DBG("Resync position: %d, pressed: %s", i, (pressed ? "true" : "false"));
+            zmk_physical_layouts_raise_position(i, pressed);
+        }
+    }
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_KSCAN_EVENT_QUEUE_RESYNC)
+
 static void zmk_physical_layouts_kscan_process_msgq(struct k_work *item) {
     struct zmk_kscan_event ev;
 
@@ -203,19 +277,38 @@ static void zmk_physical_layouts_kscan_process_msgq(struct k_work *item) {
         int32_t position = zmk_matrix_transform_row_column_to_position(active->matrix_transform,
                                                                        ev.row, ev.column);
 
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_EVENT_QUEUE_RESYNC)
+        const bool stale = kscan_stale_events > 0;
+        if (stale) {
+            kscan_stale_events--;
+        }
+#endif
+
         if (position < 0) {
             LOG_WRN("Not found in transform: row: %d, col: %d, pressed: %s", ev.row, ev.column,
                     (pressed ? "true" : "false"));
             continue;
         }
 
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_EVENT_QUEUE_RESYNC)
+        // The resync may have already seen this change.
+        if (stale && atomic_test_bit(kscan_pressed_positions, position) == pressed) {
+            continue;
+        }
+#endif
+
         LOG_DBG("Row: %d, col: %d, position: %d, pressed: %s", ev.row, ev.column, position,
                 (pressed ? "true" : "false"));
-        raise_zmk_position_state_changed(
-            (struct zmk_position_state_changed){.source = ZMK_POSITION_STATE_CHANGE_SOURCE_LOCAL,
-                                                .state = pressed,
-                                                .position = position,
-                                                .timestamp = k_uptime_get()});
+        zmk_physical_layouts_raise_position(position, pressed);
+    }
+
+    if (atomic_clear(&kscan_overflowed)) {
+        LOG_WRN("Kscan event queue overflowed, %u events dropped in total",
+                zmk_physical_layouts_get_kscan_dropped_events());
+
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_EVENT_QUEUE_RESYNC)
+        zmk_physical_layouts_kscan_resync();
+#endif
     }
 }
 
@@ -16,15 +16,14 @@
 #include <zephyr/sys/byteorder.h>
 #include <zephyr/net/buf.h>
 
-// ← THÊM: Internal Zephyr headers để lấy connection handle
-#include <zephyr/bluetooth/hci_vs.h>
-
 #include <zephyr/logging/log.h>
 
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
 #include <zmk/stdlib.h>
 #include <zmk/ble.h>
+#include <zmk/ble/link.h>
+#include <drivers/behavior.h>
 #include <zmk/behavior.h>
 #include <zmk/sensors.h>
 #include <zmk/split/transport/central.h>
@@ -34,7 +33,10 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 #include <zmk/events/position_state_changed.h>
 #include <zmk/events/sensor_event.h>
 #include <zmk/events/battery_state_changed.h>
-#include <zmk/events/split_peripheral_rssi_changed.h>  // ← THÊM
+#include <zmk/events/split_peripheral_rssi_changed.h>
+#include <zmk/events/split_peripheral_link_quality_changed.h>
+#include <zmk/events/activity_state_changed.h>
+#include <zmk/activity.h>
 #include <zmk/pointing/input_split.h>
 #include <zmk/hid_indicators_types.h>
 #include <zmk/physical_layouts.h>
@@ -66,10 +68,36 @@ struct peripheral_slot {
 #endif
     uint16_t selected_physical_layout_handle;
     uint16_t wpm_handle;
+    // Last RSSI raised in a zmk_split_peripheral_rssi_changed event
     int8_t last_rssi;
+    bool rssi_reported;
     bt_addr_le_t peripheral_addr;  // ← THÊM: Lưu MAC address của peripheral
     uint8_t position_state[POSITION_STATE_DATA_LEN];
     uint8_t changed_positions[POSITION_STATE_DATA_LEN];
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_POSITION_DELTAS)
+    struct bt_gatt_subscribe_params delta_subscribe_params;
+    struct bt_gatt_read_params position_read_params;
+    uint8_t next_delta_seq;
+    bool delta_seq_valid;
+    bool resync_pending;
+    bool resync_queued;
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_POSITION_DELTAS)
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_COMPACT_BEHAVIORS)
+    uint16_t run_compact_behaviors_handle;
+    struct bt_gatt_read_params behavior_table_read_params;
+    // Peripheral behavior ID for each local behavior, indexed like the behavior section.
+    uint8_t compact_behavior_ids[CONFIG_ZMK_SPLIT_BLE_CENTRAL_COMPACT_BEHAVIORS_MAX];
+    bool compact_behaviors_ready;
+    // Parse state of the behavior table, whose entries can span several read responses. Names
+    // are matched as they arrive: the local behaviors whose names start with the entry so far.
+    ATOMIC_DEFINE(behavior_table_candidates, CONFIG_ZMK_SPLIT_BLE_CENTRAL_COMPACT_BEHAVIORS_MAX);
+    uint16_t behavior_table_name_len;
+    uint8_t behavior_table_next_id;
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_COMPACT_BEHAVIORS)
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_LINK_QUALITY)
+    struct bt_gatt_subscribe_params link_quality_subscribe_params;
+    struct zmk_split_link_quality_payload link_quality;
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_LINK_QUALITY)
 };
 
 #if IS_ENABLED(CONFIG_ZMK_INPUT_SPLIT)
@@ -139,6 +167,12 @@ static bool is_enabled;
 
 static struct peripheral_slot peripherals[ZMK_SPLIT_BLE_PERIPHERAL_COUNT];
 
+// Guards slot state and conn changes against readers on other threads, like RSSI reads.
+static struct k_spinlock peripheral_slot_lock;
+
+ZMK_SPLIT_COMMAND_QUEUE_DEFINE(split_run_queue, ZMK_SPLIT_BLE_PERIPHERAL_COUNT,
+                               CONFIG_ZMK_SPLIT_BLE_CENTRAL_SPLIT_RUN_QUEUE_SIZE);
+
 static bool is_scanning = false;
 
 static const struct bt_uuid_128 split_service_uuid = BT_UUID_INIT_128(ZMK_SPLIT_BT_SERVICE_UUID);
@@ -148,152 +182,188 @@ struct peripheral_event_wrapper {
     struct zmk_split_transport_peripheral_event event;
 };
 
-K_MSGQ_DEFINE(peripheral_event_msgq, sizeof(struct peripheral_event_wrapper),
-              CONFIG_ZMK_SPLIT_BLE_CENTRAL_POSITION_QUEUE_SIZE, 4);
+static void queue_peripheral_event(const struct peripheral_event_wrapper *ev);
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_RSSI)
 
-void peripheral_event_work_callback(struct k_work *work);
+// Readings only run while something displays them and the keyboard is in use.
+static atomic_t rssi_subscribers;
 
-K_WORK_DEFINE(peripheral_event_work, peripheral_event_work_callback);
+K_THREAD_STACK_DEFINE(split_central_rssi_q_stack, CONFIG_ZMK_SPLIT_BLE_CENTRAL_RSSI_STACK_SIZE);
+
+static struct k_work_q split_central_rssi_q;
 
-// ← THÊM: RSSI Reading
 static void read_rssi_work_handler(struct k_work *work);
-K_WORK_DELAYABLE_DEFINE(read_rssi_work, read_rssi_work_handler);
-
-#define RSSI_READ_INTERVAL_MS 500
-
-// ← THÊM: Helper để lấy HCI connection handle từ bt_conn
-// Zephyr không expose handle ra public API, cần dùng trick này
-static uint16_t get_conn_handle(struct bt_conn *conn) {
-    // bt_conn_index() returns array index (0, 1, 2...)
-    // HCI handle thường là index + offset
-    // Offset phụ thuộc vào Zephyr version, thường là 0x80 hoặc connection được assign tuần tự
-    
-    // Workaround: Dùng bt_conn_get_info để verify connection
-    struct bt_conn_info info;
-    int err = bt_conn_get_info(conn, &info);
-    if (err) {
-        return 0;
+
+static K_WORK_DELAYABLE_DEFINE(read_rssi_work, read_rssi_work_handler);
+
+// Readings waiting to be raised from the system work queue, guarded by peripheral_slot_lock.
+static struct {
+    int8_t rssi;
+    bool pending;
+} rssi_readings[ZMK_SPLIT_BLE_PERIPHERAL_COUNT];
+
+static void raise_rssi_work_handler(struct k_work *work);
+
+static K_WORK_DEFINE(raise_rssi_work, raise_rssi_work_handler);
+
+static void schedule_rssi_read(k_timeout_t delay) {
+    if (atomic_get(&rssi_subscribers) == 0 || zmk_activity_get_state() != ZMK_ACTIVITY_ACTIVE) {
+        return;
+    }
+
+    k_work_schedule_for_queue(&split_central_rssi_q, &read_rssi_work, delay);
+}
+
+void zmk_split_central_rssi_subscribe(void) {
+    if (atomic_inc(&rssi_subscribers) == 0) {
+        schedule_rssi_read(K_NO_WAIT);
     }
-    
-    // Connection handle thường bắt đầu từ 0x0000-0x0EFF (BLE spec)
-    // ZMK thường chỉ có 1-2 connections, handle sẽ là 0, 1, hoặc 0x80, 0x81
-    uint8_t idx = bt_conn_index(conn);
-    
-    // Try common handle patterns
-    // Pattern 1: Direct index (0, 1, 2)
-    // Pattern 2: Index + 0x80 (0x80, 0x81, 0x82) - Nordic specific
-    
-    return idx; // Start with direct index, adjust if needed
 }
 
+void zmk_split_central_rssi_unsubscribe(void) {
+    atomic_val_t subscribers;
+
+    do {
+        subscribers = atomic_get(&rssi_subscribers);
+        if (subscribers == 0) {
+            LOG_WRN("Unbalanced RSSI unsubscribe");
+            return;
+        }
+    } while (!atomic_cas(&rssi_subscribers, subscribers, subscribers - 1));
+
+    if (subscribers == 1) {
+        k_work_cancel_delayable(&read_rssi_work);
+    }
+}
+
+static int read_conn_rssi(struct bt_conn *conn, int8_t *rssi) {
+    struct bt_hci_cp_read_rssi *cp;
+    struct bt_hci_rp_read_rssi *rp;
+    struct net_buf *buf, *rsp;
+    uint16_t handle;
+
+    int err = bt_hci_get_conn_handle(conn, &handle);
+    if (err < 0) {
+        return err;
+    }
+
+    buf = bt_hci_cmd_create(BT_HCI_OP_READ_RSSI, sizeof(*cp));
+    if (!buf) {
+        return -ENOBUFS;
+    }
+
+    cp = net_buf_add(buf, sizeof(*cp));
+    cp->handle = sys_cpu_to_le16(handle);
+
+    err = bt_hci_cmd_send_sync(BT_HCI_OP_READ_RSSI, buf, &rsp);
+    if (err < 0) {
+        return err;
+    }
+
+    rp = (void *)rsp->data;
+    err = rp->status ? -EIO : 0;
+    *rssi = rp->rssi;
+
+    net_buf_unref(rsp);
+
+    return err;
+}
+
+// Runs on its own low priority queue, so the blocking HCI round trips never hold up the system
+// work queue or key processing. Events are only raised from the system work queue.
 static void read_rssi_work_handler(struct k_work *work) {
+    struct bt_conn *conns[ZMK_SPLIT_BLE_PERIPHERAL_COUNT] = {NULL};
+    bool any_connected = false;
+
+    k_spinlock_key_t key = k_spin_lock(&peripheral_slot_lock);
     for (int i = 0; i < ZMK_SPLIT_BLE_PERIPHERAL_COUNT; i++) {
-        if (peripherals[i].state != PERIPHERAL_SLOT_STATE_CONNECTED || 
-            peripherals[i].conn == NULL) {
-            continue;
+        if (peripherals[i].state == PERIPHERAL_SLOT_STATE_CONNECTED &&
+            peripherals[i].conn != NULL) {
+            conns[i] = bt_conn_ref(peripherals[i].conn);
+            any_connected = true;
         }
+    }
+    k_spin_unlock(&peripheral_slot_lock, key);
 
-        struct bt_hci_cp_read_rssi *cp;
-        struct bt_hci_rp_read_rssi *rp;
-        struct net_buf *buf, *rsp = NULL;
-        uint16_t handle = get_conn_handle(peripherals[i].conn);
-        bool success = false;
-        int8_t rssi = 0;
-        
-        // Try pattern 1: Direct handle (0x0000, 0x0001, etc)
-        buf = bt_hci_cmd_create(BT_HCI_OP_READ_RSSI, sizeof(*cp));
-        if (buf) {
-            cp = net_buf_add(buf, sizeof(*cp));
-            cp->handle = sys_cpu_to_le16(handle);
-            
-            LOG_DBG("Reading RSSI for slot %d, handle 0x%04x", i, handle);
-            
-            int err = bt_hci_cmd_send_sync(BT_HCI_OP_READ_RSSI, buf, &rsp);
-            if (err == 0 && rsp) {
-                rp = (void *)rsp->data;
-                if (rp->status == 0) {
-                    rssi = rp->rssi;
-                    success = true;
-                    LOG_INF("Peripheral %d RSSI: %d dBm (handle 0x%04x)", i, rssi, handle);
-                }
-                net_buf_unref(rsp);
-                rsp = NULL;
-            }
+    for (int i = 0; i < ZMK_SPLIT_BLE_PERIPHERAL_COUNT; i++) {
+        if (conns[i] == NULL) {
+            continue;
         }
-        
-        // Try pattern 2: Nordic offset handle (0x0080, 0x0081, etc)
-        if (!success) {
-            uint16_t handle_offset = handle + 0x80;
-            
-            buf = bt_hci_cmd_create(BT_HCI_OP_READ_RSSI, sizeof(*cp));
-            if (buf) {
-                cp = net_buf_add(buf, sizeof(*cp));
-                cp->handle = sys_cpu_to_le16(handle_offset);
-                
-                LOG_DBG("Retrying RSSI for slot %d, handle 0x%04x", i, handle_offset);
-                
-                int err = bt_hci_cmd_send_sync(BT_HCI_OP_READ_RSSI, buf, &rsp);
-                if (err == 0 && rsp) {
-                    rp = (void *)rsp->data;
-                    if (rp->status == 0) {
-                        rssi = rp->rssi;
-                        success = true;
-                        LOG_INF("Peripheral %d RSSI: %d dBm (handle 0x%04x)", i, rssi, handle_offset);
-                    }
-                    net_buf_unref(rsp);
-                    rsp = NULL;
-                }
+
+        int8_t rssi;
+        int err = read_conn_rssi(conns[i], &rssi);
+
+        if (err < 0) {
+            LOG_WRN("Failed to read RSSI for peripheral %d (err %d)", i, err);
+        } else {
+            key = k_spin_lock(&peripheral_slot_lock);
+            // Our reference keeps the connection object from being reused, so a match means the
+            // slot wasn't released while reading.
+            if (peripherals[i].conn == conns[i]) {
+                rssi_readings[i].rssi = rssi;
+                rssi_readings[i].pending = true;
             }
+            k_spin_unlock(&peripheral_slot_lock, key);
         }
-        
-        // Try pattern 3: Try sequential handles 0x0000-0x0003
-        if (!success) {
-            for (uint16_t test_handle = 0x0000; test_handle <= 0x0003 && !success; test_handle++) {
-                buf = bt_hci_cmd_create(BT_HCI_OP_READ_RSSI, sizeof(*cp));
-                if (!buf) continue;
-                
-                cp = net_buf_add(buf, sizeof(*cp));
-                cp->handle = sys_cpu_to_le16(test_handle);
-                
-                int err = bt_hci_cmd_send_sync(BT_HCI_OP_READ_RSSI, buf, &rsp);
-                if (err == 0 && rsp) {
-                    rp = (void *)rsp->data;
-                    if (rp->status == 0) {
-                        rssi = rp->rssi;
-                        success = true;
-                        LOG_INF("Peripheral %d RSSI: %d dBm (found with handle 0x%04x)", 
-                                i, rssi, test_handle);
-                    }
-                    net_buf_unref(rsp);
-                    rsp = NULL;
-                }
-            }
+
+        bt_conn_unref(conns[i]);
+    }
+
+    k_work_submit(&raise_rssi_work);
+
+    if (any_connected) {
+        schedule_rssi_read(K_MSEC(CONFIG_ZMK_SPLIT_BLE_CENTRAL_RSSI_INTERVAL_MS));
+    }
+}
+
+static void raise_rssi_work_handler(struct k_work *work) {
+    struct zmk_split_peripheral_rssi_changed changes[ZMK_SPLIT_BLE_PERIPHERAL_COUNT];
+    int count = 0;
+
+    k_spinlock_key_t key = k_spin_lock(&peripheral_slot_lock);
+    for (int i = 0; i < ZMK_SPLIT_BLE_PERIPHERAL_COUNT; i++) {
+        struct peripheral_slot *slot = &peripherals[i];
+        int8_t rssi = rssi_readings[i].rssi;
+
+        if (!rssi_readings[i].pending) {
+            continue;
         }
-        
-        // Fallback: Use RSSI from scan
-        if (!success) {
-            if (peripherals[i].last_rssi != 0) {
-                rssi = peripherals[i].last_rssi;
-                LOG_INF("Peripheral %d RSSI: %d dBm (from scan, HCI failed)", i, rssi);
-            } else {
-                LOG_WRN("No RSSI available for slot %d", i);
-                continue;
-            }
-        } else {
-            peripherals[i].last_rssi = rssi;
+
+        rssi_readings[i].pending = false;
+
+        if (slot->rssi_reported &&
+            abs(rssi - slot->last_rssi) < CONFIG_ZMK_SPLIT_BLE_CENTRAL_RSSI_HYSTERESIS) {
+            continue;
         }
-        
-        raise_zmk_split_peripheral_rssi_changed(
-            (struct zmk_split_peripheral_rssi_changed){
-                .source = i,
-                .rssi = rssi
-            }
-        );
+
+        slot->last_rssi = rssi;
+        slot->rssi_reported = true;
+        changes[count++] = (struct zmk_split_peripheral_rssi_changed){.source = i, .rssi = rssi};
     }
+    k_spin_unlock(&peripheral_slot_lock, key);
 
-    k_work_schedule(&read_rssi_work, K_MSEC(RSSI_READ_INTERVAL_MS));
+    for (int i = 0; i < count; i++) {
+        LOG_DBG("Peripheral %d RSSI: %d dBm", changes[i].source, changes[i].rssi);
+        raise_zmk_split_peripheral_rssi_changed(changes[i]);
+    }
 }
 
+static int split_central_rssi_listener(const zmk_event_t *eh) {
+    const struct zmk_activity_state_changed *ev = as_zmk_activity_state_changed(eh);
+
+    if (ev && ev->state == ZMK_ACTIVITY_ACTIVE) {
+        schedule_rssi_read(K_NO_WAIT);
+    }
+
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(split_central_rssi, split_central_rssi_listener);
+ZMK_SUBSCRIPTION(split_central_rssi, zmk_activity_state_changed);
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_RSSI)
+
 int peripheral_slot_index_for_conn(struct bt_conn *conn) {
     for (int i = 0; i < ZMK_SPLIT_BLE_PERIPHERAL_COUNT; i++) {
         if (peripherals[i].conn == conn) {
@@ -313,6 +383,20 @@ struct peripheral_slot *peripheral_slot_for_conn(struct bt_conn *conn) {
     return &peripherals[idx];
 }
 
+static void queue_position_event(uint8_t source, uint32_t position, bool pressed,
+                                 uint32_t timestamp) {
+    struct peripheral_event_wrapper ev = {
+        .source = source,
+        .event = {.type = ZMK_SPLIT_TRANSPORT_PERIPHERAL_EVENT_TYPE_KEY_POSITION_EVENT,
+                  .data = {.key_position_event = {
+                               .position = position,
+                               .pressed = pressed,
+                               .timestamp = timestamp,
+                           }}}};
+
+    queue_peripheral_event(&ev);
+}
+
 int release_peripheral_slot(int index) {
     if (index < 0 || index >= ZMK_SPLIT_BLE_PERIPHERAL_COUNT) {
         return -EINVAL;
@@ -326,26 +410,25 @@ int release_peripheral_slot(int index) {
 
     LOG_DBG("Releasing peripheral slot at %d", index);
 
-    if (slot->conn != NULL) {
-        bt_conn_unref(slot->conn);
-        slot->conn = NULL;
-    }
+    k_spinlock_key_t key = k_spin_lock(&peripheral_slot_lock);
+    struct bt_conn *conn = slot->conn;
+    slot->conn = NULL;
     slot->state = PERIPHERAL_SLOT_STATE_OPEN;
+    slot->last_rssi = 0;
+    slot->rssi_reported = false;
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_RSSI)
+    rssi_readings[index].pending = false;
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_RSSI)
+    k_spin_unlock(&peripheral_slot_lock, key);
+
+    if (conn != NULL) {
+        bt_conn_unref(conn);
+    }
 
     for (int i = 0; i < POSITION_STATE_DATA_LEN; i++) {
         for (int j = 0; j < 8; j++) {
             if (slot->position_state[i] & BIT(j)) {
-                uint32_t position = (i * 8) + j;
-                struct peripheral_event_wrapper ev = {
-                    .source = index,
-                    .event = {.type = ZMK_SPLIT_TRANSPORT_PERIPHERAL_EVENT_TYPE_KEY_POSITION_EVENT,
-                              .data = {.key_position_event = {
-                                           .position = position,
-                                           .pressed = false,
-                                       }}}};
-
-                k_msgq_put(&peripheral_event_msgq, &ev, K_NO_WAIT);
-                k_work_submit(&peripheral_event_work);
+                queue_position_event(index, (i * 8) + j, false, 0);
             }
         }
     }
@@ -356,10 +439,24 @@ int release_peripheral_slot(int index) {
     }
 
     slot->subscribe_params.value_handle = 0;
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_POSITION_DELTAS)
+    slot->delta_subscribe_params.value_handle = 0;
+    slot->delta_seq_valid = false;
+    slot->resync_pending = false;
+    slot->resync_queued = false;
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_POSITION_DELTAS)
     slot->run_behavior_handle = 0;
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_COMPACT_BEHAVIORS)
+    slot->run_compact_behaviors_handle = 0;
+    slot->behavior_table_read_params.single.handle = 0;
+    slot->compact_behaviors_ready = false;
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_COMPACT_BEHAVIORS)
     slot->selected_physical_layout_handle = 0;
     slot->wpm_handle = 0;
-    slot->last_rssi = 0;  // ← THÊM
+    zmk_split_command_queue_clear_source(&split_run_queue, index);
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_LINK_QUALITY)
+    slot->link_quality_subscribe_params.value_handle = 0;
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_LINK_QUALITY)
 #if IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_HID_INDICATORS)
     slot->update_hid_indicators = 0;
 #endif
@@ -395,11 +492,14 @@ int confirm_peripheral_slot_conn(struct bt_conn *conn) {
         return idx;
     }
 
+    k_spinlock_key_t key = k_spin_lock(&peripheral_slot_lock);
     peripherals[idx].state = PERIPHERAL_SLOT_STATE_CONNECTED;
-    
-    // ← THÊM: Bắt đầu đọc RSSI
-    k_work_schedule(&read_rssi_work, K_MSEC(RSSI_READ_INTERVAL_MS));
-    
+    k_spin_unlock(&peripheral_slot_lock, key);
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_RSSI)
+    schedule_rssi_read(K_MSEC(CONFIG_ZMK_SPLIT_BLE_CENTRAL_RSSI_INTERVAL_MS));
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_RSSI)
+
     return 0;
 }
 
@@ -441,8 +541,7 @@ static uint8_t split_central_sensor_notify_func(struct bt_conn *conn,
                                .sensor_index = sensor_event.sensor_index,
                            }}}};
 
-    k_msgq_put(&peripheral_event_msgq, &event_wrapper, K_NO_WAIT);
-    k_work_submit(&peripheral_event_work);
+    queue_peripheral_event(&event_wrapper);
 
     return BT_GATT_ITER_CONTINUE;
 }
@@ -482,8 +581,7 @@ static uint8_t peripheral_input_event_notify_cb(struct bt_conn *conn,
                                        .value = payload.value,
                                    }}}};
 
-            k_msgq_put(&peripheral_event_msgq, &event_wrapper, K_NO_WAIT);
-            k_work_submit(&peripheral_event_work);
+            queue_peripheral_event(&event_wrapper);
             break;
         }
     }
@@ -493,6 +591,43 @@ static uint8_t peripheral_input_event_notify_cb(struct bt_conn *conn,
 
 #endif
 
+static void apply_position_state(struct peripheral_slot *slot, const uint8_t *data) {
+    uint8_t source = slot - peripherals;
+
+    for (int i = 0; i < POSITION_STATE_DATA_LEN; i++) {
+        slot->changed_positions[i] = data[i] ^ slot->position_state[i];
+        slot->position_state[i] = data[i];
+    }
+    LOG_HEXDUMP_DBG(slot->position_state, POSITION_STATE_DATA_LEN, "data");
+
+    for (int i = 0; i < POSITION_STATE_DATA_LEN; i++) {
+        for (int j = 0; j < 8; j++) {
+            if (slot->changed_positions[i] & BIT(j)) {
+                queue_position_event(source, (i * 8) + j, slot->position_state[i] & BIT(j), 0);
+            }
+        }
+    }
+}
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_POSITION_DELTAS)
+
+static void apply_position_change(struct peripheral_slot *slot, uint8_t position, bool pressed,
+                                  uint32_t timestamp) {
+    if (position >= POSITION_STATE_DATA_LEN * 8) {
+        LOG_WRN("Ignoring out of range position %d", position);
+        return;
+    }
+
+    if (!!(slot->position_state[position / 8] & BIT(position % 8)) == pressed) {
+        return;
+    }
+
+    WRITE_BIT(slot->position_state[position / 8], position % 8, pressed);
+    queue_position_event(slot - peripherals, position, pressed, timestamp);
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_POSITION_DELTAS)
+
 static uint8_t split_central_notify_func(struct bt_conn *conn,
                                          struct bt_gatt_subscribe_params *params, const void *data,
                                          uint16_t length) {
@@ -511,33 +646,307 @@ static uint8_t split_central_notify_func(struct bt_conn *conn,
 
     LOG_DBG("[NOTIFICATION] data %p length %u", data, length);
 
-    for (int i = 0; i < POSITION_STATE_DATA_LEN; i++) {
-        slot->changed_positions[i] = ((uint8_t *)data)[i] ^ slot->position_state[i];
-        slot->position_state[i] = ((uint8_t *)data)[i];
+    apply_position_state(slot, data);
+
+    return BT_GATT_ITER_CONTINUE;
+}
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_POSITION_DELTAS)
+
+static void resync_position_state(struct bt_conn *conn, struct peripheral_slot *slot);
+
+static uint8_t split_central_position_state_read_func(struct bt_conn *conn, uint8_t err,
+                                                      struct bt_gatt_read_params *params,
+                                                      const void *data, uint16_t length) {
+    struct peripheral_slot *slot = peripheral_slot_for_conn(conn);
+
+    if (!slot) {
+        LOG_ERR("No peripheral state found for connection");
+        return BT_GATT_ITER_STOP;
     }
-    LOG_HEXDUMP_DBG(slot->position_state, POSITION_STATE_DATA_LEN, "data");
 
-    for (int i = 0; i < POSITION_STATE_DATA_LEN; i++) {
-        for (int j = 0; j < 8; j++) {
-            if (slot->changed_positions[i] & BIT(j)) {
-                uint32_t position = (i * 8) + j;
-                bool pressed = slot->position_state[i] & BIT(j);
-                struct peripheral_event_wrapper ev = {
-                    .source = peripheral_slot_index_for_conn(conn),
-                    .event = {.type = ZMK_SPLIT_TRANSPORT_PERIPHERAL_EVENT_TYPE_KEY_POSITION_EVENT,
-                              .data = {.key_position_event = {
-                                           .position = position,
-                                           .pressed = pressed,
-                                       }}}};
-                k_msgq_put(&peripheral_event_msgq, &ev, K_NO_WAIT);
-                k_work_submit(&peripheral_event_work);
-            }
+    if (err > 0 || !data) {
+        if (err > 0) {
+            LOG_ERR("Error during reading peripheral position state: %u", err);
         }
+
+        slot->resync_pending = false;
+        if (slot->resync_queued) {
+            slot->resync_queued = false;
+            resync_position_state(conn, slot);
+        }
+
+        return BT_GATT_ITER_STOP;
+    }
+
+    LOG_DBG("[POSITION STATE READ] data %p length %u", data, length);
+
+    if (length < POSITION_STATE_DATA_LEN) {
+        LOG_WRN("Ignoring position state read with insufficient data length (%d)", length);
+        return BT_GATT_ITER_CONTINUE;
+    }
+
+    apply_position_state(slot, data);
+
+    return BT_GATT_ITER_CONTINUE;
+}
+
+static void resync_position_state(struct bt_conn *conn, struct peripheral_slot *slot) {
+    if (!slot->subscribe_params.value_handle) {
+        return;
+    }
+
+    // A read issued before the latest gap may be answered with state older than the lost deltas.
+    if (slot->resync_pending) {
+        slot->resync_queued = true;
+        return;
+    }
+
+    slot->position_read_params.func = split_central_position_state_read_func;
+    slot->position_read_params.handle_count = 1;
+    slot->position_read_params.single.handle = slot->subscribe_params.value_handle;
+    slot->position_read_params.single.offset = 0;
+
+    int err = bt_gatt_read(conn, &slot->position_read_params);
+    if (err < 0) {
+        LOG_ERR("Failed to read peripheral position state (err %d)", err);
+        return;
+    }
+
+    slot->resync_pending = true;
+}
+
+static uint8_t split_central_position_deltas_notify_func(struct bt_conn *conn,
+                                                         struct bt_gatt_subscribe_params *params,
+                                                         const void *data, uint16_t length) {
+    struct peripheral_slot *slot = peripheral_slot_for_conn(conn);
+
+    if (slot == NULL) {
+        LOG_ERR("No peripheral state found for connection");
+        return BT_GATT_ITER_CONTINUE;
+    }
+
+    if (!data) {
+        LOG_DBG("[UNSUBSCRIBED]");
+        params->value_handle = 0U;
+        return BT_GATT_ITER_STOP;
+    }
+
+    LOG_DBG("[POSITION DELTAS] data %p length %u", data, length);
+
+    const size_t header_len = offsetof(struct zmk_split_position_deltas_payload, deltas);
+    if (length < header_len ||
+        (length - header_len) % sizeof(struct zmk_split_position_delta) != 0) {
+        LOG_WRN("Ignoring position deltas notify with invalid data length (%d)", length);
+        return BT_GATT_ITER_CONTINUE;
+    }
+
+    struct zmk_split_position_deltas_payload payload;
+    memcpy(&payload, data, header_len);
+
+    const uint8_t *bytes = data;
+    uint8_t seq = payload.seq;
+    uint32_t sent_at = sys_le32_to_cpu(payload.timestamp);
+    size_t count = (length - header_len) / sizeof(struct zmk_split_position_delta);
+
+    // Notifications and read responses share one ordered bearer, so deltas applied before the
+    // resync response arrives are already reflected in it, and the diff skips them.
+    if (slot->delta_seq_valid && seq != slot->next_delta_seq) {
+        LOG_WRN("Position delta sequence gap (expected %d, got %d), resyncing",
+                slot->next_delta_seq, seq);
+        resync_position_state(conn, slot);
+    }
+
+    slot->next_delta_seq = seq + count;
+    slot->delta_seq_valid = true;
+
+    for (size_t i = 0; i < count; i++) {
+        struct zmk_split_position_delta delta;
+        memcpy(&delta, bytes + header_len + i * sizeof(delta), sizeof(delta));
+
+        uint16_t state_and_age = sys_le16_to_cpu(delta.state_and_age);
+        bool pressed = state_and_age & ZMK_SPLIT_POSITION_DELTA_PRESSED;
+
+        uint32_t age = state_and_age & ZMK_SPLIT_POSITION_DELTA_AGE_MAX;
+
+        LOG_DBG("Position %d %s %dms before notify", delta.position,
+                pressed ? "pressed" : "released", age);
+
+        // Zero is reserved for "no timestamp", nudge the rare real zero out of the way.
+        apply_position_change(slot, delta.position, pressed, MAX(sent_at - age, 1));
     }
 
     return BT_GATT_ITER_CONTINUE;
 }
 
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_POSITION_DELTAS)
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_COMPACT_BEHAVIORS)
+
+static void start_behavior_table_entry(struct peripheral_slot *slot) {
+    memset(slot->behavior_table_candidates, 0xFF, sizeof(slot->behavior_table_candidates));
+    slot->behavior_table_name_len = 0;
+}
+
+static void match_behavior_table_char(struct peripheral_slot *slot, char c) {
+    const uint16_t pos = slot->behavior_table_name_len;
+    size_t index = 0;
+
+    STRUCT_SECTION_FOREACH(zmk_behavior_ref, item) {
+        if (index >= ARRAY_SIZE(slot->compact_behavior_ids)) {
+            break;
+        }
+
+        // Names that stopped matching are never read again, so pos stays within the others.
+        if (atomic_test_bit(slot->behavior_table_candidates, index) &&
+            item->device->name[pos] != c) {
+            atomic_clear_bit(slot->behavior_table_candidates, index);
+        }
+
+        index++;
+    }
+
+    if (pos < UINT16_MAX) {
+        slot->behavior_table_name_len++;
+    }
+}
+
+static void map_compact_behavior(struct peripheral_slot *slot, uint8_t id) {
+    const uint16_t pos = slot->behavior_table_name_len;
+    size_t index = 0;
+
+    STRUCT_SECTION_FOREACH(zmk_behavior_ref, item) {
+        if (index >= ARRAY_SIZE(slot->compact_behavior_ids)) {
+            break;
+        }
+
+        if (atomic_test_bit(slot->behavior_table_candidates, index) &&
+            item->device->name[pos] == '\0') {
+            slot->compact_behavior_ids[index] = id;
+            return;
+        }
+
+        index++;
+    }
+}
+
+static uint8_t split_central_behavior_table_read_func(struct bt_conn *conn, uint8_t err,
+                                                      struct bt_gatt_read_params *params,
+                                                      const void *data, uint16_t length) {
+    struct peripheral_slot *slot = peripheral_slot_for_conn(conn);
+
+    if (!slot) {
+        LOG_ERR("No peripheral state found for connection");
+        return BT_GATT_ITER_STOP;
+    }
+
+    if (err > 0) {
+        LOG_ERR("Error during reading peripheral behavior table, invoking by name: %u", err);
+        return BT_GATT_ITER_STOP;
+    }
+
+    if (!data) {
+        LOG_DBG("Read %d peripheral behaviors", slot->behavior_table_next_id);
+        slot->compact_behaviors_ready = slot->run_compact_behaviors_handle != 0;
+        return BT_GATT_ITER_STOP;
+    }
+
+    const char *chars = data;
+
+    for (uint16_t i = 0; i < length; i++) {
+        if (chars[i] != '\0') {
+            match_behavior_table_char(slot, chars[i]);
+            continue;
+        }
+
+        if (slot->behavior_table_next_id < ZMK_SPLIT_COMPACT_BEHAVIOR_ID_NONE) {
+            map_compact_behavior(slot, slot->behavior_table_next_id);
+        }
+
+        start_behavior_table_entry(slot);
+        if (slot->behavior_table_next_id < ZMK_SPLIT_COMPACT_BEHAVIOR_ID_NONE) {
+            slot->behavior_table_next_id++;
+        }
+    }
+
+    return BT_GATT_ITER_CONTINUE;
+}
+
+static void read_behavior_table(struct bt_conn *conn, struct peripheral_slot *slot,
+                                uint16_t handle) {
+    memset(slot->compact_behavior_ids, ZMK_SPLIT_COMPACT_BEHAVIOR_ID_NONE,
+           sizeof(slot->compact_behavior_ids));
+    slot->compact_behaviors_ready = false;
+    slot->behavior_table_next_id = 0;
+    start_behavior_table_entry(slot);
+
+    slot->behavior_table_read_params.func = split_central_behavior_table_read_func;
+    slot->behavior_table_read_params.handle_count = 1;
+    slot->behavior_table_read_params.single.handle = handle;
+    slot->behavior_table_read_params.single.offset = 0;
+
+    int err = bt_gatt_read(conn, &slot->behavior_table_read_params);
+    if (err < 0) {
+        LOG_ERR("Failed to read peripheral behavior table, invoking by name (err %d)", err);
+    }
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_COMPACT_BEHAVIORS)
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_LINK_QUALITY)
+
+static ATOMIC_DEFINE(link_quality_pending, ZMK_SPLIT_BLE_PERIPHERAL_COUNT);
+
+static void raise_link_quality_work_cb(struct k_work *work) {
+    for (int i = 0; i < ZMK_SPLIT_BLE_PERIPHERAL_COUNT; i++) {
+        if (!atomic_test_and_clear_bit(link_quality_pending, i)) {
+            continue;
+        }
+
+        struct zmk_split_link_quality_payload payload = peripherals[i].link_quality;
+
+        raise_zmk_split_peripheral_link_quality_changed(
+            (struct zmk_split_peripheral_link_quality_changed){
+                .source = i,
+                .rssi = payload.rssi,
+                .notify_errors = sys_le16_to_cpu(payload.notify_errors),
+                .queue_drops = sys_le16_to_cpu(payload.queue_drops),
+            });
+    }
+}
+
+static K_WORK_DEFINE(raise_link_quality_work, raise_link_quality_work_cb);
+
+static uint8_t split_central_link_quality_notify_func(struct bt_conn *conn,
+                                                      struct bt_gatt_subscribe_params *params,
+                                                      const void *data, uint16_t length) {
+    int idx = peripheral_slot_index_for_conn(conn);
+
+    if (idx < 0) {
+        LOG_ERR("No peripheral state found for connection");
+        return BT_GATT_ITER_CONTINUE;
+    }
+
+    if (!data) {
+        LOG_DBG("[UNSUBSCRIBED]");
+        params->value_handle = 0U;
+        return BT_GATT_ITER_STOP;
+    }
+
+    if (length < sizeof(struct zmk_split_link_quality_payload)) {
+        LOG_WRN("Ignoring link quality notify with insufficient data length (%d)", length);
+        return BT_GATT_ITER_CONTINUE;
+    }
+
+    memcpy(&peripherals[idx].link_quality, data, sizeof(struct zmk_split_link_quality_payload));
+    atomic_set_bit(link_quality_pending, idx);
+    k_work_submit(&raise_link_quality_work);
+
+    return BT_GATT_ITER_CONTINUE;
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_LINK_QUALITY)
+
 #if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_BATTERY_LEVEL_FETCHING)
 
 static uint8_t split_central_battery_level_notify_func(struct bt_conn *conn,
@@ -572,8 +981,7 @@ static uint8_t split_central_battery_level_notify_func(struct bt_conn *conn,
                                .level = battery_level,
                            }}}};
 
-    k_msgq_put(&peripheral_event_msgq, &ev, K_NO_WAIT);
-    k_work_submit(&peripheral_event_work);
+    queue_peripheral_event(&ev);
 
     return BT_GATT_ITER_CONTINUE;
 }
@@ -616,8 +1024,7 @@ static uint8_t split_central_battery_level_read_func(struct bt_conn *conn, uint8
                                .level = battery_level,
                            }}}};
 
-    k_msgq_put(&peripheral_event_msgq, &ev, K_NO_WAIT);
-    k_work_submit(&peripheral_event_work);
+    queue_peripheral_event(&ev);
 
     return BT_GATT_ITER_CONTINUE;
 }
@@ -684,6 +1091,14 @@ static uint8_t split_central_chrc_discovery_func(struct bt_conn *conn,
                                                  struct bt_gatt_discover_params *params) {
     if (!attr) {
         LOG_DBG("Discover complete");
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_POSITION_DELTAS)
+        struct peripheral_slot *slot = peripheral_slot_for_conn(conn);
+        if (slot && slot->subscribe_params.value_handle &&
+            !slot->delta_subscribe_params.value_handle) {
+            LOG_DBG("Peripheral has no position delta characteristic, using the bitmap");
+            split_central_subscribe(conn, &slot->subscribe_params);
+        }
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_POSITION_DELTAS)
         return BT_GATT_ITER_STOP;
     }
 
@@ -711,7 +1126,22 @@ static uint8_t split_central_chrc_discovery_func(struct bt_conn *conn,
             slot->subscribe_params.value_handle = bt_gatt_attr_value_handle(attr);
             slot->subscribe_params.notify = split_central_notify_func;
             slot->subscribe_params.value = BT_GATT_CCC_NOTIFY;
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_POSITION_DELTAS)
+            // Deltas are preferred; the bitmap is only subscribed to once discovery completes
+            // without finding them.
+        } else if (bt_uuid_cmp(chrc_uuid,
+                               BT_UUID_DECLARE_128(ZMK_SPLIT_BT_CHAR_POSITION_DELTA_UUID)) == 0) {
+            LOG_DBG("Found position delta characteristic");
+            slot->delta_seq_valid = false;
+            slot->delta_subscribe_params.disc_params = &slot->sub_discover_params;
+            slot->delta_subscribe_params.end_handle = slot->discover_params.end_handle;
+            slot->delta_subscribe_params.value_handle = bt_gatt_attr_value_handle(attr);
+            slot->delta_subscribe_params.notify = split_central_position_deltas_notify_func;
+            slot->delta_subscribe_params.value = BT_GATT_CCC_NOTIFY;
+            split_central_subscribe(conn, &slot->delta_subscribe_params);
+#else
             split_central_subscribe(conn, &slot->subscribe_params);
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_POSITION_DELTAS)
 #if ZMK_KEYMAP_HAS_SENSORS
         } else if (bt_uuid_cmp(chrc_uuid,
                                BT_UUID_DECLARE_128(ZMK_SPLIT_BT_CHAR_SENSOR_STATE_UUID)) == 0) {
@@ -753,10 +1183,34 @@ static uint8_t split_central_chrc_discovery_func(struct bt_conn *conn,
             slot->discover_params.uuid = NULL;
             slot->discover_params.start_handle = attr->handle + 2;
             slot->run_behavior_handle = bt_gatt_attr_value_handle(attr);
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_COMPACT_BEHAVIORS)
+        } else if (bt_uuid_cmp(chrc_uuid, BT_UUID_DECLARE_128(
+                                              ZMK_SPLIT_BT_CHAR_RUN_COMPACT_BEHAVIORS_UUID)) == 0) {
+            LOG_DBG("Found run compact behaviors handle");
+            slot->run_compact_behaviors_handle = bt_gatt_attr_value_handle(attr);
+        } else if (bt_uuid_cmp(chrc_uuid,
+                               BT_UUID_DECLARE_128(ZMK_SPLIT_BT_CHAR_BEHAVIOR_TABLE_UUID)) == 0) {
+            LOG_DBG("Found behavior table handle");
+            read_behavior_table(conn, slot, bt_gatt_attr_value_handle(attr));
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_COMPACT_BEHAVIORS)
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_LINK_QUALITY)
+        } else if (bt_uuid_cmp(chrc_uuid,
+                               BT_UUID_DECLARE_128(ZMK_SPLIT_BT_CHAR_LINK_QUALITY_UUID)) == 0) {
+            LOG_DBG("Found link quality characteristic");
+            slot->link_quality_subscribe_params.disc_params = &slot->sub_discover_params;
+            slot->link_quality_subscribe_params.end_handle = slot->discover_params.end_handle;
+            slot->link_quality_subscribe_params.value_handle = bt_gatt_attr_value_handle(attr);
+            slot->link_quality_subscribe_params.notify = split_central_link_quality_notify_func;
+            slot->link_quality_subscribe_params.value = BT_GATT_CCC_NOTIFY;
+            split_central_subscribe(conn, &slot->link_quality_subscribe_params);
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_LINK_QUALITY)
         } else if (bt_uuid_cmp(chrc_uuid,
                                BT_UUID_DECLARE_128(ZMK_SPLIT_BT_CHAR_WPM_UUID)) == 0) {
             LOG_DBG("Found WPM characteristic handle");
             slot->wpm_handle = bt_gatt_attr_value_handle(attr);
+#if IS_ENABLED(CONFIG_ZMK_WPM)
+            zmk_split_central_resend_wpm();
+#endif // IS_ENABLED(CONFIG_ZMK_WPM)
             slot->discover_params.uuid = NULL;
             slot->discover_params.start_handle = attr->handle + 2;
             slot->discover_params.type = BT_GATT_DISCOVER_CHARACTERISTIC;
@@ -843,6 +1297,20 @@ static uint8_t split_central_chrc_discovery_func(struct bt_conn *conn,
     subscribed = subscribed && slot->sensor_subscribe_params.value_handle;
 #endif
 
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_POSITION_DELTAS)
+    // Peripherals without deltas run discovery to completion, where the bitmap fallback kicks in.
+    subscribed = subscribed && slot->delta_subscribe_params.value_handle;
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_POSITION_DELTAS)
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_COMPACT_BEHAVIORS)
+    subscribed = subscribed && slot->run_compact_behaviors_handle &&
+                 slot->behavior_table_read_params.single.handle;
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_COMPACT_BEHAVIORS)
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_LINK_QUALITY)
+    subscribed = subscribed && slot->link_quality_subscribe_params.value_handle;
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_LINK_QUALITY)
+
 #if IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_HID_INDICATORS)
     subscribed = subscribed && slot->update_hid_indicators;
 #endif
@@ -928,6 +1396,9 @@ static void split_central_process_connection(struct bt_conn *conn) {
     LOG_DBG("New connection params: Interval: %d, Latency: %d, PHY: %d", info.le.interval,
             info.le.latency, info.le.phy->rx_phy);
 
+    zmk_ble_link_request_fast(conn, IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_PREF_PHY_2M),
+                              IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_DATA_LEN_EXTENSION));
+
     start_scanning();
 }
 
@@ -1021,23 +1492,6 @@ static void split_central_device_found(const bt_addr_le_t *addr, int8_t rssi, ui
     bt_addr_le_to_str(addr, dev, sizeof(dev));
     LOG_DBG("[DEVICE]: %s, AD evt type %u, AD data len %u, RSSI %i", dev, type, ad->len, rssi);
 
-    // ← CẢI THIỆN: Lưu RSSI cho peripheral đang connecting hoặc connected
-    for (int i = 0; i < ZMK_SPLIT_BLE_PERIPHERAL_COUNT; i++) {
-        // Kiểm tra cả 2 trường hợp: đang connecting hoặc đã connected
-        if (peripherals[i].state == PERIPHERAL_SLOT_STATE_CONNECTING ||
-            peripherals[i].state == PERIPHERAL_SLOT_STATE_CONNECTED) {
-            
-            if (peripherals[i].conn != NULL) {
-                const bt_addr_le_t *conn_addr = bt_conn_get_dst(peripherals[i].conn);
-                if (bt_addr_le_cmp(addr, conn_addr) == 0) {
-                    peripherals[i].last_rssi = rssi;
-                    LOG_DBG("Updated RSSI for peripheral slot %d: %d dBm", i, rssi);
-                    break;
-                }
-            }
-        }
-    }
-
     /* We're only interested in connectable events */
     if (type == BT_GAP_ADV_TYPE_ADV_IND) {
         bt_data_parse(ad, split_central_eir_parse, (void *)addr);
@@ -1057,29 +1511,18 @@ static int start_scanning(void) {
         return 0;
     }
 
-    // ← THAY ĐỔI: Luôn scan để lấy RSSI, ngay cả khi đã kết nối
-    // Nhưng chỉ scan nếu có ít nhất 1 peripheral đã connected
-    bool has_connected = false;
+    // If all the devices are connected, there is no need to scan.
+    bool has_unconnected = false;
     for (int i = 0; i < CONFIG_ZMK_SPLIT_BLE_CENTRAL_PERIPHERALS; i++) {
-        if (peripherals[i].state == PERIPHERAL_SLOT_STATE_CONNECTED) {
-            has_connected = true;
+        if (peripherals[i].conn == NULL) {
+            has_unconnected = true;
             break;
         }
     }
 
-    // Nếu chưa có gì connected, kiểm tra có peripheral chưa connect không
-    if (!has_connected) {
-        bool has_unconnected = false;
-        for (int i = 0; i < CONFIG_ZMK_SPLIT_BLE_CENTRAL_PERIPHERALS; i++) {
-            if (peripherals[i].conn == NULL) {
-                has_unconnected = true;
-                break;
-            }
-        }
-        if (!has_unconnected) {
-            LOG_DBG("No peripherals to connect or monitor");
-            return 0;
-        }
+    if (!has_unconnected) {
+        LOG_DBG("All devices are connected, scanning is unnecessary");
+        return 0;
     }
 
     is_scanning = true;
@@ -1093,13 +1536,6 @@ static int start_scanning(void) {
     return 0;
 }
 
-// ← THÊM: Work để restart scan sau khi connected
-static void restart_scan_work_handler(struct k_work *work) {
-    start_scanning();
-}
-
-K_WORK_DELAYABLE_DEFINE(restart_scan_work, restart_scan_work_handler);
-
 static void split_central_connected(struct bt_conn *conn, uint8_t conn_err) {
     char addr[BT_ADDR_LE_STR_LEN];
     struct bt_conn_info info;
@@ -1127,9 +1563,6 @@ static void split_central_connected(struct bt_conn *conn, uint8_t conn_err) {
     confirm_peripheral_slot_conn(conn);
     split_central_process_connection(conn);
     k_work_submit(&notify_status_work);
-    
-    // ← THÊM: Restart scan sau 2s để lấy RSSI từ advertising
-    //k_work_schedule(&restart_scan_work, K_MSEC(2000));
 }
 
 static void split_central_disconnected(struct bt_conn *conn, uint8_t reason) {
@@ -1148,8 +1581,7 @@ static void split_central_disconnected(struct bt_conn *conn, uint8_t reason) {
                                .level = 0,
                            }}}};
 
-    k_msgq_put(&peripheral_event_msgq, &ev, K_NO_WAIT);
-    k_work_submit(&peripheral_event_work);
+    queue_peripheral_event(&ev);
 #endif
 
 #if IS_ENABLED(CONFIG_ZMK_INPUT_SPLIT)
@@ -1198,25 +1630,169 @@ K_THREAD_STACK_DEFINE(split_central_split_run_q_stack,
 
 struct k_work_q split_central_split_run_q;
 
-struct central_cmd_wrapper {
-    uint8_t source;
-    struct zmk_split_transport_central_command cmd;
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_COMPACT_BEHAVIORS)
+
+// Large enough for a handful of frames once the ATT MTU has been raised.
+#define COMPACT_BEHAVIOR_BATCH_MAX 64
+
+struct compact_behavior_batch {
+    uint8_t len;
+    uint8_t data[COMPACT_BEHAVIOR_BATCH_MAX];
 };
 
-K_MSGQ_DEFINE(zmk_split_central_split_run_msgq, sizeof(struct central_cmd_wrapper),
-              CONFIG_ZMK_SPLIT_BLE_CENTRAL_SPLIT_RUN_QUEUE_SIZE, 4);
+// Only touched from the split run work queue.
+static struct compact_behavior_batch compact_batches[ZMK_SPLIT_BLE_PERIPHERAL_COUNT];
+
+static void flush_compact_behaviors(uint8_t source) {
+    struct compact_behavior_batch *batch = &compact_batches[source];
+
+    if (batch->len == 0) {
+        return;
+    }
+
+    LOG_DBG("Writing %d bytes of compact behaviors to peripheral %d", batch->len, source);
+
+    int err = bt_gatt_write_without_response(peripherals[source].conn,
+                                             peripherals[source].run_compact_behaviors_handle,
+                                             batch->data, batch->len, true);
+    if (err) {
+        LOG_ERR("Failed to write the compact behavior characteristic (err %d)", err);
+    }
+
+    batch->len = 0;
+}
+
+static uint8_t compact_param_width_code(uint32_t param) {
+    if (param == 0) {
+        return 0;
+    } else if (param <= UINT8_MAX) {
+        return 1;
+    } else if (param <= UINT16_MAX) {
+        return 2;
+    }
+
+    return 3;
+}
+
+static int local_behavior_index(const struct device *behavior) {
+    int index = 0;
+
+    if (!behavior) {
+        return -ENODEV;
+    }
+
+    STRUCT_SECTION_FOREACH(zmk_behavior_ref, item) {
+        if (item->device == behavior) {
+            return index;
+        }
+
+        index++;
+    }
+
+    return -ENODEV;
+}
+
+// Returns false if the behavior needs to be invoked by name instead.
+static bool queue_compact_behavior(uint8_t source,
+                                   const struct zmk_split_transport_central_command *cmd) {
+    static const uint8_t widths[] = ZMK_SPLIT_COMPACT_BEHAVIOR_WIDTHS;
+    struct peripheral_slot *slot = &peripherals[source];
+
+    if (!slot->compact_behaviors_ready || cmd->data.invoke_behavior.position > UINT8_MAX) {
+        return false;
+    }
+
+    int index = local_behavior_index(cmd->behavior);
+    if (index < 0 || index >= ARRAY_SIZE(slot->compact_behavior_ids) ||
+        slot->compact_behavior_ids[index] == ZMK_SPLIT_COMPACT_BEHAVIOR_ID_NONE) {
+        LOG_DBG("No compact ID for %s", cmd->data.invoke_behavior.behavior_dev);
+        return false;
+    }
+
+    const uint32_t params[] = {cmd->data.invoke_behavior.param1,
+                               cmd->data.invoke_behavior.param2};
+    const uint8_t codes[] = {compact_param_width_code(params[0]),
+                             compact_param_width_code(params[1])};
+
+    uint8_t frame[ZMK_SPLIT_COMPACT_BEHAVIOR_FRAME_MAX];
+    struct zmk_split_compact_behavior_header header = {
+        .id = slot->compact_behavior_ids[index],
+        .position = cmd->data.invoke_behavior.position,
+        .flags = (cmd->data.invoke_behavior.state ? ZMK_SPLIT_COMPACT_BEHAVIOR_PRESSED : 0) |
+                 (codes[0] << ZMK_SPLIT_COMPACT_BEHAVIOR_PARAM1_WIDTH_SHIFT) |
+                 (codes[1] << ZMK_SPLIT_COMPACT_BEHAVIOR_PARAM2_WIDTH_SHIFT),
+    };
+    uint8_t frame_len = sizeof(header);
+
+    memcpy(frame, &header, sizeof(header));
+    for (int i = 0; i < ARRAY_SIZE(params); i++) {
+        for (int b = 0; b < widths[codes[i]]; b++) {
+            frame[frame_len++] = (params[i] >> (8 * b)) & 0xFF;
+        }
+    }
+
+    struct compact_behavior_batch *batch = &compact_batches[source];
+    const uint16_t max_len = MIN(bt_gatt_get_mtu(slot->conn) - 3, sizeof(batch->data));
+
+    if (batch->len + frame_len > max_len) {
+        flush_compact_behaviors(source);
+    }
+
+    memcpy(batch->data + batch->len, frame, frame_len);
+    batch->len += frame_len;
+
+    return true;
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_COMPACT_BEHAVIORS)
+
+static void write_wpm(uint8_t source, uint8_t wpm) {
+    if (peripherals[source].wpm_handle == 0) {
+        LOG_DBG("WPM handle not found for peripheral %d", source);
+        return;
+    }
+
+    int err = bt_gatt_write_without_response(peripherals[source].conn,
+                                             peripherals[source].wpm_handle, &wpm, sizeof(wpm),
+                                             true);
+    if (err) {
+        LOG_ERR("Failed to write WPM to peripheral %d (err %d)", source, err);
+    } else {
+        LOG_DBG("Sent WPM %d to peripheral %d", wpm, source);
+    }
+}
 
 void split_central_split_run_callback(struct k_work *work) {
-    struct central_cmd_wrapper payload_wrapper;
+    struct zmk_split_command_queue_item payload_wrapper;
+    enum zmk_split_command_lane lane;
 
     LOG_DBG("");
 
-    while (k_msgq_get(&zmk_split_central_split_run_msgq, &payload_wrapper, K_NO_WAIT) == 0) {
-        if (peripherals[payload_wrapper.source].state != PERIPHERAL_SLOT_STATE_CONNECTED) {
+    // Critical commands are drained first, then the latest state and finally telemetry such as
+    // WPM, which rides along with any behavior writes.
+    while (zmk_split_command_queue_peek(&split_run_queue, &payload_wrapper, &lane) == 0) {
+        bool connected =
+            peripherals[payload_wrapper.source].state == PERIPHERAL_SLOT_STATE_CONNECTED;
+
+        zmk_split_command_queue_consume(&split_run_queue, &payload_wrapper, lane, connected);
+
+        if (!connected) {
             LOG_ERR("Source not connected");
             continue;
         }
 
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_COMPACT_BEHAVIORS)
+        // Invocations for the same peripheral, such as a global behavior fanned out to every
+        // peripheral or a macro, are batched until the queue is drained. Anything else sent to
+        // the peripheral flushes the batch first to keep commands in order.
+        if (payload_wrapper.cmd.type == ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_INVOKE_BEHAVIOR &&
+            queue_compact_behavior(payload_wrapper.source, &payload_wrapper.cmd)) {
+            continue;
+        }
+
+        flush_compact_behaviors(payload_wrapper.source);
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_COMPACT_BEHAVIORS)
+
         switch (payload_wrapper.cmd.type) {
         case ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_INVOKE_BEHAVIOR: {
             if (!peripherals[payload_wrapper.source].run_behavior_handle) {
@@ -1274,58 +1850,43 @@ void split_central_split_run_callback(struct k_work *work) {
             }
             break;
 #endif
-        case ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_SEND_WPM: {
-            if (peripherals[payload_wrapper.source].wpm_handle == 0) {
-                LOG_ERR("WPM handle not found for peripheral %d", payload_wrapper.source);
-                continue;
-            }
-
-            uint8_t wpm = payload_wrapper.cmd.data.send_wpm.wpm;
-            
-            int err = bt_gatt_write_without_response(
-                peripherals[payload_wrapper.source].conn,
-                peripherals[payload_wrapper.source].wpm_handle,
-                &wpm,
-                sizeof(wpm),
-                true);
-
-            if (err) {
-                LOG_ERR("Failed to write WPM to peripheral %d (err %d)", 
-                        payload_wrapper.source, err);
-            } else {
-                LOG_DBG("Sent WPM %d to peripheral %d", wpm, payload_wrapper.source);
-            }
+        case ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_SEND_WPM:
+            write_wpm(payload_wrapper.source, payload_wrapper.cmd.data.send_wpm.wpm);
             break;
-        }
         default:
             LOG_WRN("Unsupported wrapped central command type %d", payload_wrapper.cmd.type);
-            return;
+            break;
         }
     }
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_COMPACT_BEHAVIORS)
+    for (int i = 0; i < ZMK_SPLIT_BLE_PERIPHERAL_COUNT; i++) {
+        if (peripherals[i].state == PERIPHERAL_SLOT_STATE_CONNECTED) {
+            flush_compact_behaviors(i);
+        } else {
+            compact_batches[i].len = 0;
+        }
+    }
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_COMPACT_BEHAVIORS)
 }
 
 K_WORK_DEFINE(split_central_split_run_work, split_central_split_run_callback);
 
-static int split_bt_invoke_behavior_payload(struct central_cmd_wrapper payload_wrapper) {
+static int split_bt_invoke_behavior_payload(uint8_t source,
+                                            const struct zmk_split_transport_central_command *cmd) {
     LOG_DBG("");
 
-    int err = k_msgq_put(&zmk_split_central_split_run_msgq, &payload_wrapper, K_MSEC(100));
-    if (err) {
-        switch (err) {
-        case -EAGAIN: {
-            LOG_WRN("Run command message queue full, popping first message and queueing again");
-            struct central_cmd_wrapper discarded_report;
-            k_msgq_get(&zmk_split_central_split_run_msgq, &discarded_report, K_NO_WAIT);
-            return split_bt_invoke_behavior_payload(payload_wrapper);
-        }
-        default:
-            LOG_WRN("Failed to queue behavior to send (%d)", err);
-            return err;
-        }
-    }
+    // Queueing never waits for room, so a busy link doesn't stall the keymap. The write thread is
+    // kicked even when the lane is full so it keeps draining.
+    int err = zmk_split_command_queue_put(&split_run_queue, source, cmd);
 
     k_work_submit_to_queue(&split_central_split_run_q, &split_central_split_run_work);
 
+    if (err) {
+        LOG_WRN("Failed to queue command to send (%d)", err);
+        return err;
+    }
+
     return 0;
 };
 
@@ -1349,6 +1910,12 @@ static int zmk_split_bt_central_init(void) {
     k_work_queue_start(&split_central_split_run_q, split_central_split_run_q_stack,
                        K_THREAD_STACK_SIZEOF(split_central_split_run_q_stack),
                        CONFIG_ZMK_BLE_THREAD_PRIORITY, NULL);
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_RSSI)
+    static const struct k_work_queue_config rssi_queue_config = {.name = "Split Central RSSI"};
+    k_work_queue_start(&split_central_rssi_q, split_central_rssi_q_stack,
+                       K_THREAD_STACK_SIZEOF(split_central_rssi_q_stack),
+                       K_LOWEST_APPLICATION_THREAD_PRIO, &rssi_queue_config);
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_RSSI)
     bt_conn_cb_register(&conn_callbacks);
 
 #if IS_ENABLED(CONFIG_SETTINGS)
@@ -1381,10 +1948,8 @@ static int split_central_bt_send_command(uint8_t source,
     case ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_SET_HID_INDICATORS:
     case ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_SET_PHYSICAL_LAYOUT:
     case ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_INVOKE_BEHAVIOR:
-    case ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_SEND_WPM: {
-        struct central_cmd_wrapper wrapper = {.source = source, .cmd = cmd};
-        return split_bt_invoke_behavior_payload(wrapper);
-    }
+    case ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_SEND_WPM:
+        return split_bt_invoke_behavior_payload(source, &cmd);
     case ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_POLL_EVENTS:
         return -ENOTSUP;
     default:
@@ -1460,12 +2025,52 @@ static struct zmk_split_transport_status split_central_bt_get_status() {
     };
 }
 
+static int split_central_bt_get_link_info(uint8_t source,
+                                          struct zmk_split_transport_link_info *info) {
+    if (source >= ZMK_SPLIT_BLE_PERIPHERAL_COUNT || !info) {
+        return -EINVAL;
+    }
+
+    if (peripherals[source].state != PERIPHERAL_SLOT_STATE_CONNECTED) {
+        return -ENOTCONN;
+    }
+
+    struct zmk_ble_link_info link;
+    int err = zmk_ble_link_get_info(peripherals[source].conn, &link);
+    if (err < 0) {
+        return err;
+    }
+
+    *info = (struct zmk_split_transport_link_info){
+        .interval = link.interval,
+        .latency = link.latency,
+        .tx_phy = link.tx_phy,
+        .rx_phy = link.rx_phy,
+        .tx_max_len = link.tx_max_len,
+        .rx_max_len = link.rx_max_len,
+    };
+
+    return 0;
+}
+
+static int split_central_bt_get_command_queue_stats(struct zmk_split_command_queue_stats *stats) {
+    if (!stats) {
+        return -EINVAL;
+    }
+
+    zmk_split_command_queue_get_stats(&split_run_queue, stats);
+
+    return 0;
+}
+
 static const struct zmk_split_transport_central_api central_api = {
     .send_command = split_central_bt_send_command,
     .get_available_source_ids = split_central_bt_get_available_source_ids,
     .set_enabled = split_central_bt_set_enabled,
     .set_status_callback = split_central_bt_set_status_callback,
     .get_status = split_central_bt_get_status,
+    .get_link_info = split_central_bt_get_link_info,
+    .get_command_queue_stats = split_central_bt_get_command_queue_stats,
 };
 
 ZMK_SPLIT_TRANSPORT_CENTRAL_REGISTER(bt_central, &central_api, CONFIG_ZMK_SPLIT_BLE_PRIORITY);
@@ -1486,11 +2091,6 @@ static int finish_init() {
     return transport_status_cb(&bt_central, split_central_bt_get_status());
 }
 
-void peripheral_event_work_callback(struct k_work *work) {
-    struct peripheral_event_wrapper ev;
-    while (k_msgq_get(&peripheral_event_msgq, &ev, K_NO_WAIT) == 0) {
-        LOG_DBG("Trigger key position state change for %d",
-                ev.event.data.key_position_event.position);
-        zmk_split_transport_central_peripheral_event_handler(&bt_central, ev.source, ev.event);
-    }
+static void queue_peripheral_event(const struct peripheral_event_wrapper *ev) {
+    zmk_split_transport_central_peripheral_event_queue(&bt_central, ev->source, ev->event);
 }
@@ -17,6 +17,12 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 #include <zephyr/bluetooth/gatt.h>
 #include <zephyr/bluetooth/uuid.h>
 
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_LINK_QUALITY)
+#include <zephyr/bluetooth/conn.h>
+#include <zephyr/bluetooth/hci.h>
+#include <zephyr/net/buf.h>
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_LINK_QUALITY)
+
 #include <drivers/behavior.h>
 #include <zmk/stdlib.h>
 #include <zmk/behavior.h>
@@ -57,6 +63,30 @@ static uint8_t position_state[POS_STATE_LEN];
 
 static struct zmk_split_run_behavior_payload behavior_run_payload;
 
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_LINK_QUALITY)
+
+static uint16_t link_notify_errors;
+static uint16_t link_queue_drops;
+
+static ssize_t split_svc_link_quality(struct bt_conn *conn, const struct bt_gatt_attr *attrs,
+                                      void *buf, uint16_t len, uint16_t offset);
+
+static void split_svc_link_quality_ccc(const struct bt_gatt_attr *attr, uint16_t value);
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_LINK_QUALITY)
+
+static void count_notify_error(void) {
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_LINK_QUALITY)
+    link_notify_errors++;
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_LINK_QUALITY)
+}
+
+static void count_queue_drop(void) {
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_LINK_QUALITY)
+    link_queue_drops++;
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_LINK_QUALITY)
+}
+
 static ssize_t split_svc_pos_state(struct bt_conn *conn, const struct bt_gatt_attr *attrs,
                                    void *buf, uint16_t len, uint16_t offset) {
     return bt_gatt_attr_read(conn, attrs, buf, len, offset, &position_state,
@@ -67,6 +97,17 @@ static ssize_t split_svc_run_behavior(struct bt_conn *conn, const struct bt_gatt
                                       const void *buf, uint16_t len, uint16_t offset,
                                       uint8_t flags);
 
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_COMPACT_BEHAVIORS)
+
+static ssize_t split_svc_run_compact_behaviors(struct bt_conn *conn,
+                                               const struct bt_gatt_attr *attrs, const void *buf,
+                                               uint16_t len, uint16_t offset, uint8_t flags);
+
+static ssize_t split_svc_behavior_table(struct bt_conn *conn, const struct bt_gatt_attr *attrs,
+                                        void *buf, uint16_t len, uint16_t offset);
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_COMPACT_BEHAVIORS)
+
 static ssize_t split_svc_num_of_positions(struct bt_conn *conn, const struct bt_gatt_attr *attrs,
                                           void *buf, uint16_t len, uint16_t offset) {
     return bt_gatt_attr_read(conn, attrs, buf, len, offset, attrs->user_data, sizeof(uint8_t));
@@ -76,6 +117,23 @@ static void split_svc_pos_state_ccc(const struct bt_gatt_attr *attr, uint16_t va
     LOG_DBG("value %d", value);
 }
 
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_POSITION_DELTAS)
+
+static bool position_deltas_enabled;
+
+static void discard_position_deltas(void);
+
+static void split_svc_pos_delta_ccc(const struct bt_gatt_attr *attr, uint16_t value) {
+    LOG_DBG("value %d", value);
+    position_deltas_enabled = (value == BT_GATT_CCC_NOTIFY);
+
+    if (!position_deltas_enabled) {
+        discard_position_deltas();
+    }
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_POSITION_DELTAS)
+
 #if IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_HID_INDICATORS)
 
 static zmk_hid_indicators_t hid_indicators = 0;
@@ -240,7 +298,28 @@ BT_GATT_SERVICE_DEFINE(
     BT_GATT_CHARACTERISTIC(BT_UUID_DECLARE_128(ZMK_SPLIT_BT_CHAR_WPM_UUID),
                            BT_GATT_CHRC_WRITE_WITHOUT_RESP,
                            BT_GATT_PERM_WRITE_ENCRYPT,
-                           NULL, split_svc_receive_wpm, &wpm_value), );
+                           NULL, split_svc_receive_wpm, &wpm_value),
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_POSITION_DELTAS)
+    // Kept last so the hardcoded attribute indexes above stay valid.
+    BT_GATT_CHARACTERISTIC(BT_UUID_DECLARE_128(ZMK_SPLIT_BT_CHAR_POSITION_DELTA_UUID),
+                           BT_GATT_CHRC_NOTIFY, BT_GATT_PERM_READ_ENCRYPT, NULL, NULL, NULL),
+    BT_GATT_CCC(split_svc_pos_delta_ccc, BT_GATT_PERM_READ_ENCRYPT | BT_GATT_PERM_WRITE_ENCRYPT),
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_POSITION_DELTAS)
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_COMPACT_BEHAVIORS)
+    BT_GATT_CHARACTERISTIC(BT_UUID_DECLARE_128(ZMK_SPLIT_BT_CHAR_RUN_COMPACT_BEHAVIORS_UUID),
+                           BT_GATT_CHRC_WRITE_WITHOUT_RESP, BT_GATT_PERM_WRITE_ENCRYPT, NULL,
+                           split_svc_run_compact_behaviors, NULL),
+    BT_GATT_CHARACTERISTIC(BT_UUID_DECLARE_128(ZMK_SPLIT_BT_CHAR_BEHAVIOR_TABLE_UUID),
+                           BT_GATT_CHRC_READ, BT_GATT_PERM_READ_ENCRYPT, split_svc_behavior_table,
+                           NULL, NULL),
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_COMPACT_BEHAVIORS)
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_LINK_QUALITY)
+    BT_GATT_CHARACTERISTIC(BT_UUID_DECLARE_128(ZMK_SPLIT_BT_CHAR_LINK_QUALITY_UUID),
+                           BT_GATT_CHRC_READ | BT_GATT_CHRC_NOTIFY, BT_GATT_PERM_READ_ENCRYPT,
+                           split_svc_link_quality, NULL, NULL),
+    BT_GATT_CCC(split_svc_link_quality_ccc, BT_GATT_PERM_READ_ENCRYPT | BT_GATT_PERM_WRITE_ENCRYPT),
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_LINK_QUALITY)
+);
 
 K_THREAD_STACK_DEFINE(service_q_stack, CONFIG_ZMK_SPLIT_BLE_PERIPHERAL_STACK_SIZE);
 
@@ -256,6 +335,7 @@ void send_position_state_callback(struct k_work *work) {
         int err = bt_gatt_notify(NULL, &split_svc.attrs[1], &state, sizeof(state));
         if (err) {
             LOG_DBG("Error notifying %d", err);
+            count_notify_error();
         }
     }
 };
@@ -268,6 +348,7 @@ int send_position_state() {
         switch (err) {
         case -EAGAIN: {
             LOG_WRN("Position state message queue full, popping first message and queueing again");
+            count_queue_drop();
             uint8_t discarded_state[POS_STATE_LEN];
             k_msgq_get(&position_state_msgq, &discarded_state, K_NO_WAIT);
             return send_position_state();
@@ -283,16 +364,179 @@ int send_position_state() {
     return 0;
 }
 
-static int zmk_split_bt_position_pressed(uint8_t position) {
-    WRITE_BIT(position_state[position / 8], position % 8, true);
-    return send_position_state();
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_POSITION_DELTAS)
+
+struct position_delta_item {
+    uint32_t timestamp;
+    uint8_t seq;
+    uint8_t position;
+    bool pressed;
+};
+
+K_MSGQ_DEFINE(position_delta_msgq, sizeof(struct position_delta_item),
+              CONFIG_ZMK_SPLIT_BLE_PERIPHERAL_POSITION_QUEUE_SIZE, 4);
+
+static const struct bt_gatt_attr *position_delta_attr;
+static uint8_t next_delta_seq;
+
+// How long to wait before retrying a batch of deltas whose notify failed, e.g. for lack of
+// buffers.
+#define POSITION_DELTAS_RETRY_MS 10
+
+// A batch whose notify failed, and the delta that was taken from the queue to start the next
+// one. Both go out before anything newer: a lost batch at the end of a burst leaves the central
+// no sequence gap to resync from, so a dropped release would keep the key held until the next
+// key change.
+static struct zmk_split_position_deltas_payload pending_deltas;
+static size_t pending_deltas_count;
+static struct position_delta_item carried_delta;
+static bool has_carried_delta;
+
+static void send_position_deltas_callback(struct k_work *work);
+
+K_WORK_DELAYABLE_DEFINE(service_position_delta_notify_work, send_position_deltas_callback);
+
+// Returns false if the batch was kept to be retried.
+static bool notify_position_deltas(const struct zmk_split_position_deltas_payload *payload,
+                                   size_t count) {
+    size_t len = offsetof(struct zmk_split_position_deltas_payload, deltas) +
+                 count * sizeof(struct zmk_split_position_delta);
+
+    int err = bt_gatt_notify(NULL, position_delta_attr, payload, len);
+    if (err) {
+        LOG_DBG("Error notifying %d, retrying in %dms", err, POSITION_DELTAS_RETRY_MS);
+        count_notify_error();
+
+        if (payload != &pending_deltas) {
+            pending_deltas = *payload;
+        }
+        pending_deltas_count = count;
+
+        k_work_reschedule_for_queue(&service_work_q, &service_position_delta_notify_work,
+                                    K_MSEC(POSITION_DELTAS_RETRY_MS));
+        return false;
+    }
+
+    pending_deltas_count = 0;
+    return true;
+}
+
+static bool take_position_delta(struct position_delta_item *item) {
+    if (has_carried_delta) {
+        *item = carried_delta;
+        has_carried_delta = false;
+        return true;
+    }
+
+    return k_msgq_get(&position_delta_msgq, item, K_NO_WAIT) == 0;
 }
 
-static int zmk_split_bt_position_released(uint8_t position) {
-    WRITE_BIT(position_state[position / 8], position % 8, false);
+static void send_position_deltas_callback(struct k_work *work) {
+    struct zmk_split_position_deltas_payload payload;
+    struct position_delta_item item;
+    size_t count = 0;
+
+    if (!position_deltas_enabled) {
+        // Anything left is superseded by the bitmap the central reads once it resubscribes.
+        pending_deltas_count = 0;
+        has_carried_delta = false;
+        k_msgq_purge(&position_delta_msgq);
+        return;
+    }
+
+    if (pending_deltas_count > 0 &&
+        !notify_position_deltas(&pending_deltas, pending_deltas_count)) {
+        return;
+    }
+
+    uint32_t now = k_uptime_get_32();
+
+    while (take_position_delta(&item)) {
+        if (count > 0 && (count == ZMK_SPLIT_POSITION_DELTAS_MAX ||
+                          item.seq != (uint8_t)(payload.seq + count))) {
+            if (!notify_position_deltas(&payload, count)) {
+                carried_delta = item;
+                has_carried_delta = true;
+                return;
+            }
+            count = 0;
+        }
+
+        if (count == 0) {
+            now = k_uptime_get_32();
+            payload.seq = item.seq;
+            payload.timestamp = sys_cpu_to_le32(now);
+        }
+
+        uint32_t age = MIN(now - item.timestamp, ZMK_SPLIT_POSITION_DELTA_AGE_MAX);
+
+        payload.deltas[count++] = (struct zmk_split_position_delta){
+            .position = item.position,
+            .state_and_age =
+                sys_cpu_to_le16((item.pressed ? ZMK_SPLIT_POSITION_DELTA_PRESSED : 0) | age),
+        };
+    }
+
+    if (count > 0) {
+        notify_position_deltas(&payload, count);
+    }
+}
+
+// Drops undelivered deltas from the work queue, so a later subscription doesn't replay them.
+static void discard_position_deltas(void) {
+    k_work_reschedule_for_queue(&service_work_q, &service_position_delta_notify_work, K_NO_WAIT);
+}
+
+static int send_position_delta(uint8_t position, bool pressed, uint32_t timestamp) {
+    struct position_delta_item item = {
+        .timestamp = timestamp,
+        .seq = next_delta_seq++,
+        .position = position,
+        .pressed = pressed,
+    };
+
+    int err = k_msgq_put(&position_delta_msgq, &item, K_NO_WAIT);
+    if (err == -ENOMSG) {
+        // The resulting sequence gap makes the central resync from the bitmap.
+        LOG_WRN("Position delta queue full, dropping the oldest delta");
+        count_queue_drop();
+        struct position_delta_item discarded;
+        k_msgq_get(&position_delta_msgq, &discarded, K_NO_WAIT);
+        err = k_msgq_put(&position_delta_msgq, &item, K_NO_WAIT);
+    }
+
+    if (err) {
+        LOG_WRN("Failed to queue position delta to send (%d)", err);
+        return err;
+    }
+
+    k_work_schedule_for_queue(&service_work_q, &service_position_delta_notify_work, K_NO_WAIT);
+
+    return 0;
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_POSITION_DELTAS)
+
+static int send_position_change(uint8_t position, bool pressed, uint32_t timestamp) {
+    WRITE_BIT(position_state[position / 8], position % 8, pressed);
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_POSITION_DELTAS)
+    if (position_deltas_enabled) {
+        return send_position_delta(position, pressed, timestamp);
+    }
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_POSITION_DELTAS)
+
     return send_position_state();
 }
 
+static int zmk_split_bt_position_pressed(uint8_t position, uint32_t timestamp) {
+    return send_position_change(position, true, timestamp);
+}
+
+static int zmk_split_bt_position_released(uint8_t position, uint32_t timestamp) {
+    return send_position_change(position, false, timestamp);
+}
+
 #if ZMK_KEYMAP_HAS_SENSORS
 K_MSGQ_DEFINE(sensor_state_msgq, sizeof(struct sensor_event),
               CONFIG_ZMK_SPLIT_BLE_PERIPHERAL_POSITION_QUEUE_SIZE, 4);
@@ -303,6 +547,7 @@ void send_sensor_state_callback(struct k_work *work) {
                                  sizeof(last_sensor_event));
         if (err) {
             LOG_DBG("Error notifying %d", err);
+            count_notify_error();
         }
     }
 };
@@ -369,12 +614,156 @@ static int zmk_split_bt_report_input(uint8_t reg, uint8_t type, uint16_t code, i
 
 #endif /* IS_ENABLED(CONFIG_ZMK_INPUT_SPLIT) */
 
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_LINK_QUALITY)
+
+static const struct bt_gatt_attr *link_quality_attr;
+static bool link_quality_enabled;
+
+// Last RSSI read from the controller, so GATT reads never wait on an HCI round trip.
+static atomic_t link_quality_rssi = ATOMIC_INIT(ZMK_SPLIT_LINK_QUALITY_RSSI_UNKNOWN);
+
+K_THREAD_STACK_DEFINE(link_quality_q_stack,
+                      CONFIG_ZMK_SPLIT_BLE_PERIPHERAL_LINK_QUALITY_STACK_SIZE);
+
+static struct k_work_q link_quality_q;
+
+static void link_quality_work_cb(struct k_work *work);
+
+static K_WORK_DELAYABLE_DEFINE(link_quality_work, link_quality_work_cb);
+
+static void find_central_conn(struct bt_conn *conn, void *data) {
+    struct bt_conn **central_conn = data;
+    struct bt_conn_info info;
+
+    if (*central_conn == NULL && bt_conn_get_info(conn, &info) == 0 &&
+        info.role == BT_CONN_ROLE_PERIPHERAL && info.state == BT_CONN_STATE_CONNECTED) {
+        *central_conn = bt_conn_ref(conn);
+    }
+}
+
+static int8_t read_central_rssi(void) {
+    struct bt_hci_cp_read_rssi *cp;
+    struct bt_hci_rp_read_rssi *rp;
+    struct net_buf *buf, *rsp;
+    struct bt_conn *conn = NULL;
+    int8_t rssi = ZMK_SPLIT_LINK_QUALITY_RSSI_UNKNOWN;
+    uint16_t handle;
+
+    bt_conn_foreach(BT_CONN_TYPE_LE, find_central_conn, &conn);
+    if (!conn) {
+        return rssi;
+    }
+
+    int err = bt_hci_get_conn_handle(conn, &handle);
+    bt_conn_unref(conn);
+    if (err < 0) {
+        return rssi;
+    }
+
+    buf = bt_hci_cmd_create(BT_HCI_OP_READ_RSSI, sizeof(*cp));
+    if (!buf) {
+        return rssi;
+    }
+
+    cp = net_buf_add(buf, sizeof(*cp));
+    cp->handle = sys_cpu_to_le16(handle);
+
+    if (bt_hci_cmd_send_sync(BT_HCI_OP_READ_RSSI, buf, &rsp) < 0) {
+        return rssi;
+    }
+
+    rp = (void *)rsp->data;
+    if (rp->status == 0) {
+        rssi = rp->rssi;
+    }
+
+    net_buf_unref(rsp);
+
+    return rssi;
+}
+
+static void get_link_quality(struct zmk_split_link_quality_payload *payload) {
+    *payload = (struct zmk_split_link_quality_payload){
+        .rssi = (int8_t)atomic_get(&link_quality_rssi),
+        .notify_errors = sys_cpu_to_le16(link_notify_errors),
+        .queue_drops = sys_cpu_to_le16(link_queue_drops),
+    };
+}
+
+static ssize_t split_svc_link_quality(struct bt_conn *conn, const struct bt_gatt_attr *attrs,
+                                      void *buf, uint16_t len, uint16_t offset) {
+    struct zmk_split_link_quality_payload payload;
+
+    get_link_quality(&payload);
+
+    // Without periodic reports nothing refreshes the cached RSSI, so do it for the next read.
+    if (!link_quality_enabled) {
+        k_work_schedule_for_queue(&link_quality_q, &link_quality_work, K_NO_WAIT);
+    }
+
+    return bt_gatt_attr_read(conn, attrs, buf, len, offset, &payload, sizeof(payload));
+}
+
+// The reading is taken from the connected link itself, so no extra radio activity is needed.
+// Runs on its own low priority queue, so the blocking HCI round trip never holds up the system
+// work queue or key notifications.
+static void link_quality_work_cb(struct k_work *work) {
+    struct zmk_split_link_quality_payload payload;
+
+    atomic_set(&link_quality_rssi, read_central_rssi());
+
+    if (!link_quality_enabled) {
+        return;
+    }
+
+    get_link_quality(&payload);
+
+    int err = bt_gatt_notify(NULL, link_quality_attr, &payload, sizeof(payload));
+    if (err) {
+        LOG_DBG("Error notifying link quality %d", err);
+    }
+
+    k_work_schedule_for_queue(&link_quality_q, &link_quality_work,
+                              K_MSEC(CONFIG_ZMK_SPLIT_BLE_PERIPHERAL_LINK_QUALITY_PERIOD_MS));
+}
+
+static void split_svc_link_quality_ccc(const struct bt_gatt_attr *attr, uint16_t value) {
+    link_quality_enabled =
+        (value == BT_GATT_CCC_NOTIFY) && CONFIG_ZMK_SPLIT_BLE_PERIPHERAL_LINK_QUALITY_PERIOD_MS > 0;
+
+    if (link_quality_enabled) {
+        k_work_schedule_for_queue(&link_quality_q, &link_quality_work, K_NO_WAIT);
+    } else {
+        k_work_cancel_delayable(&link_quality_work);
+    }
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_LINK_QUALITY)
+
 static int service_init(void) {
     static const struct k_work_queue_config queue_config = {
         .name = "Split Peripheral Notification Queue"};
     k_work_queue_start(&service_work_q, service_q_stack, K_THREAD_STACK_SIZEOF(service_q_stack),
                        CONFIG_ZMK_SPLIT_BLE_PERIPHERAL_PRIORITY, &queue_config);
 
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_POSITION_DELTAS)
+    position_delta_attr =
+        bt_gatt_find_by_uuid(split_svc.attrs, split_svc.attr_count,
+                             BT_UUID_DECLARE_128(ZMK_SPLIT_BT_CHAR_POSITION_DELTA_UUID));
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_POSITION_DELTAS)
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_LINK_QUALITY)
+    static const struct k_work_queue_config link_quality_queue_config = {
+        .name = "Split Peripheral Link Quality"};
+    k_work_queue_start(&link_quality_q, link_quality_q_stack,
+                       K_THREAD_STACK_SIZEOF(link_quality_q_stack),
+                       K_LOWEST_APPLICATION_THREAD_PRIO, &link_quality_queue_config);
+
+    link_quality_attr =
+        bt_gatt_find_by_uuid(split_svc.attrs, split_svc.attr_count,
+                             BT_UUID_DECLARE_128(ZMK_SPLIT_BT_CHAR_LINK_QUALITY_UUID));
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_LINK_QUALITY)
+
     return 0;
 }
 
@@ -385,9 +774,11 @@ int zmk_split_transport_peripheral_bt_report_event(
     switch (ev->type) {
     case ZMK_SPLIT_TRANSPORT_PERIPHERAL_EVENT_TYPE_KEY_POSITION_EVENT:
         if (ev->data.key_position_event.pressed) {
-            zmk_split_bt_position_pressed(ev->data.key_position_event.position);
+            zmk_split_bt_position_pressed(ev->data.key_position_event.position,
+                                          ev->data.key_position_event.timestamp);
         } else {
-            zmk_split_bt_position_released(ev->data.key_position_event.position);
+            zmk_split_bt_position_released(ev->data.key_position_event.position,
+                                           ev->data.key_position_event.timestamp);
         }
         break;
 #if ZMK_KEYMAP_HAS_SENSORS
@@ -470,3 +861,136 @@ static ssize_t split_svc_run_behavior(struct bt_conn *conn, const struct bt_gatt
 
     return len;
 }
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_COMPACT_BEHAVIORS)
+
+static ssize_t split_svc_behavior_table(struct bt_conn *conn, const struct bt_gatt_attr *attrs,
+                                        void *buf, uint16_t len, uint16_t offset) {
+    // The table is generated on the fly, copying whichever part of it overlaps the requested
+    // window. The central uses long reads to fetch all of it.
+    uint8_t *out = buf;
+    uint16_t written = 0;
+    size_t table_pos = 0;
+    size_t id = 0;
+
+    STRUCT_SECTION_FOREACH(zmk_behavior_ref, item) {
+        if (id++ >= ZMK_SPLIT_COMPACT_BEHAVIOR_ID_NONE || written == len) {
+            break;
+        }
+
+        const size_t entry_len = strlen(item->device->name) + 1;
+
+        if (table_pos + entry_len > offset) {
+            const size_t start = MAX(table_pos, offset) - table_pos;
+            const size_t count = MIN(entry_len - start, len - written);
+
+            memcpy(out + written, item->device->name + start, count);
+            written += count;
+        }
+
+        table_pos += entry_len;
+    }
+
+    if (offset > table_pos) {
+        return BT_GATT_ERR(BT_ATT_ERR_INVALID_OFFSET);
+    }
+
+    return written;
+}
+
+static const uint8_t compact_param_widths[] = ZMK_SPLIT_COMPACT_BEHAVIOR_WIDTHS;
+
+static uint8_t compact_param_len(uint8_t flags, uint8_t shift) {
+    return compact_param_widths[(flags >> shift) & ZMK_SPLIT_COMPACT_BEHAVIOR_WIDTH_MASK];
+}
+
+static uint32_t compact_param_get(const uint8_t *data, uint8_t len) {
+    uint32_t param = 0;
+
+    for (int i = 0; i < len; i++) {
+        param |= (uint32_t)data[i] << (8 * i);
+    }
+
+    return param;
+}
+
+static int compact_behavior_frame_len(const uint8_t *data, uint16_t len) {
+    const struct zmk_split_compact_behavior_header *header = (const void *)data;
+
+    if (len < sizeof(*header)) {
+        return -EINVAL;
+    }
+
+    const uint16_t frame_len =
+        sizeof(*header) +
+        compact_param_len(header->flags, ZMK_SPLIT_COMPACT_BEHAVIOR_PARAM1_WIDTH_SHIFT) +
+        compact_param_len(header->flags, ZMK_SPLIT_COMPACT_BEHAVIOR_PARAM2_WIDTH_SHIFT);
+
+    return len < frame_len ? -EINVAL : frame_len;
+}
+
+// Decodes a compact frame into an invoke command. The behavior is passed by device, so names of
+// any length work.
+static int invoke_compact_behavior(const uint8_t *data) {
+    const struct zmk_split_compact_behavior_header *header = (const void *)data;
+    const uint8_t param1_len =
+        compact_param_len(header->flags, ZMK_SPLIT_COMPACT_BEHAVIOR_PARAM1_WIDTH_SHIFT);
+    const uint8_t param2_len =
+        compact_param_len(header->flags, ZMK_SPLIT_COMPACT_BEHAVIOR_PARAM2_WIDTH_SHIFT);
+    const uint8_t *params = data + sizeof(*header);
+
+    ptrdiff_t count;
+    STRUCT_SECTION_COUNT(zmk_behavior_ref, &count);
+    if (header->id >= count) {
+        LOG_ERR("Unknown compact behavior ID %d", header->id);
+        return -ENODEV;
+    }
+
+    const struct zmk_behavior_ref *ref;
+    STRUCT_SECTION_GET(zmk_behavior_ref, header->id, &ref);
+
+    struct zmk_split_transport_central_command cmd = {
+        .type = ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_INVOKE_BEHAVIOR,
+        .data = {.invoke_behavior =
+                     {
+                         .param1 = compact_param_get(params, param1_len),
+                         .param2 = compact_param_get(params + param1_len, param2_len),
+                         .position = header->position,
+                         .state = (header->flags & ZMK_SPLIT_COMPACT_BEHAVIOR_PRESSED) ? 1 : 0,
+                     }},
+        .behavior = ref->device,
+    };
+
+    strlcpy(cmd.data.invoke_behavior.behavior_dev, ref->device->name,
+            sizeof(cmd.data.invoke_behavior.behavior_dev));
+
+    return zmk_split_transport_peripheral_command_handler(zmk_split_transport_peripheral_bt(), cmd);
+}
+
+static ssize_t split_svc_run_compact_behaviors(struct bt_conn *conn,
+                                               const struct bt_gatt_attr *attrs, const void *buf,
+                                               uint16_t len, uint16_t offset, uint8_t flags) {
+    if (offset != 0) {
+        return BT_GATT_ERR(BT_ATT_ERR_INVALID_OFFSET);
+    }
+
+    const uint8_t *data = buf;
+    uint16_t pos = 0;
+
+    LOG_DBG("len %d", len);
+
+    while (pos < len) {
+        int frame_len = compact_behavior_frame_len(data + pos, len - pos);
+        if (frame_len < 0) {
+            LOG_ERR("Truncated compact behavior frame at offset %d", pos);
+            return BT_GATT_ERR(BT_ATT_ERR_INVALID_ATTRIBUTE_LEN);
+        }
+
+        invoke_compact_behavior(data + pos);
+        pos += frame_len;
+    }
+
+    return len;
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_COMPACT_BEHAVIORS)
@@ -6,6 +6,9 @@
 
 #include <errno.h>
 
+#include <zephyr/kernel.h>
+#include <zephyr/spinlock.h>
+
 #include <zmk/stdlib.h>
 #include <zmk/split/transport/central.h>
 #include <zmk/split/central.h>
@@ -30,9 +33,85 @@ static uint8_t peripheral_battery_levels[ZMK_SPLIT_CENTRAL_PERIPHERAL_COUNT] = {
 
 #endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_BATTERY_LEVEL_FETCHING)
 
-int zmk_split_transport_central_peripheral_event_handler(
-    const struct zmk_split_transport_central *transport, uint8_t source,
-    struct zmk_split_transport_peripheral_event ev) {
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_TIMESTAMPS)
+
+struct peripheral_clock {
+    bool valid;
+    uint32_t last_remote;
+    // Added to the 32 bit peripheral uptime to extend it past wraparound
+    int64_t remote_base;
+    // Estimated local minus peripheral time, including the fastest delivery seen
+    int64_t offset;
+    int64_t last_sample_at;
+    int64_t last_timestamp;
+};
+
+static struct peripheral_clock peripheral_clocks[ZMK_SPLIT_CENTRAL_PERIPHERAL_COUNT];
+static struct k_spinlock peripheral_clocks_lock;
+
+static int64_t peripheral_event_timestamp(uint8_t source, uint32_t remote) {
+    int64_t now = k_uptime_get();
+
+    if (remote == 0 || source >= ARRAY_SIZE(peripheral_clocks)) {
+        return now;
+    }
+
+    struct peripheral_clock *clock = &peripheral_clocks[source];
+
+    if (clock->valid && remote < clock->last_remote && clock->last_remote - remote > BIT(31)) {
+        clock->remote_base += BIT64(32);
+    }
+    clock->last_remote = remote;
+
+    int64_t remote_time = clock->remote_base + remote;
+    int64_t sample = now - remote_time;
+
+    if (!clock->valid || sample <= clock->offset ||
+        sample - clock->offset > CONFIG_ZMK_SPLIT_PERIPHERAL_CLOCK_RESET_MS) {
+        clock->offset = sample;
+    } else {
+        // Let the estimate creep up by 1ms per second so a slower peripheral clock is followed.
+        clock->offset = MIN(sample, clock->offset + (now - clock->last_sample_at) / 1000);
+    }
+
+    clock->valid = true;
+    clock->last_sample_at = now;
+
+    // Never report an event as happening in the future, or before one already reported.
+    int64_t timestamp = CLAMP(remote_time + clock->offset, clock->last_timestamp, now);
+    clock->last_timestamp = timestamp;
+
+    LOG_DBG("Peripheral %d event at %u mapped to %lld (offset %lld, received %lld)", source,
+            remote, timestamp, clock->offset, now);
+
+    return timestamp;
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_TIMESTAMPS)
+
+// Gets the time a peripheral event happened on the central's clock. Must be called as the event
+// is received, and for each peripheral's events in order.
+static int64_t
+get_peripheral_event_timestamp(uint8_t source,
+                               const struct zmk_split_transport_peripheral_event *ev) {
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_TIMESTAMPS)
+    if (ev->type == ZMK_SPLIT_TRANSPORT_PERIPHERAL_EVENT_TYPE_KEY_POSITION_EVENT) {
+        // Events handled inline and from the event queue are timestamped on different threads.
+        k_spinlock_key_t key = k_spin_lock(&peripheral_clocks_lock);
+        int64_t timestamp =
+            peripheral_event_timestamp(source, ev->data.key_position_event.timestamp);
+        k_spin_unlock(&peripheral_clocks_lock, key);
+
+        return timestamp;
+    }
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_TIMESTAMPS)
+
+    return k_uptime_get();
+}
+
+static int raise_peripheral_event(const struct zmk_split_transport_central *transport,
+                                  uint8_t source, struct zmk_split_transport_peripheral_event ev,
+                                  int64_t timestamp) {
     if (transport != active_transport) {
         // Ignoring events from non-active transport
         LOG_WRN("Ignoring peripheral event from non-active transport");
@@ -44,7 +123,7 @@ int zmk_split_transport_central_peripheral_event_handler(
                                                       .position =
                                                           ev.data.key_position_event.position,
                                                       .state = ev.data.key_position_event.pressed,
-                                                      .timestamp = k_uptime_get()};
+                                                      .timestamp = timestamp};
         return raise_zmk_position_state_changed(state_ev);
     }
 #if IS_ENABLED(CONFIG_ZMK_INPUT_SPLIT)
@@ -67,7 +146,7 @@ int zmk_split_transport_central_peripheral_event_handler(
     case ZMK_SPLIT_TRANSPORT_PERIPHERAL_EVENT_TYPE_SENSOR_EVENT: {
         struct zmk_sensor_event sensor_ev = {.sensor_index = ev.data.sensor_event.sensor_index,
                                              .channel_data_size = 1,
-                                             .timestamp = k_uptime_get()};
+                                             .timestamp = timestamp};
 
         sensor_ev.channel_data[0] = ev.data.sensor_event.channel_data;
 
@@ -88,6 +167,141 @@ int zmk_split_transport_central_peripheral_event_handler(
     }
 }
 
+int zmk_split_transport_central_peripheral_event_handler(
+    const struct zmk_split_transport_central *transport, uint8_t source,
+    struct zmk_split_transport_peripheral_event ev) {
+    return raise_peripheral_event(transport, source, ev,
+                                  get_peripheral_event_timestamp(source, &ev));
+}
+
+struct queued_peripheral_event {
+    const struct zmk_split_transport_central *transport;
+    uint8_t source;
+    struct zmk_split_transport_peripheral_event event;
+};
+
+K_MSGQ_DEFINE(peripheral_event_msgq, sizeof(struct queued_peripheral_event),
+              CONFIG_ZMK_SPLIT_CENTRAL_EVENT_QUEUE_SIZE, 4);
+
+static struct zmk_split_central_event_queue_stats event_queue_stats;
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_CENTRAL_EVENT_WORK_QUEUE)
+
+// Events are timestamped on a dedicated queue as soon as they arrive, then raised on the system
+// work queue, the only place the keymap, HID and event manager are entered from. Housekeeping
+// work there can delay them, but no longer skews their timing or overflows the transports' queue.
+
+struct received_peripheral_event {
+    struct queued_peripheral_event queued;
+    int64_t timestamp;
+};
+
+K_MSGQ_DEFINE(received_event_msgq, sizeof(struct received_peripheral_event),
+              CONFIG_ZMK_SPLIT_CENTRAL_EVENT_QUEUE_SIZE, 8);
+
+K_THREAD_STACK_DEFINE(peripheral_event_q_stack,
+                      CONFIG_ZMK_SPLIT_CENTRAL_EVENT_WORK_QUEUE_STACK_SIZE);
+
+static struct k_work_q peripheral_event_q;
+
+static void received_event_work_cb(struct k_work *work) {
+    struct received_peripheral_event ev;
+
+    while (k_msgq_get(&received_event_msgq, &ev, K_NO_WAIT) == 0) {
+        raise_peripheral_event(ev.queued.transport, ev.queued.source, ev.queued.event,
+                               ev.timestamp);
+    }
+}
+
+static K_WORK_DEFINE(received_event_work, received_event_work_cb);
+
+static void peripheral_event_work_cb(struct k_work *work) {
+    struct received_peripheral_event ev;
+
+    while (k_msgq_get(&peripheral_event_msgq, &ev.queued, K_NO_WAIT) == 0) {
+        ev.timestamp = get_peripheral_event_timestamp(ev.queued.source, &ev.queued.event);
+
+        // Waiting here for the system work queue to catch up leaves new events to queue up, and
+        // be counted if dropped, in the transports' queue.
+        k_msgq_put(&received_event_msgq, &ev, K_FOREVER);
+        k_work_submit(&received_event_work);
+    }
+}
+
+#else
+
+static void peripheral_event_work_cb(struct k_work *work) {
+    struct queued_peripheral_event ev;
+
+    while (k_msgq_get(&peripheral_event_msgq, &ev, K_NO_WAIT) == 0) {
+        zmk_split_transport_central_peripheral_event_handler(ev.transport, ev.source, ev.event);
+    }
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_CENTRAL_EVENT_WORK_QUEUE)
+
+static K_WORK_DEFINE(peripheral_event_work, peripheral_event_work_cb);
+
+static uint16_t get_event_queue_depth(void) {
+    uint16_t depth = k_msgq_num_used_get(&peripheral_event_msgq);
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_CENTRAL_EVENT_WORK_QUEUE)
+    depth += k_msgq_num_used_get(&received_event_msgq);
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_CENTRAL_EVENT_WORK_QUEUE)
+
+    return depth;
+}
+
+int zmk_split_transport_central_peripheral_event_queue(
+    const struct zmk_split_transport_central *transport, uint8_t source,
+    struct zmk_split_transport_peripheral_event ev) {
+    // A transport already running on the system work queue would fill the queue before its events
+    // could be raised, so it handles them inline, after anything waiting to be raised.
+    if (k_current_get() == k_work_queue_thread_get(&k_sys_work_q)) {
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_CENTRAL_EVENT_WORK_QUEUE)
+        received_event_work_cb(&received_event_work);
+#else
+        peripheral_event_work_cb(&peripheral_event_work);
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_CENTRAL_EVENT_WORK_QUEUE)
+        return zmk_split_transport_central_peripheral_event_handler(transport, source, ev);
+    }
+
+    struct queued_peripheral_event queued = {
+        .transport = transport,
+        .source = source,
+        .event = ev,
+    };
+
+    int err = k_msgq_put(&peripheral_event_msgq, &queued, K_NO_WAIT);
+    if (err < 0) {
+        event_queue_stats.dropped++;
+        LOG_WRN("Peripheral event queue full, dropping event type %d from %d", ev.type, source);
+        return err;
+    }
+
+    event_queue_stats.queued++;
+    event_queue_stats.max_depth = MAX(event_queue_stats.max_depth, get_event_queue_depth());
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_CENTRAL_EVENT_WORK_QUEUE)
+    k_work_submit_to_queue(&peripheral_event_q, &peripheral_event_work);
+#else
+    k_work_submit(&peripheral_event_work);
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_CENTRAL_EVENT_WORK_QUEUE)
+
+    return 0;
+}
+
+int zmk_split_central_get_event_queue_stats(struct zmk_split_central_event_queue_stats *stats) {
+    if (!stats) {
+        return -EINVAL;
+    }
+
+    *stats = event_queue_stats;
+    stats->depth = get_event_queue_depth();
+
+    return 0;
+}
+
 int zmk_split_central_invoke_behavior(uint8_t source, struct zmk_behavior_binding *binding,
                                       struct zmk_behavior_binding_event event, bool state) {
     if (!active_transport || !active_transport->api || !active_transport->api->send_command) {
@@ -108,6 +322,7 @@ int zmk_split_central_invoke_behavior(uint8_t source, struct zmk_behavior_bindin
                             .state = state ? 1 : 0,
                         },
                 },
+            .behavior = zmk_behavior_get_binding(binding->behavior_dev),
         };
 
     const size_t payload_dev_size = sizeof(command.data.invoke_behavior.behavior_dev);
@@ -199,6 +414,49 @@ int zmk_split_central_update_hid_indicator(zmk_hid_indicators_t indicators) {
 
 #endif // IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_HID_INDICATORS)
 
+int zmk_split_central_get_link_info(uint8_t source, struct zmk_split_transport_link_info *info) {
+    if (!active_transport || !active_transport->api) {
+        return -ENODEV;
+    }
+
+    if (!active_transport->api->get_link_info) {
+        return -ENOTSUP;
+    }
+
+    return active_transport->api->get_link_info(source, info);
+}
+
+int zmk_split_central_get_transport_status(struct zmk_split_transport_status *status) {
+    if (!active_transport || !active_transport->api) {
+        return -ENODEV;
+    }
+
+    if (!active_transport->api->get_status) {
+        *status = (struct zmk_split_transport_status){
+            .available = true,
+            .enabled = true,
+            .connections = ZMK_SPLIT_TRANSPORT_CONNECTIONS_STATUS_ALL_CONNECTED,
+        };
+        return 0;
+    }
+
+    *status = active_transport->api->get_status();
+
+    return 0;
+}
+
+int zmk_split_central_get_command_queue_stats(struct zmk_split_command_queue_stats *stats) {
+    if (!active_transport || !active_transport->api) {
+        return -ENODEV;
+    }
+
+    if (!active_transport->api->get_command_queue_stats) {
+        return -ENOTSUP;
+    }
+
+    return active_transport->api->get_command_queue_stats(stats);
+}
+
 #if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_BATTERY_LEVEL_FETCHING)
 
 int zmk_split_central_get_peripheral_battery_level(uint8_t source, uint8_t *level) {
@@ -262,6 +520,13 @@ static int transport_status_changed_cb(const struct zmk_split_transport_central
 }
 
 static int central_init(void) {
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_CENTRAL_EVENT_WORK_QUEUE)
+    static const struct k_work_queue_config queue_config = {.name = "Split Central Event Queue"};
+    k_work_queue_start(&peripheral_event_q, peripheral_event_q_stack,
+                       K_THREAD_STACK_SIZEOF(peripheral_event_q_stack),
+                       CONFIG_ZMK_SPLIT_CENTRAL_EVENT_WORK_QUEUE_PRIORITY, &queue_config);
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_CENTRAL_EVENT_WORK_QUEUE)
+
     STRUCT_SECTION_FOREACH(zmk_split_transport_central, t) {
         if (!t->api->set_status_callback) {
             continue;
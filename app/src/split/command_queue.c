@@ -0,0 +1,290 @@
+/*
+ * Copyright (c) 2025 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <zmk/split/transport/command_queue.h>
+
+// Latest value slots, in the order they are sent. State comes before telemetry.
+static const enum zmk_split_transport_central_command_type
+    latest_types[ZMK_SPLIT_COMMAND_QUEUE_LATEST_TYPES] = {
+        ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_SET_PHYSICAL_LAYOUT,
+        ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_SET_HID_INDICATORS,
+        ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_SEND_WPM,
+};
+
+static int latest_index(enum zmk_split_transport_central_command_type type) {
+    for (int i = 0; i < ARRAY_SIZE(latest_types); i++) {
+        if (latest_types[i] == type) {
+            return i;
+        }
+    }
+
+    return -ENOENT;
+}
+
+enum zmk_split_command_lane
+zmk_split_command_queue_lane(enum zmk_split_transport_central_command_type type) {
+    switch (type) {
+    case ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_SET_PHYSICAL_LAYOUT:
+    case ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_SET_HID_INDICATORS:
+        return ZMK_SPLIT_COMMAND_LANE_STATE;
+    case ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_SEND_WPM:
+        return ZMK_SPLIT_COMMAND_LANE_TELEMETRY;
+    default:
+        return ZMK_SPLIT_COMMAND_LANE_CRITICAL;
+    }
+}
+
+static bool is_invoke(const struct zmk_split_transport_central_command *cmd, bool pressed) {
+    return cmd->type == ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_INVOKE_BEHAVIOR &&
+           (cmd->data.invoke_behavior.state > 0) == pressed;
+}
+
+static int find_press(struct zmk_split_command_queue *queue, uint8_t source,
+                      const struct zmk_split_transport_central_command *cmd) {
+    for (int i = 0; i < queue->presses_len; i++) {
+        const struct zmk_split_command_queue_press *press = &queue->presses[i];
+
+        if (press->source == source && press->position == cmd->data.invoke_behavior.position &&
+            press->behavior == cmd->behavior) {
+            return i;
+        }
+    }
+
+    return -ENOENT;
+}
+
+static void remove_press(struct zmk_split_command_queue *queue, int index) {
+    queue->presses[index] = queue->presses[--queue->presses_len];
+}
+
+static int count_presses(struct zmk_split_command_queue *queue, uint8_t source) {
+    int count = 0;
+
+    for (int i = 0; i < queue->presses_len; i++) {
+        if (queue->presses[i].source == source) {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+// Must be called with the queue locked. Every outstanding press, whether still queued or already
+// sent, keeps a free slot for its release. Those slots come on top of the lane's own size, so
+// releases always fit and held keys don't crowd out other commands.
+static int try_put_critical(struct zmk_split_command_queue *queue,
+                            const struct zmk_split_command_queue_item *item) {
+    struct zmk_split_command_lane_stats *stats =
+        &queue->stats.lanes[ZMK_SPLIT_COMMAND_LANE_CRITICAL];
+
+    if (is_invoke(&item->cmd, false)) {
+        int index = find_press(queue, item->source, &item->cmd);
+        if (index < 0) {
+            // The peripheral never got the press, so it mustn't get the release either.
+            stats->dropped++;
+            return -ENOENT;
+        }
+
+        remove_press(queue, index);
+    } else {
+        const bool press = is_invoke(&item->cmd, true);
+
+        if (press && count_presses(queue, item->source) >= ZMK_SPLIT_COMMAND_QUEUE_HELD) {
+            stats->rejected++;
+            return -ENOSPC;
+        }
+
+        if (k_msgq_num_free_get(queue->critical) < queue->presses_len + (press ? 2 : 1)) {
+            stats->rejected++;
+            return -EAGAIN;
+        }
+
+        if (press) {
+            queue->presses[queue->presses_len++] = (struct zmk_split_command_queue_press){
+                .source = item->source,
+                .position = item->cmd.data.invoke_behavior.position,
+                .behavior = item->cmd.behavior,
+            };
+        }
+    }
+
+    k_msgq_put(queue->critical, item, K_NO_WAIT);
+
+    stats->queued++;
+    queue->stats.critical_max_depth =
+        MAX(queue->stats.critical_max_depth, k_msgq_num_used_get(queue->critical));
+
+    return 0;
+}
+
+static int put_critical(struct zmk_split_command_queue *queue, uint8_t source,
+                        const struct zmk_split_transport_central_command *cmd) {
+    const struct zmk_split_command_queue_item item = {.source = source, .cmd = *cmd};
+
+    k_spinlock_key_t key = k_spin_lock(&queue->lock);
+    int err = try_put_critical(queue, &item);
+    k_spin_unlock(&queue->lock, key);
+
+    switch (err) {
+    case -ENOENT:
+        LOG_DBG("Dropping release of position %d for %d, its press was never queued",
+                cmd->data.invoke_behavior.position, source);
+        return 0;
+    case -ENOSPC:
+        LOG_WRN("Too many behaviors held on %d, refusing press of position %d", source,
+                cmd->data.invoke_behavior.position);
+        return -EAGAIN;
+    case -EAGAIN:
+        LOG_WRN("Critical split command lane full, refusing command type %d for %d", cmd->type,
+                source);
+        return -EAGAIN;
+    default:
+        return err;
+    }
+}
+
+int zmk_split_command_queue_put(struct zmk_split_command_queue *queue, uint8_t source,
+                                const struct zmk_split_transport_central_command *cmd) {
+    if (source >= queue->sources) {
+        return -EINVAL;
+    }
+
+    enum zmk_split_command_lane lane = zmk_split_command_queue_lane(cmd->type);
+
+    if (lane == ZMK_SPLIT_COMMAND_LANE_CRITICAL) {
+        return put_critical(queue, source, cmd);
+    }
+
+    int idx = latest_index(cmd->type);
+    if (idx < 0) {
+        return -EINVAL;
+    }
+
+    struct zmk_split_command_queue_latest *latest = &queue->latest[source];
+
+    k_spinlock_key_t key = k_spin_lock(&queue->lock);
+    if (latest->pending & BIT(idx)) {
+        queue->stats.lanes[lane].coalesced++;
+    }
+    latest->cmds[idx] = *cmd;
+    latest->pending |= BIT(idx);
+    queue->stats.lanes[lane].queued++;
+    k_spin_unlock(&queue->lock, key);
+
+    return 0;
+}
+
+static bool peek_latest(struct zmk_split_command_queue *queue, enum zmk_split_command_lane lane,
+                        struct zmk_split_command_queue_item *item) {
+    for (int i = 0; i < ARRAY_SIZE(latest_types); i++) {
+        if (zmk_split_command_queue_lane(latest_types[i]) != lane) {
+            continue;
+        }
+
+        for (uint8_t source = 0; source < queue->sources; source++) {
+            if (queue->latest[source].pending & BIT(i)) {
+                item->source = source;
+                item->cmd = queue->latest[source].cmds[i];
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+int zmk_split_command_queue_peek(struct zmk_split_command_queue *queue,
+                                 struct zmk_split_command_queue_item *item,
+                                 enum zmk_split_command_lane *lane) {
+    if (k_msgq_peek(queue->critical, item) == 0) {
+        *lane = ZMK_SPLIT_COMMAND_LANE_CRITICAL;
+        return 0;
+    }
+
+    int ret = -ENODATA;
+    k_spinlock_key_t key = k_spin_lock(&queue->lock);
+
+    if (peek_latest(queue, ZMK_SPLIT_COMMAND_LANE_STATE, item)) {
+        *lane = ZMK_SPLIT_COMMAND_LANE_STATE;
+        ret = 0;
+    } else if (peek_latest(queue, ZMK_SPLIT_COMMAND_LANE_TELEMETRY, item)) {
+        *lane = ZMK_SPLIT_COMMAND_LANE_TELEMETRY;
+        ret = 0;
+    }
+
+    k_spin_unlock(&queue->lock, key);
+
+    return ret;
+}
+
+void zmk_split_command_queue_consume(struct zmk_split_command_queue *queue,
+                                     const struct zmk_split_command_queue_item *item,
+                                     enum zmk_split_command_lane lane, bool sent) {
+    if (lane == ZMK_SPLIT_COMMAND_LANE_CRITICAL) {
+        struct zmk_split_command_queue_item discarded;
+
+        // Producers only ever append, so the head is still the peeked item.
+        k_msgq_get(queue->critical, &discarded, K_NO_WAIT);
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&queue->lock);
+
+    if (lane != ZMK_SPLIT_COMMAND_LANE_CRITICAL) {
+        struct zmk_split_command_queue_latest *latest = &queue->latest[item->source];
+        int idx = latest_index(item->cmd.type);
+
+        if (idx >= 0 && memcmp(&latest->cmds[idx], &item->cmd, sizeof(item->cmd)) == 0) {
+            latest->pending &= ~BIT(idx);
+        }
+    }
+
+    if (sent) {
+        queue->stats.lanes[lane].sent++;
+    } else {
+        queue->stats.lanes[lane].dropped++;
+    }
+
+    k_spin_unlock(&queue->lock, key);
+}
+
+void zmk_split_command_queue_clear_source(struct zmk_split_command_queue *queue, uint8_t source) {
+    if (source >= queue->sources) {
+        return;
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&queue->lock);
+
+    struct zmk_split_command_queue_latest *latest = &queue->latest[source];
+
+    for (int i = 0; i < ARRAY_SIZE(latest_types); i++) {
+        if (latest->pending & BIT(i)) {
+            queue->stats.lanes[zmk_split_command_queue_lane(latest_types[i])].dropped++;
+        }
+    }
+    latest->pending = 0;
+
+    for (int i = queue->presses_len - 1; i >= 0; i--) {
+        if (queue->presses[i].source == source) {
+            remove_press(queue, i);
+        }
+    }
+
+    k_spin_unlock(&queue->lock, key);
+}
+
+void zmk_split_command_queue_get_stats(struct zmk_split_command_queue *queue,
+                                       struct zmk_split_command_queue_stats *stats) {
+    k_spinlock_key_t key = k_spin_lock(&queue->lock);
+    *stats = queue->stats;
+    k_spin_unlock(&queue->lock, key);
+}
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2025 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#define DT_DRV_COMPAT zmk_split_mock_central
+
+#include <zephyr/types.h>
+#include <zephyr/init.h>
+#include <zephyr/kernel.h>
+
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <zmk/split/transport/central.h>
+
+#define MOCK_EVENT_TUPLE_LEN 4
+
+static const uint32_t mock_events[] = DT_INST_PROP(0, events);
+
+BUILD_ASSERT(ARRAY_SIZE(mock_events) % MOCK_EVENT_TUPLE_LEN == 0,
+             "Mock split events must be (position, pressed, wait-ms, jitter-ms) tuples");
+
+static zmk_split_transport_central_status_changed_cb_t transport_status_cb;
+static bool is_enabled;
+
+static size_t event_index;
+// Central uptime at which the current event was "scanned" on the mock peripheral
+static int64_t scanned_at;
+static int64_t last_delivered_at;
+
+static void mock_work_cb(struct k_work *work);
+
+static K_WORK_DELAYABLE_DEFINE(mock_work, mock_work_cb);
+
+static void schedule_next_event(void) {
+    if (event_index >= ARRAY_SIZE(mock_events)) {
+        return;
+    }
+
+    const uint32_t *ev = &mock_events[event_index];
+
+    scanned_at += ev[2];
+
+    // Like a real link, jitter delays delivery but never reorders events.
+    last_delivered_at = MAX(scanned_at + ev[3], last_delivered_at);
+
+    k_work_schedule(&mock_work, K_TIMEOUT_ABS_MS(last_delivered_at));
+}
+
+static int split_central_mock_send_command(uint8_t source,
+                                           struct zmk_split_transport_central_command cmd) {
+    LOG_DBG("Command type %d for source %d", cmd.type, source);
+
+    return 0;
+}
+
+static int split_central_mock_get_available_source_ids(uint8_t *sources) {
+    sources[0] = 0;
+
+    return 1;
+}
+
+static int split_central_mock_set_enabled(bool enabled) {
+    is_enabled = enabled;
+
+    return 0;
+}
+
+static struct zmk_split_transport_status split_central_mock_get_status(void) {
+    return (struct zmk_split_transport_status){
+        .available = true,
+        .enabled = is_enabled,
+        .connections = ZMK_SPLIT_TRANSPORT_CONNECTIONS_STATUS_ALL_CONNECTED,
+    };
+}
+
+static int split_central_mock_set_status_callback(
+    zmk_split_transport_central_status_changed_cb_t cb) {
+    transport_status_cb = cb;
+
+    return 0;
+}
+
+static const struct zmk_split_transport_central_api central_api = {
+    .send_command = split_central_mock_send_command,
+    .get_available_source_ids = split_central_mock_get_available_source_ids,
+    .set_enabled = split_central_mock_set_enabled,
+    .get_status = split_central_mock_get_status,
+    .set_status_callback = split_central_mock_set_status_callback,
+};
+
+ZMK_SPLIT_TRANSPORT_CENTRAL_REGISTER(mock_central, &central_api, CONFIG_ZMK_SPLIT_MOCK_PRIORITY);
+
+static void mock_work_cb(struct k_work *work) {
+    const uint32_t *ev = &mock_events[event_index];
+
+    struct zmk_split_transport_peripheral_event event = {
+        .type = ZMK_SPLIT_TRANSPORT_PERIPHERAL_EVENT_TYPE_KEY_POSITION_EVENT,
+        .data = {.key_position_event =
+                     {
+                         .position = ev[0],
+                         .pressed = ev[1],
+                         .timestamp = (uint32_t)(scanned_at + DT_INST_PROP(0, clock_offset_ms)),
+                     }},
+    };
+
+    LOG_DBG("Delivering position %d pressed %d scanned at %lld", ev[0], ev[1], scanned_at);
+
+    event_index += MOCK_EVENT_TUPLE_LEN;
+    zmk_split_transport_central_peripheral_event_handler(&mock_central, 0, event);
+
+    schedule_next_event();
+}
+
+static int split_central_mock_init(void) {
+    scanned_at = k_uptime_get() + DT_INST_PROP(0, event_startup_delay);
+    schedule_next_event();
+
+    return 0;
+}
+
+SYS_INIT(split_central_mock_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
@@ -0,0 +1,595 @@
+/*
+ * Copyright (c) 2025 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#define DT_DRV_COMPAT zmk_split_mock_loopback
+
+#include <zephyr/types.h>
+#include <zephyr/init.h>
+#include <zephyr/kernel.h>
+#include <zephyr/spinlock.h>
+#include <zephyr/drivers/kscan.h>
+#include <zephyr/drivers/sensor.h>
+
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <zmk/event_manager.h>
+#include <zmk/events/keycode_state_changed.h>
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_ROLE_CENTRAL)
+#include <zmk/split/transport/central.h>
+#include <zmk/split/transport/command_queue.h>
+#else
+#include <zmk/split/transport/peripheral.h>
+#endif
+
+#if IS_ENABLED(CONFIG_ZMK_INPUT_SPLIT)
+#include <zephyr/input/input.h>
+#endif
+
+#define LOOPBACK_DELAY_MS DT_INST_PROP(0, delay_ms)
+#define LOOPBACK_JITTER_MS DT_INST_PROP(0, jitter_ms)
+#define LOOPBACK_DROP_PERMILLE DT_INST_PROP(0, drop_permille)
+#define LOOPBACK_DROP_RETRY_MS DT_INST_PROP(0, drop_retry_ms)
+
+BUILD_ASSERT(DT_INST_PROP(0, seed) != 0, "The loopback seed must be non-zero");
+
+struct loopback_item {
+    struct zmk_split_transport_peripheral_event event;
+    int64_t sent_at;
+    int64_t deliver_at;
+};
+
+static struct loopback_item link_items[CONFIG_ZMK_SPLIT_MOCK_LOOPBACK_QUEUE_SIZE];
+static size_t link_head;
+static size_t link_count;
+static int64_t last_deliver_at;
+static uint32_t rng_state = DT_INST_PROP(0, seed);
+static struct k_spinlock link_lock;
+
+// Delivered events count as frames, drops as bad frames and a full queue as overflows.
+static struct zmk_split_transport_link_stats link_stats;
+
+static bool is_enabled;
+
+// xorshift32, seeded from devicetree so runs are repeatable.
+static uint32_t next_random(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+
+    return rng_state;
+}
+
+static void deliver(const struct loopback_item *item);
+
+static void deliver_work_cb(struct k_work *work);
+
+static K_WORK_DELAYABLE_DEFINE(deliver_work, deliver_work_cb);
+
+static int link_send(const struct zmk_split_transport_peripheral_event *event) {
+    int64_t now = k_uptime_get();
+    k_spinlock_key_t key = k_spin_lock(&link_lock);
+
+    // Both numbers are drawn for every event, so a given seed always gives the same sequence.
+    uint32_t jitter = next_random() % (LOOPBACK_JITTER_MS + 1);
+    bool dropped = next_random() % 1000 < LOOPBACK_DROP_PERMILLE;
+
+    if (dropped) {
+        link_stats.rx_bad_frames++;
+
+        if (LOOPBACK_DROP_RETRY_MS == 0) {
+            k_spin_unlock(&link_lock, key);
+            LOG_DBG("Dropped event type %d", event->type);
+            return 0;
+        }
+    }
+
+    if (link_count == ARRAY_SIZE(link_items)) {
+        link_stats.rx_overflows++;
+        k_spin_unlock(&link_lock, key);
+        LOG_WRN("Loopback link full, dropping event type %d", event->type);
+        return -ENOSPC;
+    }
+
+    // Like a real link, a late event holds back the ones sent after it.
+    int64_t deliver_at = now + LOOPBACK_DELAY_MS + jitter;
+    if (dropped) {
+        deliver_at += LOOPBACK_DROP_RETRY_MS;
+    }
+    deliver_at = MAX(deliver_at, last_deliver_at);
+    last_deliver_at = deliver_at;
+
+    link_items[(link_head + link_count) % ARRAY_SIZE(link_items)] = (struct loopback_item){
+        .event = *event,
+        .sent_at = now,
+        .deliver_at = deliver_at,
+    };
+    bool first = ++link_count == 1;
+
+    k_spin_unlock(&link_lock, key);
+
+    if (first) {
+        k_work_schedule(&deliver_work, K_TIMEOUT_ABS_MS(deliver_at));
+    }
+
+    return 0;
+}
+
+static void deliver_work_cb(struct k_work *work) {
+    int64_t now = k_uptime_get();
+
+    while (true) {
+        k_spinlock_key_t key = k_spin_lock(&link_lock);
+
+        if (link_count == 0) {
+            k_spin_unlock(&link_lock, key);
+            return;
+        }
+
+        struct loopback_item item = link_items[link_head];
+
+        if (item.deliver_at > now) {
+            k_spin_unlock(&link_lock, key);
+            k_work_schedule(&deliver_work, K_TIMEOUT_ABS_MS(item.deliver_at));
+            return;
+        }
+
+        link_head = (link_head + 1) % ARRAY_SIZE(link_items);
+        link_count--;
+        link_stats.rx_frames++;
+
+        k_spin_unlock(&link_lock, key);
+
+        deliver(&item);
+    }
+}
+
+static struct zmk_split_transport_status get_status(void) {
+    struct zmk_split_transport_status status = {
+        .available = true,
+        .enabled = is_enabled,
+        .connections = ZMK_SPLIT_TRANSPORT_CONNECTIONS_STATUS_ALL_CONNECTED,
+    };
+
+    k_spinlock_key_t key = k_spin_lock(&link_lock);
+    status.link = link_stats;
+    k_spin_unlock(&link_lock, key);
+
+    return status;
+}
+
+static int set_enabled(bool enabled) {
+    is_enabled = enabled;
+
+    return 0;
+}
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_MOCK_LOOPBACK_LATENCY)
+
+enum loopback_kind {
+    LOOPBACK_KIND_KEY,
+    LOOPBACK_KIND_SENSOR,
+    LOOPBACK_KIND_INPUT,
+    LOOPBACK_KIND_COUNT,
+};
+
+static const char *const kind_names[LOOPBACK_KIND_COUNT] = {"key", "sensor", "input"};
+
+struct latency_stats {
+    uint32_t count;
+    int64_t total;
+    int64_t min;
+    int64_t max;
+};
+
+static struct latency_stats latency_stats[LOOPBACK_KIND_COUNT];
+
+static void report_latency(enum loopback_kind kind, int64_t since) {
+    struct latency_stats *stats = &latency_stats[kind];
+    int64_t latency = k_uptime_get() - since;
+
+    stats->min = stats->count == 0 ? latency : MIN(stats->min, latency);
+    stats->max = MAX(stats->max, latency);
+    stats->total += latency;
+    stats->count++;
+
+    LOG_DBG("%s %lld ms (min %lld avg %lld max %lld over %u)", kind_names[kind], latency,
+            stats->min, stats->total / stats->count, stats->max, stats->count);
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_MOCK_LOOPBACK_LATENCY)
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_ROLE_CENTRAL)
+
+static zmk_split_transport_central_status_changed_cb_t transport_status_cb;
+
+ZMK_SPLIT_COMMAND_QUEUE_DEFINE(loopback_cmd_queue, 1,
+                               CONFIG_ZMK_SPLIT_MOCK_LOOPBACK_COMMAND_QUEUE_SIZE);
+
+static void log_command_stats(void) {
+    struct zmk_split_command_queue_stats stats;
+
+    zmk_split_command_queue_get_stats(&loopback_cmd_queue, &stats);
+
+    const struct zmk_split_command_lane_stats *critical =
+        &stats.lanes[ZMK_SPLIT_COMMAND_LANE_CRITICAL];
+
+    LOG_DBG("critical queued %u sent %u dropped %u rejected %u max depth %u", critical->queued,
+            critical->sent, critical->dropped, critical->rejected, stats.critical_max_depth);
+}
+
+static void send_commands_work_cb(struct k_work *work);
+
+static K_WORK_DELAYABLE_DEFINE(send_commands_work, send_commands_work_cb);
+
+// One command crosses the link every delay-ms, so bursts back up in the queue.
+static void send_commands_work_cb(struct k_work *work) {
+    struct zmk_split_command_queue_item item;
+    enum zmk_split_command_lane lane;
+
+    if (zmk_split_command_queue_peek(&loopback_cmd_queue, &item, &lane) < 0) {
+        return;
+    }
+
+    zmk_split_command_queue_consume(&loopback_cmd_queue, &item, lane, true);
+
+    // The stand-in peripheral has no behaviors of its own to run.
+    if (item.cmd.type == ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_INVOKE_BEHAVIOR) {
+        LOG_DBG("%s at %d pressed %d", item.cmd.data.invoke_behavior.behavior_dev,
+                item.cmd.data.invoke_behavior.position, item.cmd.data.invoke_behavior.state);
+    } else {
+        LOG_DBG("Command type %d for source %d", item.cmd.type, item.source);
+    }
+
+    log_command_stats();
+
+    k_work_schedule(&send_commands_work, K_MSEC(LOOPBACK_DELAY_MS));
+}
+
+static int split_central_loopback_send_command(uint8_t source,
+                                               struct zmk_split_transport_central_command cmd) {
+    int err = zmk_split_command_queue_put(&loopback_cmd_queue, source, &cmd);
+
+    log_command_stats();
+
+    if (err < 0) {
+        return err;
+    }
+
+    k_work_schedule(&send_commands_work, K_MSEC(LOOPBACK_DELAY_MS));
+
+    return 0;
+}
+
+static int
+split_central_loopback_get_command_queue_stats(struct zmk_split_command_queue_stats *stats) {
+    zmk_split_command_queue_get_stats(&loopback_cmd_queue, stats);
+
+    return 0;
+}
+
+static int split_central_loopback_get_available_source_ids(uint8_t *sources) {
+    sources[0] = 0;
+
+    return 1;
+}
+
+static int
+split_central_loopback_set_status_callback(zmk_split_transport_central_status_changed_cb_t cb) {
+    transport_status_cb = cb;
+
+    return 0;
+}
+
+static const struct zmk_split_transport_central_api central_api = {
+    .send_command = split_central_loopback_send_command,
+    .get_command_queue_stats = split_central_loopback_get_command_queue_stats,
+    .get_available_source_ids = split_central_loopback_get_available_source_ids,
+    .set_enabled = set_enabled,
+    .get_status = get_status,
+    .set_status_callback = split_central_loopback_set_status_callback,
+};
+
+ZMK_SPLIT_TRANSPORT_CENTRAL_REGISTER(loopback_central, &central_api,
+                                     CONFIG_ZMK_SPLIT_MOCK_PRIORITY);
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_MOCK_LOOPBACK_LATENCY)
+
+struct in_flight {
+    enum loopback_kind kind;
+    int64_t sent_at;
+};
+
+// Delivered events waiting to reach the keycode and input listeners, in delivery order.
+K_MSGQ_DEFINE(loopback_keycode_in_flight, sizeof(struct in_flight),
+              CONFIG_ZMK_SPLIT_MOCK_LOOPBACK_QUEUE_SIZE, 8);
+
+#if IS_ENABLED(CONFIG_ZMK_INPUT_SPLIT)
+
+K_MSGQ_DEFINE(loopback_input_in_flight, sizeof(struct in_flight),
+              CONFIG_ZMK_SPLIT_MOCK_LOOPBACK_QUEUE_SIZE, 8);
+
+static void loopback_input_cb(struct input_event *evt) {
+    struct in_flight entry;
+
+    if (k_msgq_get(&loopback_input_in_flight, &entry, K_NO_WAIT) == 0) {
+        report_latency(entry.kind, entry.sent_at);
+    }
+}
+
+INPUT_CALLBACK_DEFINE(NULL, loopback_input_cb);
+
+#endif // IS_ENABLED(CONFIG_ZMK_INPUT_SPLIT)
+
+static void track_delivery(const struct loopback_item *item) {
+    struct in_flight entry = {.sent_at = item->sent_at};
+    struct k_msgq *msgq = &loopback_keycode_in_flight;
+
+    switch (item->event.type) {
+    case ZMK_SPLIT_TRANSPORT_PERIPHERAL_EVENT_TYPE_KEY_POSITION_EVENT:
+        entry.kind = LOOPBACK_KIND_KEY;
+        break;
+    case ZMK_SPLIT_TRANSPORT_PERIPHERAL_EVENT_TYPE_SENSOR_EVENT:
+        entry.kind = LOOPBACK_KIND_SENSOR;
+        break;
+#if IS_ENABLED(CONFIG_ZMK_INPUT_SPLIT)
+    case ZMK_SPLIT_TRANSPORT_PERIPHERAL_EVENT_TYPE_INPUT_EVENT:
+        entry.kind = LOOPBACK_KIND_INPUT;
+        msgq = &loopback_input_in_flight;
+        break;
+#endif // IS_ENABLED(CONFIG_ZMK_INPUT_SPLIT)
+    default:
+        return;
+    }
+
+    if (k_msgq_put(msgq, &entry, K_NO_WAIT) < 0) {
+        LOG_WRN("Too many loopback events in flight to track their latency");
+    }
+}
+
+static int loopback_keycode_listener(const zmk_event_t *eh) {
+    const struct zmk_keycode_state_changed *ev = as_zmk_keycode_state_changed(eh);
+    struct in_flight entry;
+
+    if (ev == NULL || k_msgq_peek(&loopback_keycode_in_flight, &entry) < 0) {
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    // Sensor bindings tap their keycode, only the press is matched to the sensor event.
+    if (entry.kind == LOOPBACK_KIND_SENSOR && !ev->state) {
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    k_msgq_get(&loopback_keycode_in_flight, &entry, K_NO_WAIT);
+    report_latency(entry.kind, entry.sent_at);
+
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(split_mock_loopback, loopback_keycode_listener);
+ZMK_SUBSCRIPTION(split_mock_loopback, zmk_keycode_state_changed);
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_MOCK_LOOPBACK_LATENCY)
+
+static void deliver(const struct loopback_item *item) {
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_MOCK_LOOPBACK_LATENCY)
+    track_delivery(item);
+#endif
+
+    zmk_split_transport_central_peripheral_event_queue(&loopback_central, 0, item->event);
+}
+
+#if DT_INST_NODE_HAS_PROP(0, kscan)
+
+#define LOOPBACK_KSCAN_NODE DT_INST_PHANDLE(0, kscan)
+
+BUILD_ASSERT(DT_NODE_HAS_PROP(LOOPBACK_KSCAN_NODE, columns),
+             "The loopback kscan device needs a columns property to map key positions");
+
+static const struct device *loopback_kscan = DEVICE_DT_GET(LOOPBACK_KSCAN_NODE);
+
+static void loopback_kscan_cb(const struct device *dev, uint32_t row, uint32_t column,
+                              bool pressed) {
+    struct zmk_split_transport_peripheral_event event = {
+        .type = ZMK_SPLIT_TRANSPORT_PERIPHERAL_EVENT_TYPE_KEY_POSITION_EVENT,
+        .data = {.key_position_event =
+                     {
+                         .position = DT_INST_PROP(0, position_offset) +
+                                     row * DT_PROP(LOOPBACK_KSCAN_NODE, columns) + column,
+                         .pressed = pressed,
+                         .timestamp = (uint32_t)k_uptime_get(),
+                     }},
+    };
+
+    link_send(&event);
+}
+
+#endif // DT_INST_NODE_HAS_PROP(0, kscan)
+
+#if DT_INST_NODE_HAS_PROP(0, sensor_events) || DT_INST_NODE_HAS_PROP(0, input_events)
+
+struct loopback_script {
+    const uint32_t *tuples;
+    size_t len;
+    size_t tuple_len;
+    void (*send)(const uint32_t *tuple);
+    size_t index;
+    int64_t sent_at;
+    struct k_work_delayable work;
+};
+
+static void script_schedule_next(struct loopback_script *script) {
+    if (script->index >= script->len) {
+        return;
+    }
+
+    // The wait is always the last value of a tuple.
+    script->sent_at += script->tuples[script->index + script->tuple_len - 1];
+    k_work_schedule(&script->work, K_TIMEOUT_ABS_MS(script->sent_at));
+}
+
+static void script_work_cb(struct k_work *work) {
+    struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+    struct loopback_script *script = CONTAINER_OF(dwork, struct loopback_script, work);
+    const uint32_t *tuple = &script->tuples[script->index];
+
+    script->index += script->tuple_len;
+    script->send(tuple);
+
+    script_schedule_next(script);
+}
+
+static void script_start(struct loopback_script *script) {
+    k_work_init_delayable(&script->work, script_work_cb);
+    script->sent_at = k_uptime_get() + DT_INST_PROP(0, event_startup_delay);
+    script_schedule_next(script);
+}
+
+#endif
+
+#if DT_INST_NODE_HAS_PROP(0, sensor_events)
+
+#define SENSOR_TUPLE_LEN 3
+
+static const uint32_t sensor_tuples[] = DT_INST_PROP(0, sensor_events);
+
+BUILD_ASSERT(ARRAY_SIZE(sensor_tuples) % SENSOR_TUPLE_LEN == 0,
+             "Loopback sensor events must be (sensor-index, degrees, wait-ms) tuples");
+
+static void send_sensor(const uint32_t *tuple) {
+    struct zmk_split_transport_peripheral_event event = {
+        .type = ZMK_SPLIT_TRANSPORT_PERIPHERAL_EVENT_TYPE_SENSOR_EVENT,
+        .data = {.sensor_event =
+                     {
+                         .channel_data = {.channel = SENSOR_CHAN_ROTATION,
+                                          .value = {.val1 = (int32_t)tuple[1]}},
+                         .sensor_index = tuple[0],
+                     }},
+    };
+
+    link_send(&event);
+}
+
+static struct loopback_script sensor_script = {
+    .tuples = sensor_tuples,
+    .len = ARRAY_SIZE(sensor_tuples),
+    .tuple_len = SENSOR_TUPLE_LEN,
+    .send = send_sensor,
+};
+
+#endif // DT_INST_NODE_HAS_PROP(0, sensor_events)
+
+#if DT_INST_NODE_HAS_PROP(0, input_events)
+
+#define INPUT_TUPLE_LEN 5
+
+static const uint32_t input_tuples[] = DT_INST_PROP(0, input_events);
+
+BUILD_ASSERT(ARRAY_SIZE(input_tuples) % INPUT_TUPLE_LEN == 0,
+             "Loopback input events must be (reg, type, code, value, wait-ms) tuples");
+
+static void send_input(const uint32_t *tuple) {
+    struct zmk_split_transport_peripheral_event event = {
+        .type = ZMK_SPLIT_TRANSPORT_PERIPHERAL_EVENT_TYPE_INPUT_EVENT,
+        .data = {.input_event =
+                     {
+                         .reg = tuple[0],
+                         .type = tuple[1],
+                         .code = tuple[2],
+                         .value = (int32_t)tuple[3],
+                         .sync = 1,
+                     }},
+    };
+
+    link_send(&event);
+}
+
+static struct loopback_script input_script = {
+    .tuples = input_tuples,
+    .len = ARRAY_SIZE(input_tuples),
+    .tuple_len = INPUT_TUPLE_LEN,
+    .send = send_input,
+};
+
+#endif // DT_INST_NODE_HAS_PROP(0, input_events)
+
+static int split_central_loopback_init(void) {
+#if DT_INST_NODE_HAS_PROP(0, kscan)
+    if (!device_is_ready(loopback_kscan)) {
+        LOG_ERR("Loopback kscan device is not ready");
+        return -ENODEV;
+    }
+
+    kscan_config(loopback_kscan, loopback_kscan_cb);
+    kscan_enable_callback(loopback_kscan);
+#endif // DT_INST_NODE_HAS_PROP(0, kscan)
+
+#if DT_INST_NODE_HAS_PROP(0, sensor_events)
+    script_start(&sensor_script);
+#endif
+
+#if DT_INST_NODE_HAS_PROP(0, input_events)
+    script_start(&input_script);
+#endif
+
+    return 0;
+}
+
+SYS_INIT(split_central_loopback_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
+
+#else
+
+static zmk_split_transport_peripheral_status_changed_cb_t transport_status_cb;
+
+static int
+split_peripheral_loopback_report_event(const struct zmk_split_transport_peripheral_event *event) {
+    return link_send(event);
+}
+
+static int split_peripheral_loopback_set_status_callback(
+    zmk_split_transport_peripheral_status_changed_cb_t cb) {
+    transport_status_cb = cb;
+
+    return 0;
+}
+
+static const struct zmk_split_transport_peripheral_api peripheral_api = {
+    .report_event = split_peripheral_loopback_report_event,
+    .set_enabled = set_enabled,
+    .get_status = get_status,
+    .set_status_callback = split_peripheral_loopback_set_status_callback,
+};
+
+ZMK_SPLIT_TRANSPORT_PERIPHERAL_REGISTER(loopback_peripheral, &peripheral_api,
+                                        CONFIG_ZMK_SPLIT_MOCK_PRIORITY);
+
+// The stand-in central only logs what reaches it.
+static void deliver(const struct loopback_item *item) {
+    LOG_DBG("Central received event type %d", item->event.type);
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_MOCK_LOOPBACK_LATENCY)
+    switch (item->event.type) {
+    case ZMK_SPLIT_TRANSPORT_PERIPHERAL_EVENT_TYPE_KEY_POSITION_EVENT:
+        // Peripheral uptime when the key was scanned, on the same clock here
+        report_latency(LOOPBACK_KIND_KEY, item->event.data.key_position_event.timestamp > 0
+                                              ? item->event.data.key_position_event.timestamp
+                                              : item->sent_at);
+        break;
+    case ZMK_SPLIT_TRANSPORT_PERIPHERAL_EVENT_TYPE_SENSOR_EVENT:
+        report_latency(LOOPBACK_KIND_SENSOR, item->sent_at);
+        break;
+    case ZMK_SPLIT_TRANSPORT_PERIPHERAL_EVENT_TYPE_INPUT_EVENT:
+        report_latency(LOOPBACK_KIND_INPUT, item->sent_at);
+        break;
+    default:
+        break;
+    }
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_MOCK_LOOPBACK_LATENCY)
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_ROLE_CENTRAL)
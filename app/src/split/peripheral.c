@@ -31,10 +31,13 @@ int zmk_split_transport_peripheral_command_handler(
 
     switch (cmd.type) {
     case ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_INVOKE_BEHAVIOR: {
+        // A transport that identified the behavior itself passes its device, whose name may not
+        // fit in behavior_dev.
         struct zmk_behavior_binding binding = {
             .param1 = cmd.data.invoke_behavior.param1,
             .param2 = cmd.data.invoke_behavior.param2,
-            .behavior_dev = cmd.data.invoke_behavior.behavior_dev,
+            .behavior_dev =
+                cmd.behavior ? cmd.behavior->name : cmd.data.invoke_behavior.behavior_dev,
         };
         LOG_DBG("%s with params %d %d: pressed? %d", binding.behavior_dev, binding.param1,
                 binding.param2, cmd.data.invoke_behavior.state);
@@ -50,6 +53,8 @@ int zmk_split_transport_peripheral_command_handler(
         if (err) {
             LOG_ERR("Failed to invoke behavior %s: %d", binding.behavior_dev, err);
         }
+
+        return err;
     }
     default:
         LOG_WRN("Unhandled command type %d", cmd.type);
@@ -67,6 +72,25 @@ int zmk_split_peripheral_report_event(const struct zmk_split_transport_periphera
     return active_transport->api->report_event(event);
 }
 
+int zmk_split_peripheral_get_transport_status(struct zmk_split_transport_status *status) {
+    if (!active_transport || !active_transport->api) {
+        return -ENODEV;
+    }
+
+    if (!active_transport->api->get_status) {
+        *status = (struct zmk_split_transport_status){
+            .available = true,
+            .enabled = true,
+            .connections = ZMK_SPLIT_TRANSPORT_CONNECTIONS_STATUS_ALL_CONNECTED,
+        };
+        return 0;
+    }
+
+    *status = active_transport->api->get_status();
+
+    return 0;
+}
+
 static int select_first_available_transport(void) {
     // Transports are sorted by priority, so find the first
     // One that's available, and enable it. Any transport that
@@ -139,6 +163,8 @@ int split_peripheral_listener(const zmk_event_t *eh) {
             .data = {.key_position_event = {
                          .position = pos_ev->position,
                          .pressed = pos_ev->state,
+                         // 0 means "unknown" to the central
+                         .timestamp = MAX((uint32_t)pos_ev->timestamp, 1),
                      }}};
 
         zmk_split_peripheral_report_event(&ev);
@@ -68,6 +68,10 @@ static const struct gpio_dt_spec dir_gpio = GPIO_DT_SPEC_INST_GET(0, dir_gpios);
 
 #define HAS_DETECT_GPIO DT_INST_NODE_HAS_PROP(0, detect_gpios)
 
+#define HAS_LINK_SPEED_NEGOTIATION                                                                 \
+    (IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_LINK_SPEED_NEGOTIATION) && !IS_HALF_DUPLEX_MODE &&         \
+     DT_INST_NODE_HAS_PROP(0, link_speeds))
+
 #if HAS_DETECT_GPIO
 
 static const struct gpio_dt_spec detect_gpio = GPIO_DT_SPEC_INST_GET(0, detect_gpios);
@@ -119,12 +123,10 @@ static void send_pending_tx_work_cb(struct k_work *work);
 
 static K_WORK_DEFINE(wired_central_tx_work, send_pending_tx_work_cb);
 
-static void read_timer_cb(struct k_timer *_timer) {
-    zmk_split_wired_poll_in(&rx_buf, uart, &publish_events, NULL);
-    // Check if we found any bytes, read some, or read all the bytes in the RX
-}
-
-static K_TIMER_DEFINE(wired_central_read_timer, read_timer_cb, NULL);
+static struct zmk_split_wired_poll_state poll_state = {
+    .rx_buf = &rx_buf,
+    .process_data_work = &publish_events,
+};
 
 #endif
 
@@ -150,11 +152,36 @@ static void begin_rx(void) {
 #elif IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_UART_MODE_ASYNC)
     zmk_split_wired_async_rx(&async_state);
 #else
-    k_timer_start(&wired_central_read_timer, K_TICKS(CONFIG_ZMK_SPLIT_WIRED_POLLING_RX_PERIOD),
-                  K_TICKS(CONFIG_ZMK_SPLIT_WIRED_POLLING_RX_PERIOD));
+    zmk_split_wired_poll_start(&poll_state);
 #endif
 }
 
+#if HAS_LINK_SPEED_NEGOTIATION
+
+static const uint32_t link_speeds[] = DT_INST_PROP(0, link_speeds);
+
+// Link control frames are written from the system work queue, like commands.
+static int send_link_control(const struct link_envelope *env) {
+    int err = zmk_split_wired_link_put(env, &tx_buf);
+    if (err < 0) {
+        return err;
+    }
+
+    begin_tx();
+
+    return 0;
+}
+
+static struct zmk_split_wired_link_speed_state link_speed = {
+    .tx_buf = &tx_buf,
+    .send = send_link_control,
+    .speeds = link_speeds,
+    .speeds_len = ARRAY_SIZE(link_speeds),
+    .initiator = true,
+};
+
+#endif // HAS_LINK_SPEED_NEGOTIATION
+
 #if HAS_DETECT_GPIO
 
 static void stop_rx(void) {
@@ -163,7 +190,7 @@ static void stop_rx(void) {
 #elif IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_UART_MODE_ASYNC)
     zmk_split_wired_async_rx_cancel(&async_state);
 #else
-    k_timer_stop(&wired_central_read_timer);
+    zmk_split_wired_poll_stop(&poll_state);
 #endif
 
 #if IS_ENABLED(CONFIG_PM_DEVICE_RUNTIME)
@@ -190,13 +217,30 @@ static ssize_t get_payload_data_size(const struct zmk_split_transport_central_co
     }
 }
 
-static int split_central_wired_send_command(uint8_t source,
-                                            struct zmk_split_transport_central_command cmd) {
-    if (source != 0) {
-        return -EINVAL;
+ZMK_SPLIT_COMMAND_QUEUE_DEFINE(wired_cmd_queue, 1, CONFIG_ZMK_SPLIT_WIRED_CMD_BUFFER_ITEMS);
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_MULTI_RECORD_FRAMES)
+
+#define CMD_FRAME_PAYLOAD_MAX                                                                      \
+    MSG_MULTI_PAYLOAD_SIZE(sizeof(struct command_payload), CONFIG_ZMK_SPLIT_WIRED_CMD_BUFFER_ITEMS)
+
+// Commands written since the last flush. Only touched from the system work queue.
+static struct multi_envelope cmd_frame = {
+    .prefix = {.magic_prefix = ZMK_SPLIT_WIRED_MULTI_ENVELOPE_MAGIC_PREFIX},
+};
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_MULTI_RECORD_FRAMES)
+
+static void flush_commands(void) {
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_MULTI_RECORD_FRAMES)
+    if (zmk_split_wired_multi_put(&cmd_frame, &tx_buf) < 0) {
+        LOG_DBG("No room to flush commands to the peripheral");
     }
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_MULTI_RECORD_FRAMES)
+}
 
-    ssize_t data_size = get_payload_data_size(&cmd);
+static int write_command(uint8_t source, const struct zmk_split_transport_central_command *cmd) {
+    ssize_t data_size = get_payload_data_size(cmd);
     if (data_size < 0) {
         LOG_WRN("Failed to determine payload data size %d", data_size);
         return data_size;
@@ -206,8 +250,26 @@ static int split_central_wired_send_command(uint8_t source,
     size_t payload_size =
         data_size + sizeof(source) + sizeof(enum zmk_split_transport_central_command_type);
 
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_MULTI_RECORD_FRAMES)
+    size_t record_size = sizeof(struct msg_record_prefix) + payload_size;
+
+    if (cmd_frame.prefix.payload_size + record_size > CMD_FRAME_PAYLOAD_MAX) {
+        flush_commands();
+    }
+
+    // The whole frame is written at once, so leave room for what's already in it.
+    if (ring_buf_space_get(&tx_buf) <
+        MSG_EXTRA_SIZE + cmd_frame.prefix.payload_size + record_size) {
+        LOG_DBG("No room to send command to the peripheral %d", source);
+        return -ENOSPC;
+    }
+
+    struct command_payload payload = {.source = source, .cmd = *cmd};
+
+    return zmk_split_wired_multi_append(&cmd_frame, CMD_FRAME_PAYLOAD_MAX, &payload, payload_size);
+#else
     if (ring_buf_space_get(&tx_buf) < MSG_EXTRA_SIZE + payload_size) {
-        LOG_WRN("No room to send command to the peripheral %d", source);
+        LOG_DBG("No room to send command to the peripheral %d", source);
         return -ENOSPC;
     }
 
@@ -218,7 +280,7 @@ static int split_central_wired_send_command(uint8_t source,
                                        },
                                    .payload = {
                                        .source = source,
-                                       .cmd = cmd,
+                                       .cmd = *cmd,
                                    }};
 
     struct msg_postfix postfix = {.crc =
@@ -227,9 +289,69 @@ static int split_central_wired_send_command(uint8_t source,
     ring_buf_put(&tx_buf, (uint8_t *)&env, sizeof(env.prefix) + payload_size);
     ring_buf_put(&tx_buf, (uint8_t *)&postfix, sizeof(postfix));
 
-    if (can_tx() >= 0) {
+    return 0;
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_MULTI_RECORD_FRAMES)
+}
+
+static void drain_commands_work_cb(struct k_work *work);
+
+static K_WORK_DELAYABLE_DEFINE(drain_commands_work, drain_commands_work_cb);
+
+static void drain_commands(bool wrote) {
+    struct zmk_split_command_queue_item item;
+    enum zmk_split_command_lane lane;
+
+    while (zmk_split_command_queue_peek(&wired_cmd_queue, &item, &lane) == 0) {
+        int err = write_command(item.source, &item.cmd);
+
+        // Critical and state commands wait for the TX buffer to drain, telemetry is dropped.
+        if (err == -ENOSPC && lane != ZMK_SPLIT_COMMAND_LANE_TELEMETRY) {
+            k_work_schedule(&drain_commands_work, K_MSEC(1));
+            break;
+        }
+
+        zmk_split_command_queue_consume(&wired_cmd_queue, &item, lane, err == 0);
+        wrote |= err == 0;
+    }
+
+    flush_commands();
+
+    if (wrote && can_tx() >= 0) {
         begin_tx();
     }
+}
+
+static void drain_commands_work_cb(struct k_work *work) { drain_commands(false); }
+
+static int split_central_wired_send_command(uint8_t source,
+                                            struct zmk_split_transport_central_command cmd) {
+    if (source != 0) {
+        return -EINVAL;
+    }
+
+    ssize_t data_size = get_payload_data_size(&cmd);
+    if (data_size < 0) {
+        LOG_WRN("Failed to determine payload data size %d", data_size);
+        return data_size;
+    }
+
+    int err = zmk_split_command_queue_put(&wired_cmd_queue, source, &cmd);
+    if (err < 0) {
+        return err;
+    }
+
+    k_work_schedule(&drain_commands_work, K_NO_WAIT);
+
+    return 0;
+}
+
+static int
+split_central_wired_get_command_queue_stats(struct zmk_split_command_queue_stats *stats) {
+    if (!stats) {
+        return -EINVAL;
+    }
+
+    zmk_split_command_queue_get_stats(&wired_cmd_queue, stats);
 
     return 0;
 }
@@ -243,11 +365,11 @@ static K_WORK_DELAYABLE_DEFINE(rx_done_work, rx_done_cb);
 void rx_done_cb(struct k_work *work) {
     k_sem_give(&tx_sem);
 
-    // Poll for the next event data!
-    split_central_wired_send_command(0,
-                                     (struct zmk_split_transport_central_command){
-                                         .type = ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_POLL_EVENTS,
-                                     });
+    // Poll for the next event data! Queued commands go out in the same transmission.
+    int err = write_command(0, &(struct zmk_split_transport_central_command){
+                                   .type = ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_POLL_EVENTS,
+                               });
+    drain_commands(err == 0);
 
     k_work_reschedule(&rx_done_work, K_MSEC(CONFIG_ZMK_SPLIT_WIRED_HALF_DUPLEX_RX_TIMEOUT));
 }
@@ -348,8 +470,18 @@ static int zmk_split_wired_central_init(void) {
         return ret;
     }
 
+#elif IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_UART_MODE_POLLING)
+
+    poll_state.uart = uart;
+    zmk_split_wired_poll_init(&poll_state);
+
 #endif // IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_UART_MODE_*)
 
+#if HAS_LINK_SPEED_NEGOTIATION
+    link_speed.uart = uart;
+    zmk_split_wired_link_speed_init(&link_speed);
+#endif // HAS_LINK_SPEED_NEGOTIATION
+
 #if IS_HALF_DUPLEX_MODE
 
 #if HAS_DIR_GPIO
@@ -393,12 +525,18 @@ static int split_central_wired_set_enabled(bool enabled) {
         begin_rx();
 #if IS_HALF_DUPLEX_MODE
         k_work_schedule(&rx_done_work, K_MSEC(CONFIG_ZMK_SPLIT_WIRED_HALF_DUPLEX_RX_TIMEOUT));
+#endif
+#if HAS_LINK_SPEED_NEGOTIATION
+        zmk_split_wired_link_speed_start(&link_speed);
 #endif
         return 0;
 #if HAS_DETECT_GPIO
     } else {
 #if IS_HALF_DUPLEX_MODE
         k_work_cancel_delayable(&rx_done_work);
+#endif
+#if HAS_LINK_SPEED_NEGOTIATION
+        zmk_split_wired_link_speed_stop(&link_speed);
 #endif
         stop_rx();
         return 0;
@@ -418,34 +556,43 @@ split_central_wired_set_status_callback(zmk_split_transport_central_status_chang
     return 0;
 }
 
+#endif // HAS_DETECT_GPIO
+
 static struct zmk_split_transport_status split_central_wired_get_status() {
-    int detected = gpio_pin_get_dt(&detect_gpio);
-    if (detected > 0) {
-        return (struct zmk_split_transport_status){
-            .available = true,
-            .enabled = true, // Track this
-            .connections = ZMK_SPLIT_TRANSPORT_CONNECTIONS_STATUS_ALL_CONNECTED,
-
-        };
-    } else {
-        return (struct zmk_split_transport_status){
-            .available = false,
-            .enabled = true, // Track this
-            .connections = ZMK_SPLIT_TRANSPORT_CONNECTIONS_STATUS_DISCONNECTED,
+    struct zmk_split_transport_status status = {
+        .available = true,
+        .enabled = true, // Track this
+        .connections = ZMK_SPLIT_TRANSPORT_CONNECTIONS_STATUS_ALL_CONNECTED,
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_UART_MODE_POLLING)
+        .rx_poll_period_us = zmk_split_wired_poll_period_us(&poll_state),
+#endif
+        .link = zmk_split_wired_get_link_stats(),
+    };
 
-        };
-    }
-}
+#if HAS_LINK_SPEED_NEGOTIATION
+    zmk_split_wired_link_speed_get_stats(&link_speed, &status.link);
+#else
+    status.link.speed = DT_PROP_OR(DT_INST_PHANDLE(0, device), current_speed, 0);
+#endif
 
+#if HAS_DETECT_GPIO
+    if (gpio_pin_get_dt(&detect_gpio) <= 0) {
+        status.available = false;
+        status.connections = ZMK_SPLIT_TRANSPORT_CONNECTIONS_STATUS_DISCONNECTED;
+    }
 #endif // HAS_DETECT_GPIO
 
+    return status;
+}
+
 static const struct zmk_split_transport_central_api central_api = {
     .send_command = split_central_wired_send_command,
     .get_available_source_ids = split_central_wired_get_available_source_ids,
     .set_enabled = split_central_wired_set_enabled,
+    .get_command_queue_stats = split_central_wired_get_command_queue_stats,
+    .get_status = split_central_wired_get_status,
 #if HAS_DETECT_GPIO
     .set_status_callback = split_central_wired_set_status_callback,
-    .get_status = split_central_wired_get_status,
 #endif // HAS_DETECT_GPIO
 };
 
@@ -469,13 +616,40 @@ static void publish_events_work(struct k_work *work) {
 #endif // IS_HALF_DUPLEX_MODE
 
     while (ring_buf_size_get(&rx_buf) > MSG_EXTRA_SIZE) {
-        struct event_envelope env;
-        int item_err =
-            zmk_split_wired_get_item(&rx_buf, (uint8_t *)&env, sizeof(struct event_envelope));
+        // Only used from the system work queue, and too big for its stack.
+        static union {
+            struct event_envelope single;
+            struct multi_envelope multi;
+            struct link_envelope link;
+            uint8_t frame[sizeof(struct multi_envelope) + sizeof(struct msg_postfix)];
+        } env;
+        int item_err = zmk_split_wired_get_item(&rx_buf, (uint8_t *)&env, sizeof(env));
+#if HAS_LINK_SPEED_NEGOTIATION
+        zmk_split_wired_link_speed_check(&link_speed);
+#endif
         switch (item_err) {
         case 0:
-            zmk_split_transport_central_peripheral_event_handler(&wired_central, env.payload.source,
-                                                                 env.payload.event);
+            if (zmk_split_wired_is_link_envelope(&env.link.prefix)) {
+#if HAS_LINK_SPEED_NEGOTIATION
+                zmk_split_wired_link_speed_handle(&link_speed, &env.link.payload);
+#endif
+            } else if (zmk_split_wired_is_multi_envelope(&env.multi.prefix)) {
+                struct event_payload payload;
+                size_t offset = 0;
+
+                while (zmk_split_wired_multi_next(&env.multi, &offset, &payload,
+                                                  sizeof(payload)) == 0) {
+                    zmk_split_transport_central_peripheral_event_queue(
+                        &wired_central, payload.source, payload.event);
+                }
+            } else {
+                // Fields left off the wire, like key timestamps, must read as zero rather than
+                // as the CRC that follows the payload.
+                size_t len = MIN(env.single.prefix.payload_size, sizeof(env.single.payload));
+                memset((uint8_t *)&env.single.payload + len, 0, sizeof(env.single.payload) - len);
+                zmk_split_transport_central_peripheral_event_queue(
+                    &wired_central, env.single.payload.source, env.single.payload.event);
+            }
             break;
         case -EAGAIN:
             return;
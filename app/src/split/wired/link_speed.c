@@ -0,0 +1,383 @@
+/*
+ * Copyright (c) 2025 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "wired.h"
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/drivers/uart.h>
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+// Alternating, solid and single bit bytes, to catch sampling errors at the new speed.
+static const uint8_t test_pattern[ZMK_SPLIT_WIRED_LINK_TEST_PATTERN_LEN] = {
+    0x55, 0xAA, 0x00, 0xFF, 0x0F, 0xF0, 0x33, 0xCC, 0x01, 0x80, 0xFE, 0x7F, 0x96, 0x69, 0x5A, 0xA5,
+};
+
+// Each retry sends a frame the peer can't decode if it's stuck at another speed, so enough
+// retries make it see an error burst and fall back to the base speed too.
+#define PROPOSE_ATTEMPTS (CONFIG_ZMK_SPLIT_WIRED_LINK_SPEED_ERROR_BURST + 2)
+
+#define STEP_TIMEOUT K_MSEC(CONFIG_ZMK_SPLIT_WIRED_LINK_SPEED_TIMEOUT_MS)
+
+// Time for the last frame sent at `speed` to leave the UART, allowing for 32 bytes of FIFO.
+static uint32_t drain_time_ms(uint32_t speed) { return 1 + (10 * 32 * MSEC_PER_SEC) / speed; }
+
+static uint32_t speed_at(const struct zmk_split_wired_link_speed_state *state, int idx) {
+    return idx < 0 ? state->base_speed : state->speeds[idx];
+}
+
+static int send_op(struct zmk_split_wired_link_speed_state *state, enum zmk_split_wired_link_op op,
+                   uint32_t speed) {
+    struct link_envelope env = {
+        .prefix =
+            {
+                .magic_prefix = ZMK_SPLIT_WIRED_LINK_ENVELOPE_MAGIC_PREFIX,
+                .payload_size = sizeof(struct link_payload),
+            },
+        .payload = {.op = op, .speed = speed},
+    };
+
+    if (op == ZMK_SPLIT_WIRED_LINK_OP_TEST) {
+        memcpy(env.payload.pattern, test_pattern, sizeof(test_pattern));
+    }
+
+    int err = state->send(&env);
+    if (err < 0) {
+        LOG_WRN("Failed to send link control op %d (%d)", op, err);
+    }
+
+    return err;
+}
+
+static int set_speed(struct zmk_split_wired_link_speed_state *state, uint32_t speed) {
+    struct uart_config cfg;
+
+    int err = uart_config_get(state->uart, &cfg);
+    if (err < 0) {
+        return err;
+    }
+
+    cfg.baudrate = speed;
+
+    err = uart_configure(state->uart, &cfg);
+    if (err < 0) {
+        LOG_WRN("Failed to switch the split UART to %d baud (%d)", speed, err);
+        return err;
+    }
+
+    state->speed = speed;
+
+    return 0;
+}
+
+static void begin_switch(struct zmk_split_wired_link_speed_state *state, uint32_t delay_ms) {
+    state->phase = ZMK_SPLIT_WIRED_LINK_PHASE_SWITCHING;
+    state->switch_at = k_uptime_get() + delay_ms;
+    k_work_reschedule(&state->step_work, K_NO_WAIT);
+}
+
+static void propose_next(struct zmk_split_wired_link_speed_state *state) {
+    int next = state->try_idx + 1;
+
+    while (next < state->cap_idx && state->speeds[next] <= state->speed) {
+        next++;
+    }
+
+    if (next >= state->cap_idx) {
+        LOG_INF("Split link running at %d baud", state->speed);
+        state->phase = ZMK_SPLIT_WIRED_LINK_PHASE_DONE;
+        return;
+    }
+
+    state->try_idx = next;
+    state->attempts = 1;
+    state->phase = ZMK_SPLIT_WIRED_LINK_PHASE_PROPOSED;
+
+    send_op(state, ZMK_SPLIT_WIRED_LINK_OP_PROPOSE, state->speeds[next]);
+    k_work_reschedule(&state->step_work, STEP_TIMEOUT);
+}
+
+static void switch_speed(struct zmk_split_wired_link_speed_state *state) {
+    int64_t now = k_uptime_get();
+
+    // Frames still queued at the old speed would be garbled by the switch.
+    if (ring_buf_size_get(state->tx_buf) > 0) {
+        state->switch_at = MAX(state->switch_at, now + drain_time_ms(state->speed));
+        k_work_reschedule(&state->step_work, K_MSEC(1));
+        return;
+    }
+
+    if (now < state->switch_at) {
+        k_work_reschedule(&state->step_work, K_MSEC(state->switch_at - now));
+        return;
+    }
+
+    if (set_speed(state, state->speeds[state->try_idx]) < 0) {
+        // The peer times out of its test and stays at the current speed.
+        if (state->initiator) {
+            state->cap_idx = state->try_idx;
+            propose_next(state);
+        } else {
+            state->phase = ZMK_SPLIT_WIRED_LINK_PHASE_IDLE;
+        }
+        return;
+    }
+
+    state->phase = ZMK_SPLIT_WIRED_LINK_PHASE_TESTING;
+
+    if (state->initiator) {
+        send_op(state, ZMK_SPLIT_WIRED_LINK_OP_TEST, state->speed);
+        k_work_reschedule(&state->step_work, STEP_TIMEOUT);
+    } else {
+        // Leave the central time to switch and get its test pattern across.
+        k_work_reschedule(&state->step_work,
+                          K_MSEC(2 * CONFIG_ZMK_SPLIT_WIRED_LINK_SPEED_TIMEOUT_MS));
+    }
+}
+
+static void step_work_cb(struct k_work *work) {
+    struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+    struct zmk_split_wired_link_speed_state *state =
+        CONTAINER_OF(dwork, struct zmk_split_wired_link_speed_state, step_work);
+
+    switch (state->phase) {
+    case ZMK_SPLIT_WIRED_LINK_PHASE_IDLE:
+        if (state->initiator) {
+            propose_next(state);
+        }
+        break;
+    case ZMK_SPLIT_WIRED_LINK_PHASE_PROPOSED:
+        if (state->attempts++ >= PROPOSE_ATTEMPTS) {
+            LOG_DBG("No answer to link speed proposals, staying at %d baud", state->speed);
+            state->phase = ZMK_SPLIT_WIRED_LINK_PHASE_DONE;
+            break;
+        }
+
+        send_op(state, ZMK_SPLIT_WIRED_LINK_OP_PROPOSE, state->speeds[state->try_idx]);
+        k_work_reschedule(&state->step_work, STEP_TIMEOUT);
+        break;
+    case ZMK_SPLIT_WIRED_LINK_PHASE_SWITCHING:
+        switch_speed(state);
+        break;
+    case ZMK_SPLIT_WIRED_LINK_PHASE_TESTING:
+        LOG_WRN("Split link test at %d baud failed, staying at %d baud", state->speed,
+                speed_at(state, state->speed_idx));
+        set_speed(state, speed_at(state, state->speed_idx));
+
+        if (state->initiator) {
+            state->cap_idx = state->try_idx;
+            propose_next(state);
+        } else {
+            state->phase = ZMK_SPLIT_WIRED_LINK_PHASE_IDLE;
+        }
+        break;
+    case ZMK_SPLIT_WIRED_LINK_PHASE_DONE:
+        break;
+    }
+}
+
+static bool is_test_valid(const struct zmk_split_wired_link_speed_state *state,
+                          const struct link_payload *payload) {
+    return payload->speed == state->speed &&
+           memcmp(payload->pattern, test_pattern, sizeof(test_pattern)) == 0;
+}
+
+static void handle_as_initiator(struct zmk_split_wired_link_speed_state *state,
+                                const struct link_payload *payload) {
+    switch (payload->op) {
+    case ZMK_SPLIT_WIRED_LINK_OP_ACCEPT:
+        if (state->phase == ZMK_SPLIT_WIRED_LINK_PHASE_PROPOSED &&
+            payload->speed == state->speeds[state->try_idx]) {
+            // Switch after the peripheral, which starts once its ACCEPT has been sent.
+            begin_switch(state, 2 * drain_time_ms(state->speed));
+        }
+        break;
+    case ZMK_SPLIT_WIRED_LINK_OP_REJECT:
+        if (state->phase == ZMK_SPLIT_WIRED_LINK_PHASE_PROPOSED &&
+            payload->speed == state->speeds[state->try_idx]) {
+            propose_next(state);
+        }
+        break;
+    case ZMK_SPLIT_WIRED_LINK_OP_TEST:
+        if (state->phase == ZMK_SPLIT_WIRED_LINK_PHASE_TESTING && is_test_valid(state, payload)) {
+            state->speed_idx = state->try_idx;
+            send_op(state, ZMK_SPLIT_WIRED_LINK_OP_CONFIRM, state->speed);
+            propose_next(state);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+static void handle_as_responder(struct zmk_split_wired_link_speed_state *state,
+                                const struct link_payload *payload) {
+    switch (payload->op) {
+    case ZMK_SPLIT_WIRED_LINK_OP_PROPOSE: {
+        if (state->phase != ZMK_SPLIT_WIRED_LINK_PHASE_IDLE) {
+            break;
+        }
+
+        int idx = -1;
+        for (int i = 0; i < state->speeds_len; i++) {
+            if (state->speeds[i] == payload->speed) {
+                idx = i;
+                break;
+            }
+        }
+
+        if (idx < 0) {
+            send_op(state, ZMK_SPLIT_WIRED_LINK_OP_REJECT, payload->speed);
+            break;
+        }
+
+        state->try_idx = idx;
+        if (send_op(state, ZMK_SPLIT_WIRED_LINK_OP_ACCEPT, payload->speed) == 0) {
+            begin_switch(state, drain_time_ms(state->speed));
+        }
+        break;
+    }
+    case ZMK_SPLIT_WIRED_LINK_OP_TEST:
+        if (state->phase == ZMK_SPLIT_WIRED_LINK_PHASE_TESTING && is_test_valid(state, payload)) {
+            k_work_cancel_delayable(&state->step_work);
+            state->speed_idx = state->try_idx;
+            state->phase = ZMK_SPLIT_WIRED_LINK_PHASE_IDLE;
+            send_op(state, ZMK_SPLIT_WIRED_LINK_OP_TEST, state->speed);
+        }
+        break;
+    case ZMK_SPLIT_WIRED_LINK_OP_CONFIRM:
+        LOG_INF("Split link running at %d baud", state->speed);
+        break;
+    default:
+        break;
+    }
+}
+
+static void rx_work_cb(struct k_work *work) {
+    struct zmk_split_wired_link_speed_state *state =
+        CONTAINER_OF(work, struct zmk_split_wired_link_speed_state, rx_work);
+    struct link_payload payload;
+
+    k_spinlock_key_t key = k_spin_lock(&state->lock);
+    bool pending = state->rx_pending;
+    payload = state->rx_payload;
+    state->rx_pending = false;
+    k_spin_unlock(&state->lock, key);
+
+    if (!pending) {
+        return;
+    }
+
+    LOG_DBG("Link control op %d for %d baud", payload.op, payload.speed);
+
+    if (state->initiator) {
+        handle_as_initiator(state, &payload);
+    } else {
+        handle_as_responder(state, &payload);
+    }
+}
+
+static void fallback_work_cb(struct k_work *work) {
+    struct zmk_split_wired_link_speed_state *state =
+        CONTAINER_OF(work, struct zmk_split_wired_link_speed_state, fallback_work);
+
+    if (state->speed == state->base_speed) {
+        return;
+    }
+
+    // Whatever speed we were on or testing is not reliable on this cable.
+    int failed_idx = state->phase == ZMK_SPLIT_WIRED_LINK_PHASE_TESTING ? state->try_idx
+                                                                         : state->speed_idx;
+
+    LOG_WRN("Burst of errors at %d baud, falling back to %d baud", state->speed,
+            state->base_speed);
+
+    set_speed(state, state->base_speed);
+    state->speed_idx = -1;
+    state->try_idx = -1;
+    state->cap_idx = MAX(failed_idx, 0);
+    state->fallbacks++;
+    state->phase = ZMK_SPLIT_WIRED_LINK_PHASE_IDLE;
+
+    if (state->initiator) {
+        k_work_reschedule(&state->step_work, STEP_TIMEOUT);
+    } else {
+        k_work_cancel_delayable(&state->step_work);
+    }
+}
+
+int zmk_split_wired_link_speed_init(struct zmk_split_wired_link_speed_state *state) {
+    struct uart_config cfg;
+
+    k_work_init(&state->rx_work, rx_work_cb);
+    k_work_init(&state->fallback_work, fallback_work_cb);
+    k_work_init_delayable(&state->step_work, step_work_cb);
+
+    int err = uart_config_get(state->uart, &cfg);
+    if (err < 0) {
+        LOG_WRN("Can't read the split UART config, link speed negotiation disabled (%d)", err);
+        state->speeds_len = 0;
+        return err;
+    }
+
+    state->base_speed = cfg.baudrate;
+    state->speed = cfg.baudrate;
+    state->speed_idx = -1;
+    state->try_idx = -1;
+    state->cap_idx = state->speeds_len;
+
+    return 0;
+}
+
+void zmk_split_wired_link_speed_start(struct zmk_split_wired_link_speed_state *state) {
+    zmk_split_wired_link_speed_stop(state);
+
+    if (state->initiator && state->speeds_len > 0) {
+        // Give the peripheral time to come up before the first proposal.
+        k_work_reschedule(&state->step_work, STEP_TIMEOUT);
+    }
+}
+
+void zmk_split_wired_link_speed_stop(struct zmk_split_wired_link_speed_state *state) {
+    k_work_cancel_delayable(&state->step_work);
+
+    if (state->speed != state->base_speed) {
+        set_speed(state, state->base_speed);
+    }
+
+    state->speed_idx = -1;
+    state->try_idx = -1;
+    state->cap_idx = state->speeds_len;
+    state->phase = ZMK_SPLIT_WIRED_LINK_PHASE_IDLE;
+}
+
+void zmk_split_wired_link_speed_handle(struct zmk_split_wired_link_speed_state *state,
+                                       const struct link_payload *payload) {
+    k_spinlock_key_t key = k_spin_lock(&state->lock);
+    if (state->rx_pending) {
+        LOG_WRN("Dropping unprocessed link control op %d", state->rx_payload.op);
+    }
+    state->rx_payload = *payload;
+    state->rx_pending = true;
+    k_spin_unlock(&state->lock, key);
+
+    k_work_submit(&state->rx_work);
+}
+
+void zmk_split_wired_link_speed_check(struct zmk_split_wired_link_speed_state *state) {
+    if (zmk_split_wired_is_error_burst() && state->speed != state->base_speed) {
+        k_work_submit(&state->fallback_work);
+    }
+}
+
+void zmk_split_wired_link_speed_get_stats(struct zmk_split_wired_link_speed_state *state,
+                                          struct zmk_split_transport_link_stats *stats) {
+    stats->speed = state->speed;
+    stats->speed_fallbacks = state->fallbacks;
+}
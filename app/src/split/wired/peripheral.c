@@ -67,6 +67,10 @@ static const struct gpio_dt_spec dir_gpio = GPIO_DT_SPEC_INST_GET(0, dir_gpios);
 
 #define HAS_DETECT_GPIO DT_INST_NODE_HAS_PROP(0, detect_gpios)
 
+#define HAS_LINK_SPEED_NEGOTIATION                                                                 \
+    (IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_LINK_SPEED_NEGOTIATION) && !IS_HALF_DUPLEX_MODE &&         \
+     DT_INST_NODE_HAS_PROP(0, link_speeds))
+
 #if HAS_DETECT_GPIO
 
 static const struct gpio_dt_spec detect_gpio = GPIO_DT_SPEC_INST_GET(0, detect_gpios);
@@ -85,7 +89,8 @@ static void publish_commands_work(struct k_work *work);
 K_WORK_DEFINE(publish_commands, publish_commands_work);
 
 static void process_tx_cb(void);
-K_MSGQ_DEFINE(cmd_msg_queue, sizeof(struct zmk_split_transport_central_command), 3, 4);
+K_MSGQ_DEFINE(cmd_msg_queue, sizeof(struct zmk_split_transport_central_command),
+              CONFIG_ZMK_SPLIT_WIRED_CMD_BUFFER_ITEMS, 4);
 
 #if IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_UART_MODE_ASYNC)
 
@@ -107,14 +112,28 @@ static struct zmk_split_wired_async_state async_state = {
 
 #if IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_UART_MODE_POLLING)
 
-static void wired_peripheral_read_tick_cb(struct k_timer *timer) {
-    zmk_split_wired_poll_in(&chosen_rx_buf, uart, NULL, process_tx_cb);
-}
-
-static K_TIMER_DEFINE(wired_peripheral_read_timer, wired_peripheral_read_tick_cb, NULL);
+static struct zmk_split_wired_poll_state poll_state = {
+    .rx_buf = &chosen_rx_buf,
+    .process_data_cb = process_tx_cb,
+};
 
 #endif // IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_UART_MODE_POLLING)
 
+#if HAS_LINK_SPEED_NEGOTIATION
+
+static const uint32_t link_speeds[] = DT_INST_PROP(0, link_speeds);
+
+static int send_link_control(const struct link_envelope *env);
+
+static struct zmk_split_wired_link_speed_state link_speed = {
+    .tx_buf = &chosen_tx_buf,
+    .send = send_link_control,
+    .speeds = link_speeds,
+    .speeds_len = ARRAY_SIZE(link_speeds),
+};
+
+#endif // HAS_LINK_SPEED_NEGOTIATION
+
 static void begin_rx(void) {
 #if IS_ENABLED(CONFIG_PM_DEVICE_RUNTIME)
     pm_device_runtime_get(uart);
@@ -127,8 +146,7 @@ static void begin_rx(void) {
 #elif IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_UART_MODE_ASYNC)
     zmk_split_wired_async_rx(&async_state);
 #else
-    k_timer_start(&wired_peripheral_read_timer, K_TICKS(CONFIG_ZMK_SPLIT_WIRED_POLLING_RX_PERIOD),
-                  K_TICKS(CONFIG_ZMK_SPLIT_WIRED_POLLING_RX_PERIOD));
+    zmk_split_wired_poll_start(&poll_state);
 #endif
 }
 
@@ -140,7 +158,7 @@ static void stop_rx(void) {
 #elif IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_UART_MODE_ASYNC)
     zmk_split_wired_async_rx_cancel(&async_state);
 #else
-    k_timer_stop(&wired_peripheral_read_timer);
+    zmk_split_wired_poll_stop(&poll_state);
 #endif
 
 #if IS_ENABLED(CONFIG_PM_DEVICE_RUNTIME)
@@ -243,8 +261,16 @@ static int zmk_split_wired_peripheral_init(void) {
         LOG_ERR("Failed to set up async wired split UART (%d)", ret);
         return ret;
     }
+#elif IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_UART_MODE_POLLING)
+    poll_state.uart = uart;
+    zmk_split_wired_poll_init(&poll_state);
 #endif // IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_UART_MODE_ASYNC)
 
+#if HAS_LINK_SPEED_NEGOTIATION
+    link_speed.uart = uart;
+    zmk_split_wired_link_speed_init(&link_speed);
+#endif // HAS_LINK_SPEED_NEGOTIATION
+
 #if HAS_DETECT_GPIO
 
     gpio_pin_configure_dt(&detect_gpio, GPIO_INPUT);
@@ -284,7 +310,7 @@ static ssize_t get_payload_data_size(const struct zmk_split_transport_peripheral
     case ZMK_SPLIT_TRANSPORT_PERIPHERAL_EVENT_TYPE_INPUT_EVENT:
         return sizeof(evt->data.input_event);
     case ZMK_SPLIT_TRANSPORT_PERIPHERAL_EVENT_TYPE_KEY_POSITION_EVENT:
-        return sizeof(evt->data.key_position_event);
+        return WIRED_KEY_POSITION_EVENT_SIZE;
     case ZMK_SPLIT_TRANSPORT_PERIPHERAL_EVENT_TYPE_SENSOR_EVENT:
         return sizeof(evt->data.sensor_event);
     case ZMK_SPLIT_TRANSPORT_PERIPHERAL_EVENT_TYPE_BATTERY_EVENT:
@@ -294,6 +320,78 @@ static ssize_t get_payload_data_size(const struct zmk_split_transport_peripheral
     }
 }
 
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_MULTI_RECORD_FRAMES)
+
+#define EVENT_FRAME_PAYLOAD_MAX                                                                    \
+    MSG_MULTI_PAYLOAD_SIZE(sizeof(struct event_payload), CONFIG_ZMK_SPLIT_WIRED_EVENT_BUFFER_ITEMS)
+
+static struct k_spinlock event_frame_lock;
+
+// Events reported since the last flush, sent together with a single CRC.
+static struct multi_envelope event_frame = {
+    .prefix = {.magic_prefix = ZMK_SPLIT_WIRED_MULTI_ENVELOPE_MAGIC_PREFIX},
+};
+
+static void flush_events(void) {
+    k_spinlock_key_t key = k_spin_lock(&event_frame_lock);
+    int err = zmk_split_wired_multi_put(&event_frame, &chosen_tx_buf);
+    k_spin_unlock(&event_frame_lock, key);
+
+    if (err < 0) {
+        LOG_DBG("No room to flush events to the central yet");
+    }
+}
+
+#if !IS_HALF_DUPLEX_MODE
+
+static void flush_events_work_cb(struct k_work *work) {
+    flush_events();
+    begin_tx();
+}
+
+static K_WORK_DEFINE(flush_events_work, flush_events_work_cb);
+
+#endif // !IS_HALF_DUPLEX_MODE
+
+static int queue_event_record(const struct event_payload *payload, size_t payload_size) {
+    k_spinlock_key_t key = k_spin_lock(&event_frame_lock);
+
+    int err =
+        zmk_split_wired_multi_append(&event_frame, EVENT_FRAME_PAYLOAD_MAX, payload, payload_size);
+    if (err == -ENOSPC && zmk_split_wired_multi_put(&event_frame, &chosen_tx_buf) == 0) {
+        err = zmk_split_wired_multi_append(&event_frame, EVENT_FRAME_PAYLOAD_MAX, payload,
+                                           payload_size);
+    }
+
+    k_spin_unlock(&event_frame_lock, key);
+
+    return err;
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_MULTI_RECORD_FRAMES)
+
+#if HAS_LINK_SPEED_NEGOTIATION
+
+static int send_link_control(const struct link_envelope *env) {
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_MULTI_RECORD_FRAMES)
+    // Keep the frame from landing in the middle of an event frame being flushed.
+    k_spinlock_key_t key = k_spin_lock(&event_frame_lock);
+    int err = zmk_split_wired_link_put(env, &chosen_tx_buf);
+    k_spin_unlock(&event_frame_lock, key);
+#else
+    int err = zmk_split_wired_link_put(env, &chosen_tx_buf);
+#endif
+    if (err < 0) {
+        return err;
+    }
+
+    begin_tx();
+
+    return 0;
+}
+
+#endif // HAS_LINK_SPEED_NEGOTIATION
+
 static int
 split_peripheral_wired_report_event(const struct zmk_split_transport_peripheral_event *event) {
     ssize_t data_size = get_payload_data_size(event);
@@ -306,6 +404,21 @@ split_peripheral_wired_report_event(const struct zmk_split_transport_peripheral_
     size_t payload_size =
         data_size + sizeof(peripheral_id) + sizeof(enum zmk_split_transport_peripheral_event_type);
 
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_MULTI_RECORD_FRAMES)
+    struct event_payload payload = {.source = peripheral_id, .event = *event};
+
+    if (queue_event_record(&payload, payload_size) < 0) {
+        LOG_WRN("No room to send peripheral event to the central");
+        return -ENOSPC;
+    }
+
+#if !IS_HALF_DUPLEX_MODE
+    // Events reported back to back, e.g. from one matrix scan, are flushed as one frame.
+    k_work_submit(&flush_events_work);
+#endif
+
+    return 0;
+#else
     if (ring_buf_space_get(&chosen_tx_buf) < MSG_EXTRA_SIZE + payload_size) {
         LOG_WRN("No room to send peripheral to the central (have %d but only space for %d)",
                 MSG_EXTRA_SIZE + payload_size, ring_buf_space_get(&chosen_tx_buf));
@@ -342,6 +455,7 @@ split_peripheral_wired_report_event(const struct zmk_split_transport_peripheral_
 #endif
 
     return 0;
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_MULTI_RECORD_FRAMES)
 }
 
 static bool is_enabled;
@@ -355,9 +469,15 @@ static int split_peripheral_wired_set_enabled(bool enabled) {
 
     if (enabled) {
         begin_rx();
+#if HAS_LINK_SPEED_NEGOTIATION
+        zmk_split_wired_link_speed_start(&link_speed);
+#endif
         return 0;
 #if HAS_DETECT_GPIO
     } else {
+#if HAS_LINK_SPEED_NEGOTIATION
+        zmk_split_wired_link_speed_stop(&link_speed);
+#endif
         stop_rx();
         return 0;
 #endif
@@ -376,33 +496,41 @@ split_peripheral_wired_set_status_callback(zmk_split_transport_peripheral_status
     return 0;
 }
 
+#endif // HAS_DETECT_GPIO
+
 static struct zmk_split_transport_status split_peripheral_wired_get_status() {
-    int detected = gpio_pin_get_dt(&detect_gpio);
-    if (detected > 0) {
-        return (struct zmk_split_transport_status){
-            .available = true,
-            .enabled = true, // Track this
-            .connections = ZMK_SPLIT_TRANSPORT_CONNECTIONS_STATUS_ALL_CONNECTED,
-
-        };
-    } else {
-        return (struct zmk_split_transport_status){
-            .available = false,
-            .enabled = true, // Track this
-            .connections = ZMK_SPLIT_TRANSPORT_CONNECTIONS_STATUS_DISCONNECTED,
+    struct zmk_split_transport_status status = {
+        .available = true,
+        .enabled = true, // Track this
+        .connections = ZMK_SPLIT_TRANSPORT_CONNECTIONS_STATUS_ALL_CONNECTED,
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_UART_MODE_POLLING)
+        .rx_poll_period_us = zmk_split_wired_poll_period_us(&poll_state),
+#endif
+        .link = zmk_split_wired_get_link_stats(),
+    };
 
-        };
-    }
-}
+#if HAS_LINK_SPEED_NEGOTIATION
+    zmk_split_wired_link_speed_get_stats(&link_speed, &status.link);
+#else
+    status.link.speed = DT_PROP_OR(DT_INST_PHANDLE(0, device), current_speed, 0);
+#endif
 
+#if HAS_DETECT_GPIO
+    if (gpio_pin_get_dt(&detect_gpio) <= 0) {
+        status.available = false;
+        status.connections = ZMK_SPLIT_TRANSPORT_CONNECTIONS_STATUS_DISCONNECTED;
+    }
 #endif // HAS_DETECT_GPIO
 
+    return status;
+}
+
 static const struct zmk_split_transport_peripheral_api peripheral_api = {
     .report_event = split_peripheral_wired_report_event,
     .set_enabled = split_peripheral_wired_set_enabled,
+    .get_status = split_peripheral_wired_get_status,
 #if HAS_DETECT_GPIO
     .set_status_callback = split_peripheral_wired_set_status_callback,
-    .get_status = split_peripheral_wired_get_status,
 #endif // HAS_DETECT_GPIO
 };
 
@@ -420,23 +548,61 @@ static void notify_transport_status(void) {
 
 #endif // HAS_DETECT_GPIO
 
+static int handle_command(const struct zmk_split_transport_central_command *cmd) {
+    if (cmd->type == ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_POLL_EVENTS) {
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_MULTI_RECORD_FRAMES)
+        flush_events();
+#endif
+        begin_tx();
+        return 0;
+    }
+
+    int ret = k_msgq_put(&cmd_msg_queue, cmd, K_NO_WAIT);
+    if (ret < 0) {
+        LOG_WRN("Dropping command type %d, failed to queue it for processing (%d)", cmd->type,
+                ret);
+        return ret;
+    }
+
+    k_work_submit(&publish_commands);
+
+    return 0;
+}
+
 static void process_tx_cb(void) {
     while (ring_buf_size_get(&chosen_rx_buf) > MSG_EXTRA_SIZE) {
-        struct command_envelope env;
-        int item_err = zmk_split_wired_get_item(&chosen_rx_buf, (uint8_t *)&env,
-                                                sizeof(struct command_envelope));
+        static union {
+            struct command_envelope single;
+            struct multi_envelope multi;
+            struct link_envelope link;
+            uint8_t frame[sizeof(struct multi_envelope) + sizeof(struct msg_postfix)];
+        } env;
+        int item_err = zmk_split_wired_get_item(&chosen_rx_buf, (uint8_t *)&env, sizeof(env));
+#if HAS_LINK_SPEED_NEGOTIATION
+        zmk_split_wired_link_speed_check(&link_speed);
+#endif
         switch (item_err) {
         case 0:
-            if (env.payload.cmd.type == ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_POLL_EVENTS) {
-                begin_tx();
-            } else {
-                int ret = k_msgq_put(&cmd_msg_queue, &env.payload.cmd, K_NO_WAIT);
-                if (ret < 0) {
-                    LOG_WRN("Failed to queue command for processing (%d)", ret);
-                    return;
+            if (zmk_split_wired_is_link_envelope(&env.link.prefix)) {
+#if HAS_LINK_SPEED_NEGOTIATION
+                zmk_split_wired_link_speed_handle(&link_speed, &env.link.payload);
+#endif
+            } else if (zmk_split_wired_is_multi_envelope(&env.multi.prefix)) {
+                struct command_payload payload;
+                size_t offset = 0;
+
+                // The frame has already been taken from the RX buffer, so a record that can't be
+                // queued is dropped and the rest are still handled.
+                while (zmk_split_wired_multi_next(&env.multi, &offset, &payload,
+                                                  sizeof(payload)) == 0) {
+                    handle_command(&payload.cmd);
                 }
-
-                k_work_submit(&publish_commands);
+            } else {
+                // Zero whatever the frame didn't fill, including the local behavior device, which
+                // is never sent.
+                size_t len = MIN(env.single.prefix.payload_size, sizeof(env.single.payload));
+                memset((uint8_t *)&env.single.payload + len, 0, sizeof(env.single.payload) - len);
+                handle_command(&env.single.payload.cmd);
             }
             break;
         case -EAGAIN:
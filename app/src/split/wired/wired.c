@@ -6,6 +6,8 @@
 
 #include "wired.h"
 
+#include <string.h>
+
 #include <zephyr/sys/crc.h>
 #include <zephyr/drivers/uart.h>
 #include <zephyr/drivers/gpio.h>
@@ -13,6 +15,8 @@
 
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
+static struct zmk_split_transport_link_stats link_stats;
+
 #if IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_UART_MODE_POLLING)
 
 void zmk_split_wired_poll_out(struct ring_buf *tx_buf, const struct device *uart) {
@@ -36,13 +40,12 @@ int zmk_split_wired_poll_in(struct ring_buf *rx_buf, const struct device *uart,
     uint32_t claim_len = ring_buf_put_claim(rx_buf, &buf, ring_buf_space_get(rx_buf));
     if (claim_len < 1) {
         LOG_WRN("No room available for reading in from the serial port");
+        link_stats.rx_overflows++;
         return -ENOSPC;
     }
 
-    bool all_read = false;
     while (read < claim_len) {
         if (uart_poll_in(uart, buf + read) < 0) {
-            all_read = true;
             break;
         }
 
@@ -59,8 +62,107 @@ int zmk_split_wired_poll_in(struct ring_buf *rx_buf, const struct device *uart,
         }
     }
 
-    // TODO: Also indicate if no bytes read at all?
-    return (all_read ? 1 : 0);
+    return read;
+}
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_POLLING_ADAPTIVE)
+
+static void poll_set_period(struct zmk_split_wired_poll_state *state, uint32_t period) {
+    atomic_set(&state->period, period);
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_POLLING_RX_WAKE)
+    // Data arriving during any backed off period can overrun the UART's RX FIFO before the next
+    // poll, so the interrupt stays armed until polling is back at full speed.
+    if (state->rx_wake) {
+        if (period > CONFIG_ZMK_SPLIT_WIRED_POLLING_RX_PERIOD) {
+            uart_irq_rx_enable(state->uart);
+        } else {
+            uart_irq_rx_disable(state->uart);
+        }
+    }
+#endif
+}
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_POLLING_RX_WAKE)
+
+static void poll_rx_wake_cb(const struct device *dev, void *user_data) {
+    struct zmk_split_wired_poll_state *state = user_data;
+
+    if (!uart_irq_update(dev) || !uart_irq_rx_ready(dev)) {
+        return;
+    }
+
+    // The polling timer reads the data, just bring it back up to speed.
+    uart_irq_rx_disable(dev);
+    atomic_set(&state->period, CONFIG_ZMK_SPLIT_WIRED_POLLING_RX_PERIOD);
+    k_timer_start(&state->timer, K_NO_WAIT, K_NO_WAIT);
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_POLLING_RX_WAKE)
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_POLLING_ADAPTIVE)
+
+static void poll_timer_cb(struct k_timer *timer) {
+    struct zmk_split_wired_poll_state *state =
+        CONTAINER_OF(timer, struct zmk_split_wired_poll_state, timer);
+
+    int read = zmk_split_wired_poll_in(state->rx_buf, state->uart, state->process_data_work,
+                                       state->process_data_cb);
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_POLLING_ADAPTIVE)
+    // Poll fast right after traffic, backing off exponentially while the link is idle. A full RX
+    // buffer (-ENOSPC) is neither, so keep the current period until it has been drained.
+    uint32_t period = atomic_get(&state->period);
+
+    if (read > 0) {
+        period = CONFIG_ZMK_SPLIT_WIRED_POLLING_RX_PERIOD;
+    } else if (read == 0) {
+        period = MIN(period * 2, CONFIG_ZMK_SPLIT_WIRED_POLLING_RX_MAX_PERIOD);
+    }
+
+    poll_set_period(state, period);
+    k_timer_start(timer, K_TICKS(period), K_NO_WAIT);
+#else
+    ARG_UNUSED(read);
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_POLLING_ADAPTIVE)
+}
+
+void zmk_split_wired_poll_init(struct zmk_split_wired_poll_state *state) {
+    k_timer_init(&state->timer, poll_timer_cb, NULL);
+    atomic_set(&state->period, CONFIG_ZMK_SPLIT_WIRED_POLLING_RX_PERIOD);
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_POLLING_RX_WAKE)
+    int ret = uart_irq_callback_user_data_set(state->uart, poll_rx_wake_cb, state);
+    state->rx_wake = ret >= 0;
+    if (ret < 0) {
+        LOG_WRN("UART can't wake up RX polling (%d), relying on the backoff alone", ret);
+    }
+#endif
+}
+
+void zmk_split_wired_poll_start(struct zmk_split_wired_poll_state *state) {
+    atomic_set(&state->period, CONFIG_ZMK_SPLIT_WIRED_POLLING_RX_PERIOD);
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_POLLING_ADAPTIVE)
+    k_timer_start(&state->timer, K_TICKS(CONFIG_ZMK_SPLIT_WIRED_POLLING_RX_PERIOD), K_NO_WAIT);
+#else
+    k_timer_start(&state->timer, K_TICKS(CONFIG_ZMK_SPLIT_WIRED_POLLING_RX_PERIOD),
+                  K_TICKS(CONFIG_ZMK_SPLIT_WIRED_POLLING_RX_PERIOD));
+#endif
+}
+
+void zmk_split_wired_poll_stop(struct zmk_split_wired_poll_state *state) {
+    k_timer_stop(&state->timer);
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_POLLING_RX_WAKE)
+    if (state->rx_wake) {
+        uart_irq_rx_disable(state->uart);
+    }
+#endif
+}
+
+uint32_t zmk_split_wired_poll_period_us(struct zmk_split_wired_poll_state *state) {
+    return k_ticks_to_us_floor32(atomic_get(&state->period));
 }
 
 #endif // IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_UART_MODE_POLLING)
@@ -84,6 +186,7 @@ void zmk_split_wired_fifo_read(const struct device *dev, struct ring_buf *buf,
                     "CONFIG_ZMK_STUDIO_RPC_RX_BUF_SIZE.");
             uint8_t dummy;
             last_read = uart_fifo_read(dev, &dummy, 1);
+            link_stats.rx_overflows++;
         }
     } while (last_read && last_read == len);
 
@@ -199,6 +302,7 @@ static void async_uart_cb(const struct device *dev, struct uart_event *ev, void
             ring_buf_put(state->rx_buf, &ev->data.rx.buf[ev->data.rx.offset], ev->data.rx.len);
         if (received < ev->data.rx.len) {
             LOG_ERR("RX overrun!");
+            link_stats.rx_overflows++;
             break;
         }
 
@@ -270,6 +374,189 @@ int zmk_split_wired_async_init(struct zmk_split_wired_async_state *state) {
 
 #endif
 
+bool zmk_split_wired_is_multi_envelope(const struct msg_prefix *prefix) {
+    return memcmp(prefix->magic_prefix, ZMK_SPLIT_WIRED_MULTI_ENVELOPE_MAGIC_PREFIX,
+                  sizeof(prefix->magic_prefix)) == 0;
+}
+
+int zmk_split_wired_multi_append(struct multi_envelope *env, size_t max_payload,
+                                 const void *record, size_t len) {
+    size_t size = env->prefix.payload_size;
+
+    if (size + sizeof(struct msg_record_prefix) + len > MIN(max_payload, MSG_MULTI_PAYLOAD_MAX)) {
+        return -ENOSPC;
+    }
+
+    env->payload[size] = len;
+    memcpy(&env->payload[size + sizeof(struct msg_record_prefix)], record, len);
+    env->prefix.payload_size = size + sizeof(struct msg_record_prefix) + len;
+
+    return 0;
+}
+
+int zmk_split_wired_multi_put(struct multi_envelope *env, struct ring_buf *tx_buf) {
+    size_t len = sizeof(env->prefix) + env->prefix.payload_size;
+
+    if (env->prefix.payload_size == 0) {
+        return 0;
+    }
+
+    if (ring_buf_space_get(tx_buf) < len + sizeof(struct msg_postfix)) {
+        return -ENOSPC;
+    }
+
+    struct msg_postfix postfix = {.crc = crc32_ieee((const uint8_t *)env, len)};
+
+    ring_buf_put(tx_buf, (const uint8_t *)env, len);
+    ring_buf_put(tx_buf, (const uint8_t *)&postfix, sizeof(postfix));
+
+    env->prefix.payload_size = 0;
+
+    return 0;
+}
+
+int zmk_split_wired_multi_next(const struct multi_envelope *env, size_t *offset, void *record,
+                               size_t record_size) {
+    size_t size = env->prefix.payload_size;
+
+    if (*offset >= size) {
+        return -ENODATA;
+    }
+
+    size_t len = env->payload[*offset];
+    size_t start = *offset + sizeof(struct msg_record_prefix);
+
+    if (len == 0 || start + len > size) {
+        return -EINVAL;
+    }
+
+    memset(record, 0, record_size);
+    memcpy(record, &env->payload[start], MIN(len, record_size));
+    *offset = start + len;
+
+    return 0;
+}
+
+bool zmk_split_wired_is_link_envelope(const struct msg_prefix *prefix) {
+    return memcmp(prefix->magic_prefix, ZMK_SPLIT_WIRED_LINK_ENVELOPE_MAGIC_PREFIX,
+                  sizeof(prefix->magic_prefix)) == 0;
+}
+
+int zmk_split_wired_link_put(const struct link_envelope *env, struct ring_buf *tx_buf) {
+    size_t len = sizeof(env->prefix) + env->prefix.payload_size;
+
+    if (ring_buf_space_get(tx_buf) < len + sizeof(struct msg_postfix)) {
+        return -ENOSPC;
+    }
+
+    struct msg_postfix postfix = {.crc = crc32_ieee((const uint8_t *)env, len)};
+
+    ring_buf_put(tx_buf, (const uint8_t *)env, len);
+    ring_buf_put(tx_buf, (const uint8_t *)&postfix, sizeof(postfix));
+
+    return 0;
+}
+
+static bool is_known_envelope(const struct msg_prefix *prefix) {
+    return memcmp(prefix->magic_prefix, ZMK_SPLIT_WIRED_ENVELOPE_MAGIC_PREFIX,
+                  sizeof(prefix->magic_prefix)) == 0 ||
+           zmk_split_wired_is_multi_envelope(prefix) || zmk_split_wired_is_link_envelope(prefix);
+}
+
+#define WORD_ONES ((uintptr_t)-1 / UINT8_MAX)
+#define WORD_HIGHS (WORD_ONES * 0x80)
+
+// Scan a word at a time for the first magic byte, so resyncing after line noise doesn't cost a
+// loop iteration per discarded byte.
+static const uint8_t *find_magic_start(const uint8_t *data, size_t len) {
+    // Shared by the single, multi-record and link envelope magics
+    const uint8_t target = ZMK_SPLIT_WIRED_ENVELOPE_MAGIC_PREFIX[0];
+    const uintptr_t pattern = WORD_ONES * target;
+    const uint8_t *end = data + len;
+
+    while (data < end && (uintptr_t)data % sizeof(uintptr_t) != 0) {
+        if (*data == target) {
+            return data;
+        }
+        data++;
+    }
+
+    for (; end - data >= sizeof(uintptr_t); data += sizeof(uintptr_t)) {
+        uintptr_t word = *(const uintptr_t *)data ^ pattern;
+
+        // Non-zero if any byte of the word matched the target
+        if ((word - WORD_ONES) & ~word & WORD_HIGHS) {
+            break;
+        }
+    }
+
+    for (; data < end; data++) {
+        if (*data == target) {
+            return data;
+        }
+    }
+
+    return NULL;
+}
+
+// Drop the byte at the head of the buffer, which did not start a valid frame, and everything up
+// to the next candidate frame start.
+static void resync(struct ring_buf *rx_buf) {
+    uint32_t discarded = ring_buf_get(rx_buf, NULL, 1);
+    uint8_t *data;
+    uint32_t len;
+
+    // A claim stops at the end of the buffer memory, so a wrapped buffer takes two passes.
+    while ((len = ring_buf_get_claim(rx_buf, &data, ring_buf_size_get(rx_buf))) > 0) {
+        const uint8_t *found = find_magic_start(data, len);
+        uint32_t skip = found ? found - data : len;
+
+        ring_buf_get_finish(rx_buf, skip);
+        discarded += skip;
+
+        if (found) {
+            break;
+        }
+    }
+
+    link_stats.rx_resyncs++;
+    link_stats.rx_discarded_bytes += discarded;
+
+    LOG_DBG("Resynced RX stream, discarded %d bytes", discarded);
+}
+
+struct zmk_split_transport_link_stats zmk_split_wired_get_link_stats(void) {
+    return link_stats;
+}
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_LINK_SPEED_NEGOTIATION)
+
+bool zmk_split_wired_is_error_burst(void) {
+    static int64_t window_start;
+    static uint32_t window_errors;
+
+    uint32_t errors = link_stats.rx_bad_frames + link_stats.rx_resyncs;
+    int64_t now = k_uptime_get();
+
+    if (now - window_start > CONFIG_ZMK_SPLIT_WIRED_LINK_SPEED_ERROR_WINDOW_MS) {
+        window_start = now;
+        window_errors = errors;
+        return false;
+    }
+
+    if (errors - window_errors < CONFIG_ZMK_SPLIT_WIRED_LINK_SPEED_ERROR_BURST) {
+        return false;
+    }
+
+    // Start a fresh window, so one burst only triggers one fallback.
+    window_start = now;
+    window_errors = errors;
+
+    return true;
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_LINK_SPEED_NEGOTIATION)
+
 int zmk_split_wired_get_item(struct ring_buf *rx_buf, uint8_t *env, size_t env_size) {
     while (ring_buf_size_get(rx_buf) > sizeof(struct msg_prefix) + sizeof(struct msg_postfix)) {
         struct msg_prefix prefix;
@@ -279,49 +566,48 @@ int zmk_split_wired_get_item(struct ring_buf *rx_buf, uint8_t *env, size_t env_s
             uint32_t peek_read = ring_buf_peek(rx_buf, (uint8_t *)&prefix, sizeof(prefix)),
             peek_read == sizeof(prefix), "Somehow read less than we expect from the RX buffer");
 
-        if (memcmp(&prefix.magic_prefix, &ZMK_SPLIT_WIRED_ENVELOPE_MAGIC_PREFIX,
-                   sizeof(prefix.magic_prefix)) != 0) {
-            uint8_t discarded_byte;
-            ring_buf_get(rx_buf, &discarded_byte, 1);
-
-            LOG_WRN("Prefix mismatch, discarding byte %0x", discarded_byte);
-
+        if (!is_known_envelope(&prefix)) {
+            resync(rx_buf);
             continue;
         }
 
         size_t payload_to_read = sizeof(prefix) + prefix.payload_size;
+        size_t frame_size = payload_to_read + sizeof(struct msg_postfix);
 
-        if (payload_to_read > env_size) {
+        if (frame_size > MIN(env_size, ring_buf_capacity_get(rx_buf))) {
+            // Most likely a corrupted size, or magic bytes showing up inside another frame.
             LOG_WRN("Invalid message with payload %d bigger than expected max %d", payload_to_read,
-                    env_size);
-            return -EINVAL;
+                    env_size - sizeof(struct msg_postfix));
+            link_stats.rx_bad_frames++;
+            resync(rx_buf);
+            continue;
         }
 
-        if (ring_buf_size_get(rx_buf) < payload_to_read + sizeof(struct msg_postfix)) {
+        if (ring_buf_size_get(rx_buf) < frame_size) {
             return -EAGAIN;
         }
 
-        // Now that prefix matches, read it out so we can read the rest of the payload.
-        __ASSERT_EVAL((void)ring_buf_get(rx_buf, env, payload_to_read),
-                      uint32_t read = ring_buf_get(rx_buf, env, payload_to_read),
-                      read == payload_to_read,
+        // Only consume the frame once it checks out, a bad frame may hide the start of the next.
+        __ASSERT_EVAL((void)ring_buf_peek(rx_buf, env, frame_size),
+                      uint32_t read = ring_buf_peek(rx_buf, env, frame_size), read == frame_size,
                       "Somehow read less than we expect from the RX buffer");
 
         struct msg_postfix postfix;
-        __ASSERT_EVAL((void)ring_buf_get(rx_buf, (uint8_t *)&postfix, sizeof(postfix)),
-                      uint32_t read = ring_buf_get(rx_buf, (uint8_t *)&postfix, sizeof(postfix)),
-                      read == sizeof(postfix),
-                      "Somehow read less of the postfix than we expect from the RX buffer");
+        memcpy(&postfix, env + payload_to_read, sizeof(postfix));
 
         uint32_t crc = crc32_ieee(env, payload_to_read);
         if (crc != postfix.crc) {
-            LOG_WRN("Data corruption in received peripheral event, ignoring %d vs %d", crc,
-                    postfix.crc);
-            return -EINVAL;
+            LOG_WRN("Data corruption in received frame, ignoring %d vs %d", crc, postfix.crc);
+            link_stats.rx_bad_frames++;
+            resync(rx_buf);
+            continue;
         }
 
+        ring_buf_get(rx_buf, NULL, frame_size);
+        link_stats.rx_frames++;
+
         return 0;
     }
 
     return -EAGAIN;
-}
\ No newline at end of file
+}
@@ -12,6 +12,7 @@
 #include <zmk/split/transport/types.h>
 
 #define ZMK_SPLIT_WIRED_ENVELOPE_MAGIC_PREFIX "ZmKw"
+#define ZMK_SPLIT_WIRED_MULTI_ENVELOPE_MAGIC_PREFIX "ZmKm"
 
 struct msg_prefix {
     uint8_t magic_prefix[sizeof(ZMK_SPLIT_WIRED_ENVELOPE_MAGIC_PREFIX) - 1];
@@ -44,16 +45,119 @@ struct msg_postfix {
 
 #define MSG_EXTRA_SIZE (sizeof(struct msg_prefix) + sizeof(struct msg_postfix))
 
+// Key position events are sent without their timestamp, in the layout used before timestamps
+// were added, so halves running older firmware still parse them. The central sees a zero
+// timestamp and uses the arrival time instead.
+#define WIRED_KEY_POSITION_EVENT_SIZE                                                              \
+    (offsetof(struct zmk_split_transport_peripheral_event, data.key_position_event.timestamp) -    \
+     offsetof(struct zmk_split_transport_peripheral_event, data))
+
+// Multi-record frames use the same prefix and CRC postfix as single envelopes, but the payload
+// holds several records, each a length byte followed by a command or event payload.
+struct msg_record_prefix {
+    uint8_t len;
+} __packed;
+
+#define MSG_MULTI_PAYLOAD_MAX UINT8_MAX
+
+struct multi_envelope {
+    struct msg_prefix prefix;
+    uint8_t payload[MSG_MULTI_PAYLOAD_MAX];
+} __packed;
+
+// Receivers size their RX buffers for `items` single envelopes, a multi-record frame holding
+// the same number of records is always smaller.
+#define MSG_MULTI_PAYLOAD_SIZE(record_size, items)                                                 \
+    (MIN((items), MSG_MULTI_PAYLOAD_MAX / (sizeof(struct msg_record_prefix) + (record_size))) *    \
+     (sizeof(struct msg_record_prefix) + (record_size)))
+
+bool zmk_split_wired_is_multi_envelope(const struct msg_prefix *prefix);
+
+/**
+ * Append a record to a multi-record frame.
+ * @return 0 on success, or -ENOSPC if the payload would grow past max_payload.
+ */
+int zmk_split_wired_multi_append(struct multi_envelope *env, size_t max_payload,
+                                 const void *record, size_t len);
+
+/**
+ * Write a multi-record frame and its CRC to the TX buffer, then reset it for new records. An
+ * empty frame writes nothing.
+ * @return 0 on success, or -ENOSPC if there was no room in the buffer.
+ */
+int zmk_split_wired_multi_put(struct multi_envelope *env, struct ring_buf *tx_buf);
+
+/**
+ * Copy the next record of a received multi-record frame into `record`, zero filling any bytes
+ * past the record's length.
+ * @return 0 on success, -ENODATA at the end of the frame, or -EINVAL if it's malformed.
+ */
+int zmk_split_wired_multi_next(const struct multi_envelope *env, size_t *offset, void *record,
+                               size_t record_size);
+
+// Link control frames carry the speed handshake, and are ignored by halves that don't negotiate.
+#define ZMK_SPLIT_WIRED_LINK_ENVELOPE_MAGIC_PREFIX "ZmKl"
+
+enum zmk_split_wired_link_op {
+    ZMK_SPLIT_WIRED_LINK_OP_PROPOSE = 1,
+    ZMK_SPLIT_WIRED_LINK_OP_ACCEPT,
+    ZMK_SPLIT_WIRED_LINK_OP_REJECT,
+    ZMK_SPLIT_WIRED_LINK_OP_TEST,
+    ZMK_SPLIT_WIRED_LINK_OP_CONFIRM,
+};
+
+#define ZMK_SPLIT_WIRED_LINK_TEST_PATTERN_LEN 16
+
+struct link_payload {
+    uint8_t op;
+    uint32_t speed;
+    uint8_t pattern[ZMK_SPLIT_WIRED_LINK_TEST_PATTERN_LEN];
+} __packed;
+
+struct link_envelope {
+    struct msg_prefix prefix;
+    struct link_payload payload;
+} __packed;
+
+bool zmk_split_wired_is_link_envelope(const struct msg_prefix *prefix);
+
+/**
+ * Write a link control frame and its CRC to the TX buffer.
+ * @return 0 on success, or -ENOSPC if there was no room in the buffer.
+ */
+int zmk_split_wired_link_put(const struct link_envelope *env, struct ring_buf *tx_buf);
+
 typedef void (*zmk_split_wired_process_tx_callback_t)(void);
 
 #if IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_UART_MODE_POLLING)
 
 void zmk_split_wired_poll_out(struct ring_buf *tx_buf, const struct device *uart);
 
+/**
+ * Read any pending bytes from the UART into the RX buffer.
+ * @return the number of bytes read, or -ENOSPC if the RX buffer is full.
+ */
 int zmk_split_wired_poll_in(struct ring_buf *rx_buf, const struct device *uart,
                             struct k_work *process_data_work,
                             zmk_split_wired_process_tx_callback_t process_data_cb);
 
+struct zmk_split_wired_poll_state {
+    const struct device *uart;
+    struct ring_buf *rx_buf;
+    struct k_work *process_data_work;
+    zmk_split_wired_process_tx_callback_t process_data_cb;
+
+    struct k_timer timer;
+    // Current polling period in ticks
+    atomic_t period;
+    bool rx_wake;
+};
+
+void zmk_split_wired_poll_init(struct zmk_split_wired_poll_state *state);
+void zmk_split_wired_poll_start(struct zmk_split_wired_poll_state *state);
+void zmk_split_wired_poll_stop(struct zmk_split_wired_poll_state *state);
+uint32_t zmk_split_wired_poll_period_us(struct zmk_split_wired_poll_state *state);
+
 #endif
 
 #if IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_UART_MODE_INTERRUPT)
@@ -93,4 +197,92 @@ int zmk_split_wired_async_rx_cancel(struct zmk_split_wired_async_state *state);
 
 #endif
 
-int zmk_split_wired_get_item(struct ring_buf *rx_buf, uint8_t *env, size_t env_size);
\ No newline at end of file
+/**
+ * Read the next valid frame from the RX buffer into `env`, skipping ahead to the next frame
+ * start after noise or a bad frame. `env_size` must leave room for the CRC postfix after the
+ * largest expected envelope.
+ * @return 0 on success, or -EAGAIN if no complete frame is available yet.
+ */
+int zmk_split_wired_get_item(struct ring_buf *rx_buf, uint8_t *env, size_t env_size);
+
+/**
+ * Get the RX framing counters. The speed fields are left for the caller to fill in.
+ */
+struct zmk_split_transport_link_stats zmk_split_wired_get_link_stats(void);
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_LINK_SPEED_NEGOTIATION)
+
+/**
+ * Check whether at least CONFIG_ZMK_SPLIT_WIRED_LINK_SPEED_ERROR_BURST bad frames and resyncs
+ * came in within the current error window. Safe to call from ISRs.
+ */
+bool zmk_split_wired_is_error_burst(void);
+
+enum zmk_split_wired_link_phase {
+    ZMK_SPLIT_WIRED_LINK_PHASE_IDLE,
+    // Central: waiting for an answer to a proposed speed
+    ZMK_SPLIT_WIRED_LINK_PHASE_PROPOSED,
+    // Waiting for the TX buffer to drain before changing speed
+    ZMK_SPLIT_WIRED_LINK_PHASE_SWITCHING,
+    // Running at the proposed speed until the test pattern makes it through
+    ZMK_SPLIT_WIRED_LINK_PHASE_TESTING,
+    // Central: no faster speed left to try
+    ZMK_SPLIT_WIRED_LINK_PHASE_DONE,
+};
+
+struct zmk_split_wired_link_speed_state {
+    const struct device *uart;
+    struct ring_buf *tx_buf;
+    // Writes a link control frame to the TX buffer and starts sending it
+    int (*send)(const struct link_envelope *env);
+    // Ascending, from the link-speeds devicetree property
+    const uint32_t *speeds;
+    size_t speeds_len;
+    // The central drives the handshake, the peripheral answers
+    bool initiator;
+
+    uint32_t base_speed;
+    uint32_t speed;
+    int8_t speed_idx;
+    int8_t try_idx;
+    // Speeds at or above this index failed at some point and are not tried again
+    int8_t cap_idx;
+    uint8_t attempts;
+    uint16_t fallbacks;
+    enum zmk_split_wired_link_phase phase;
+    // Uptime after which the UART may switch to the speed being tried
+    int64_t switch_at;
+
+    struct k_spinlock lock;
+    struct link_payload rx_payload;
+    bool rx_pending;
+
+    struct k_work rx_work;
+    struct k_work fallback_work;
+    struct k_work_delayable step_work;
+};
+
+int zmk_split_wired_link_speed_init(struct zmk_split_wired_link_speed_state *state);
+
+/**
+ * Start from the base speed. On the central this kicks off the handshake.
+ */
+void zmk_split_wired_link_speed_start(struct zmk_split_wired_link_speed_state *state);
+void zmk_split_wired_link_speed_stop(struct zmk_split_wired_link_speed_state *state);
+
+/**
+ * Handle a received link control frame. Safe to call from ISRs.
+ */
+void zmk_split_wired_link_speed_handle(struct zmk_split_wired_link_speed_state *state,
+                                       const struct link_payload *payload);
+
+/**
+ * Fall back to the base speed if a burst of errors came in at a negotiated speed. Call after
+ * processing received data, safe to call from ISRs.
+ */
+void zmk_split_wired_link_speed_check(struct zmk_split_wired_link_speed_state *state);
+
+void zmk_split_wired_link_speed_get_stats(struct zmk_split_wired_link_speed_state *state,
+                                          struct zmk_split_transport_link_stats *stats);
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_LINK_SPEED_NEGOTIATION)
\ No newline at end of file
@@ -4,6 +4,8 @@
  * SPDX-License-Identifier: MIT
  */
 
+#include <stdlib.h>
+
 #include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
 
@@ -23,20 +25,65 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
 #include <zmk/split/central.h>
 
-static int wpm_state_changed_listener(const zmk_event_t *eh) {
-    uint8_t wpm = zmk_wpm_get_state();
-    
-    LOG_INF("Central WPM changed: %d - Broadcasting to peripherals", wpm);
-    
-    // Gửi WPM tới tất cả peripherals qua split transport
+// Peripherals only use WPM for display, so updates are rate limited and small changes are
+// dropped. Only the latest value is ever pending; drops to zero are always sent so idle shows
+// up.
+static uint8_t last_sent_wpm;
+static uint8_t pending_wpm;
+static int64_t last_sent_at;
+static bool has_sent;
+
+static void send_wpm_work_cb(struct k_work *work) {
+    uint8_t wpm = pending_wpm;
+
+    if (has_sent && wpm == last_sent_wpm) {
+        return;
+    }
+
     int err = zmk_split_central_send_wpm(wpm);
     if (err < 0) {
-        LOG_ERR("Failed to send WPM to peripherals: %d", err);
+        LOG_DBG("Failed to send WPM to peripherals: %d", err);
+        return;
     }
-    
+
+    last_sent_wpm = wpm;
+    last_sent_at = k_uptime_get();
+    has_sent = true;
+}
+
+static K_WORK_DELAYABLE_DEFINE(send_wpm_work, send_wpm_work_cb);
+
+static int wpm_state_changed_listener(const zmk_event_t *eh) {
+    uint8_t wpm = zmk_wpm_get_state();
+
+    pending_wpm = wpm;
+
+    if (has_sent && wpm != 0 &&
+        abs((int)wpm - (int)last_sent_wpm) < CONFIG_ZMK_SPLIT_CENTRAL_WPM_DEADBAND) {
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    int64_t due = last_sent_at + CONFIG_ZMK_SPLIT_CENTRAL_WPM_MIN_INTERVAL_MS;
+
+    // An update already scheduled picks up the new pending value when it runs.
+    k_work_schedule(&send_wpm_work,
+                    has_sent ? K_TIMEOUT_ABS_MS(MAX(due, k_uptime_get())) : K_NO_WAIT);
+
     return ZMK_EV_EVENT_BUBBLE;
 }
 
+// A reconnected peripheral has no WPM, or a stale one, until the value next moves past the
+// deadband, so it is sent the current value regardless.
+static void resend_wpm_work_cb(struct k_work *work) {
+    pending_wpm = zmk_wpm_get_state();
+    has_sent = false;
+    k_work_reschedule(&send_wpm_work, K_NO_WAIT);
+}
+
+static K_WORK_DEFINE(resend_wpm_work, resend_wpm_work_cb);
+
+void zmk_split_central_resend_wpm(void) { k_work_submit(&resend_wpm_work); }
+
 ZMK_LISTENER(wpm_split_central, wpm_state_changed_listener);
 ZMK_SUBSCRIPTION(wpm_split_central, zmk_wpm_state_changed);
 
@@ -186,8 +186,16 @@ static const struct hid_ops ops = {
 
 static int zmk_usb_hid_send_report(const uint8_t *report, size_t len) {
     switch (zmk_usb_get_status()) {
-    case USB_DC_SUSPEND:
-        return usb_wakeup_request();
+    case USB_DC_SUSPEND: {
+        int err = usb_wakeup_request();
+#if IS_ENABLED(CONFIG_ZMK_ENDPOINTS_REPORT_SNAPSHOTS)
+        // The report is lost either way, so don't let it be recorded in the endpoint's snapshot.
+        if (!err) {
+            err = -EAGAIN;
+        }
+#endif
+        return err;
+    }
     case USB_DC_ERROR:
     case USB_DC_RESET:
     case USB_DC_DISCONNECTED:
@@ -222,6 +230,29 @@ int zmk_usb_hid_send_consumer_report(void) {
     return zmk_usb_hid_send_report((uint8_t *)report, sizeof(*report));
 }
 
+int zmk_usb_hid_send_release_all(void) {
+    static struct zmk_hid_keyboard_report keyboard_release = {
+        .report_id = ZMK_HID_REPORT_ID_KEYBOARD,
+    };
+    static struct zmk_hid_consumer_report consumer_release = {
+        .report_id = ZMK_HID_REPORT_ID_CONSUMER,
+    };
+
+#if IS_ENABLED(CONFIG_ZMK_USB_BOOT)
+    if (hid_protocol == HID_PROTOCOL_BOOT) {
+        static zmk_hid_boot_report_t boot_release;
+        return zmk_usb_hid_send_report((uint8_t *)&boot_release, sizeof(boot_release));
+    }
+#endif /* IS_ENABLED(CONFIG_ZMK_USB_BOOT) */
+
+    int err = zmk_usb_hid_send_report((uint8_t *)&keyboard_release, sizeof(keyboard_release));
+    if (err) {
+        return err;
+    }
+
+    return zmk_usb_hid_send_report((uint8_t *)&consumer_release, sizeof(consumer_release));
+}
+
 #if IS_ENABLED(CONFIG_ZMK_POINTING)
 int zmk_usb_hid_send_mouse_report() {
 #if IS_ENABLED(CONFIG_ZMK_USB_BOOT)